@@ -0,0 +1,38 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+// Generates the autonomous trajectories ahead of time and saves them to the
+// deploy directory, so the robot only has to map them at startup.
+//
+// Usage: GenerateTrajectories [deploy directory]
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include <frc/ctrlsys/DriveTrajectory.h>
+
+#include "AutonomousPaths.hpp"
+
+int main(int argc, char* argv[]) {
+    std::string directory = argc > 1 ? argv[1] : "src/main/deploy";
+    std::filesystem::create_directories(directory + "/trajectories");
+
+    for (const auto& path : GetAutonomousPaths()) {
+        auto filename = GetTrajectoryPath(directory, path.name);
+        auto trajectory = frc::DriveTrajectory::Generate(
+            path.waypoints, kAutonomousConstraints);
+
+        if (!trajectory.Save(filename, frc::DriveTrajectory::Hash(
+                                           path.waypoints,
+                                           kAutonomousConstraints))) {
+            std::cerr << "Failed to write " << filename << std::endl;
+            return 1;
+        }
+
+        std::cout << filename << ": " << trajectory.GetStates().size()
+                  << " states, " << trajectory.TotalTime() << " s"
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -3,112 +3,106 @@
 #include "AutonomousChooser.hpp"
 
 #include <algorithm>
+#include <utility>
 
+#include <frc/DriverStation.h>
 #include <frc/smartdashboard/SmartDashboard.h>
+#include <frc2/Timer.h>
 
 namespace frc3512 {
 
 AutonomousChooser::AutonomousChooser(wpi::StringRef name,
                                      std::function<void()> func) {
     m_defaultChoice = name;
-    m_choices[name] = func;
-    m_names.emplace_back(name);
-
-    m_selectedChoice = name;
-    m_selectedAuton = &m_choices[name];
+    AddAutonomous(name, func);
 
     frc::SmartDashboard::PutData("Autonomous modes", this);
-
-    m_selectedListenerHandle = m_selectedEntry.AddListener(
-        [=](const nt::EntryNotification& event) {
-            if (!event.value->IsString()) {
-                return;
-            }
-
-            {
-                std::scoped_lock lock{m_mutex};
-                m_selectedChoice = event.value->GetString();
-            }
-
-            m_activeEntry.SetString(m_selectedChoice);
-        },
-        NT_NOTIFY_IMMEDIATE | NT_NOTIFY_NEW | NT_NOTIFY_UPDATE |
-            NT_NOTIFY_LOCAL);
 }
 
 AutonomousChooser::~AutonomousChooser() {
     EndAutonomous();
-    m_selectedEntry.RemoveListener(m_selectedListenerHandle);
+    if (m_published) {
+        m_selectedEntry.RemoveListener(m_selectedListenerHandle);
+    }
 }
 
 void AutonomousChooser::AddAutonomous(wpi::StringRef name,
                                       std::function<void()> func) {
-    m_choices[name] = func;
-    m_names.emplace_back(name);
+    AddAutonomous(name, func, nullptr);
+}
 
-    // Unlike std::map, wpi::StringMap elements are not sorted
-    std::sort(m_names.begin(), m_names.end());
+void AutonomousChooser::AddAutonomous(wpi::StringRef name,
+                                      std::function<void()> func,
+                                      std::function<void()> prefetch) {
+    if (m_published) {
+        frc::DriverStation::ReportError(
+            "AutonomousChooser: autonomous mode \"" + name.str() +
+            "\" added after the modes were published");
+        return;
+    }
 
-    m_optionsEntry.SetStringArray(m_names);
+    // Insert in sorted order, replacing a mode with the same name
+    auto it = std::lower_bound(m_names.begin(), m_names.end(), name);
+    size_t index = it - m_names.begin();
+    if (it != m_names.end() && *it == name) {
+        m_choices[index] = Choice{std::move(func), std::move(prefetch)};
+    } else {
+        m_names.emplace(it, name.str());
+        m_choices.emplace(m_choices.begin() + index,
+                          Choice{std::move(func), std::move(prefetch)});
+    }
 }
 
 void AutonomousChooser::SelectAutonomous(wpi::StringRef name) {
-    {
-        std::scoped_lock lock{m_mutex};
-        m_selectedChoice = name;
-    }
+    Publish();
     m_selectedEntry.SetString(name);
+
+    size_t index = Find(name);
+    if (index < m_names.size()) {
+        m_selected = index;
+    }
 }
 
 const std::vector<std::string>& AutonomousChooser::GetAutonomousNames() const {
     return m_names;
 }
 
-void AutonomousChooser::YieldToMain() {
-    m_awaitingAuton = false;
-    m_cond.notify_one();
-    m_cond.wait(m_autonLock, [&] { return m_awaitingAuton; });
-}
+void AutonomousChooser::YieldToMain() { m_autonFiber.Suspend(); }
+
+void AutonomousChooser::PrefetchSelected() {
+    Publish();
 
-void AutonomousChooser::Return() {
-    m_awaitingAuton = false;
-    m_cond.notify_one();
+    auto& prefetch = m_choices[m_selected].prefetch;
+    if (prefetch) {
+        prefetch();
+    }
 }
 
 void AutonomousChooser::AwaitStartAutonomous() {
-    {
-        std::scoped_lock lock{m_mutex};
-        m_selectedAuton = &m_choices[m_selectedChoice];
-    }
+    auto start = frc2::Timer::GetFPGATimestamp();
+
+    Publish();
 
-    m_awaitingAuton = true;
-    m_autonThread = std::thread{[=] {
-        m_autonLock.lock();
-        m_autonRunning = true;
-        (*m_selectedAuton)();
-        m_autonRunning = false;
-        Return();
-        m_autonLock.unlock();
-    }};
-    m_cond.wait(m_mainLock, [&] { return !m_awaitingAuton; });
+    // Finish a mode still running so its stack can be reused
+    EndAutonomous();
+
+    m_autonFiber.Start(m_choices[m_selected].func);
+    m_autonFiber.Resume();
+
+    units::second_t latency = frc2::Timer::GetFPGATimestamp() - start;
+    m_startLatency = latency.to<double>();
+    m_startLatencyEntry.SetDouble(latency.to<double>() * 1000.0);
 }
 
-void AutonomousChooser::AwaitRunAutonomous() {
-    if (m_autonRunning) {
-        m_awaitingAuton = true;
-        m_cond.notify_one();
-        m_cond.wait(m_mainLock, [&] { return !m_awaitingAuton; });
-    }
+units::second_t AutonomousChooser::GetStartLatency() const {
+    return units::second_t{m_startLatency};
 }
 
+void AutonomousChooser::AwaitRunAutonomous() { m_autonFiber.Resume(); }
+
 void AutonomousChooser::EndAutonomous() {
-    if (m_autonRunning) {
-        m_awaitingAuton = true;
-        m_cond.notify_one();
-        m_cond.wait(m_mainLock, [&] { return !m_awaitingAuton; });
-    }
-    if (m_autonThread.joinable()) {
-        m_autonThread.join();
+    while (m_autonFiber.IsRunning()) {
+        m_autonFiber.Resume();
     }
 }
 
@@ -118,13 +112,59 @@ void AutonomousChooser::InitSendable(frc::SendableBuilder& builder) {
     builder.GetEntry("default").SetString(m_defaultChoice);
 
     m_optionsEntry = builder.GetEntry("options");
-    m_optionsEntry.SetStringArray(m_names);
 
     m_selectedEntry = builder.GetEntry("selected");
     m_selectedEntry.SetString(m_defaultChoice);
 
     m_activeEntry = builder.GetEntry("active");
     m_activeEntry.SetString(m_defaultChoice);
+
+    m_startLatencyEntry = builder.GetEntry("startLatency");
+    m_startLatencyEntry.SetDouble(0.0);
+}
+
+/**
+ * Publishes the modes to the dashboard and starts listening for selections,
+ * if that hasn't been done yet.
+ */
+void AutonomousChooser::Publish() {
+    if (m_published) {
+        return;
+    }
+    m_published = true;
+
+    m_selected = Find(m_defaultChoice);
+    m_optionsEntry.SetStringArray(m_names);
+
+    // The modes are immutable from here on, so the listener can read them
+    // without locking. It's notified immediately of a selection made before
+    // now.
+    m_selectedListenerHandle = m_selectedEntry.AddListener(
+        [=](const nt::EntryNotification& event) {
+            if (!event.value->IsString()) {
+                return;
+            }
+
+            size_t index = Find(event.value->GetString());
+            if (index < m_names.size()) {
+                m_selected = index;
+                m_activeEntry.SetString(m_names[index]);
+            }
+        },
+        NT_NOTIFY_IMMEDIATE | NT_NOTIFY_NEW | NT_NOTIFY_UPDATE |
+            NT_NOTIFY_LOCAL);
+}
+
+/**
+ * Returns the index of the mode with the given name, or the number of modes
+ * if there isn't one.
+ */
+size_t AutonomousChooser::Find(wpi::StringRef name) const {
+    auto it = std::lower_bound(m_names.begin(), m_names.end(), name);
+    if (it != m_names.end() && *it == name) {
+        return it - m_names.begin();
+    }
+    return m_names.size();
 }
 
 }  // namespace frc3512
@@ -0,0 +1,45 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "AutonomousPaths.hpp"
+
+#include <cmath>
+
+#include <wpi/math>
+
+/**
+ * Returns the paths followed by the autonomous modes.
+ *
+ * The robot code and the offline trajectory generator both use these, so a
+ * saved trajectory is regenerated at startup if its path changed since it was
+ * saved.
+ */
+std::vector<AutonomousPath> GetAutonomousPaths() {
+    // The side gear pegs are reached by driving forward, turning 60 degrees
+    // toward the airship, and driving forward again. The trajectories blend
+    // that into one curve ending at the same pose.
+    constexpr double kFirstLeg = 104.0 - kRobotLength / 2.0 - 2.5;
+    constexpr double kSecondLeg = 47.0 - kRobotLength / 2.0 + 18.0;
+    constexpr double kPegAngle = wpi::math::pi / 3.0;
+
+    return {
+        // The left peg is to the right, so the robot turns clockwise
+        {"LeftGear",
+         {frc::Pose{0.0, 0.0, 0.0},
+          frc::Pose{kFirstLeg + kSecondLeg * std::cos(kPegAngle),
+                    -kSecondLeg * std::sin(kPegAngle), -kPegAngle}}},
+        {"RightGear",
+         {frc::Pose{0.0, 0.0, 0.0},
+          frc::Pose{kFirstLeg + kSecondLeg * std::cos(kPegAngle),
+                    kSecondLeg * std::sin(kPegAngle), kPegAngle}}}};
+}
+
+/**
+ * Returns the path of a saved trajectory.
+ *
+ * @param directory deploy directory
+ * @param name      name of the autonomous path
+ */
+std::string GetTrajectoryPath(const std::string& directory,
+                              const std::string& name) {
+    return directory + "/trajectories/" + name + ".traj";
+}
@@ -2,26 +2,76 @@
 
 #include "CANEncoder.hpp"
 
+#include <cmath>
+
 #include <ctre/phoenix/motorcontrol/FeedbackDevice.h>
+#include <ctre/phoenix/motorcontrol/StatusFrame.h>
+#include <frc2/Timer.h>
 
 CANEncoder::CANEncoder(ctre::phoenix::motorcontrol::can::TalonSRX& motor,
-                       double distancePerPulse, bool reverseDirection)
-    : m_motor{motor}, m_distancePerPulse{distancePerPulse} {
+                       double distancePerPulse, bool reverseDirection,
+                       units::second_t framePeriod)
+    : m_motor{motor},
+      m_distancePerPulse{distancePerPulse},
+      m_framePeriod{framePeriod} {
     motor.ConfigSelectedFeedbackSensor(
         ctre::phoenix::motorcontrol::FeedbackDevice::QuadEncoder, 0, 0);
     motor.SetSensorPhase(reverseDirection);
+
+    // Send the quadrature position and velocity once per control loop period
+    // instead of the default 160 ms
+    motor.SetStatusFramePeriod(
+        ctre::phoenix::motorcontrol::StatusFrameEnhanced::Status_3_Quadrature,
+        static_cast<int>(std::round(framePeriod.to<double>() * 1000.0)), 0);
 }
 
-double CANEncoder::GetDistance() {
-    return m_motor.GetSensorCollection().GetQuadraturePosition() *
-           m_distancePerPulse;
+double CANEncoder::GetDistance() { return GetSample().distance; }
+
+double CANEncoder::GetRate() { return GetSample().rate; }
+
+/**
+ * Returns the current sample, reading a new one from the Talon if the cached
+ * one is from an earlier control cycle or older than the status frame period.
+ */
+CANEncoder::Sample CANEncoder::GetSample() {
+    auto sample = m_sample.Load();
+
+    auto tickTimestamp = frc::INode::GetTickTimestamp();
+    auto now = frc2::Timer::GetFPGATimestamp();
+    if (tickTimestamp.to<double>() != 0.0) {
+        if (sample.tickTimestamp == tickTimestamp) {
+            return sample;
+        }
+    } else if (now - sample.timestamp < m_framePeriod) {
+        return sample;
+    }
+
+    auto& sensors = m_motor.GetSensorCollection();
+    sample = Sample{sensors.GetQuadraturePosition() * m_distancePerPulse,
+                    sensors.GetQuadratureVelocity() * m_distancePerPulse, now,
+                    tickTimestamp};
+    m_sample.Store(sample);
+
+    return sample;
 }
 
-double CANEncoder::GetRate() {
-    return m_motor.GetSensorCollection().GetQuadratureVelocity() *
-           m_distancePerPulse;
+/**
+ * Returns the time since the cached sample was read.
+ */
+units::second_t CANEncoder::GetAge() const {
+    return frc2::Timer::GetFPGATimestamp() - m_sample.Load().timestamp;
 }
 
+/**
+ * Returns true if the cached sample is older than two status frame periods,
+ * which means no consumer has read the encoder recently.
+ */
+bool CANEncoder::IsStale() const { return GetAge() > 2.0 * m_framePeriod; }
+
 void CANEncoder::Reset() {
     m_motor.GetSensorCollection().SetQuadraturePosition(0);
+
+    // Force the next read to fetch a new sample
+    m_sample.Store(Sample{0.0, 0.0, units::second_t{0.0},
+                          units::second_t{0.0}});
 }
@@ -1,7 +1,9 @@
-// Copyright (c) 2017-2020 FRC Team 3512. All Rights Reserved.
+// Copyright (c) 2017-2021 FRC Team 3512. All Rights Reserved.
 
 #include "DiffDriveController.hpp"
 
+#include <frc/ctrlsys/ControlScheduler.h>
+
 using namespace frc;
 
 /**
@@ -21,8 +23,41 @@ DiffDriveController::DiffDriveController(
     INode& positionRef, INode& angleRef, INode& leftEncoder,
     INode& rightEncoder, INode& angleSensor, bool clockwise,
     PIDOutput& leftMotor, PIDOutput& rightMotor, units::second_t period)
+    : DiffDriveController(positionRef, m_zeroRef, m_zeroRef, angleRef,
+                          m_zeroRef, m_zeroRef, leftEncoder, rightEncoder,
+                          angleSensor, clockwise, leftMotor, rightMotor,
+                          period) {}
+
+/**
+ * Constructs DiffDriveController with feedforward from velocity and
+ * acceleration references.
+ *
+ * @param positionRef position reference input
+ * @param velocityRef velocity reference input
+ * @param accelerationRef acceleration reference input
+ * @param angleRef angle reference input
+ * @param angularVelocityRef angular velocity reference input
+ * @param angularAccelerationRef angular acceleration reference input
+ * @param leftEncoder left encoder
+ * @param rightEncoder right encoder
+ * @param angleSensor angle sensor (e.g, gyroscope)
+ * @param clockwise true if clockwise rotation increases angle measurement
+ * @param leftMotor left motor output
+ * @param rightMotor right motor output
+ * @param period the loop time for doing calculations.
+ */
+DiffDriveController::DiffDriveController(
+    INode& positionRef, INode& velocityRef, INode& accelerationRef,
+    INode& angleRef, INode& angularVelocityRef, INode& angularAccelerationRef,
+    INode& leftEncoder, INode& rightEncoder, INode& angleSensor,
+    bool clockwise, PIDOutput& leftMotor, PIDOutput& rightMotor,
+    units::second_t period)
     : m_positionRef(positionRef),
+      m_velocityRef(velocityRef),
+      m_accelerationRef(accelerationRef),
       m_angleRef(angleRef),
+      m_angularVelocityRef(angularVelocityRef),
+      m_angularAccelerationRef(angularAccelerationRef),
       m_leftEncoder(leftEncoder),
       m_rightEncoder(rightEncoder),
       m_angleSensor(angleSensor),
@@ -30,11 +65,16 @@ DiffDriveController::DiffDriveController(
       m_leftMotor(leftMotor),
       m_rightMotor(rightMotor),
       m_leftMotorInput(m_positionPID, true, m_anglePID, m_clockwise),
-      m_leftOutput(m_leftMotorInput, m_leftMotor),
+      m_leftOutput("DiffDriveController left", m_leftMotorInput, m_leftMotor),
       m_rightMotorInput(m_positionPID, true, m_anglePID, !m_clockwise),
-      m_rightOutput(m_rightMotorInput, m_rightMotor),
-      m_outputs(m_leftOutput, m_rightOutput),
-      m_period(period) {}
+      m_rightOutput("DiffDriveController right", m_rightMotorInput,
+                    m_rightMotor),
+      m_period(period) {
+    // The PID nodes are constructed with the default period, so measure the
+    // actual one instead
+    m_positionPID.UseMeasuredPeriod();
+    m_anglePID.UseMeasuredPeriod();
+}
 
 void DiffDriveController::Enable() { m_outputs.Enable(m_period); }
 
@@ -44,7 +84,23 @@ PIDNode& DiffDriveController::GetPositionPID() { return m_positionPID; }
 
 PIDNode& DiffDriveController::GetAnglePID() { return m_anglePID; }
 
-double DiffDriveController::GetPosition() { return m_positionCalc.GetOutput(); }
+FeedforwardNode& DiffDriveController::GetPositionFeedforward() {
+    return m_positionFeedforward;
+}
+
+FeedforwardNode& DiffDriveController::GetAngleFeedforward() {
+    return m_angleFeedforward;
+}
+
+/**
+ * Returns the average of the encoders.
+ *
+ * The encoders are read directly instead of through the position nodes, whose
+ * state belongs to the control thread.
+ */
+double DiffDriveController::GetPosition() {
+    return (m_leftEncoder.GetOutput() + m_rightEncoder.GetOutput()) / 2.0;
+}
 
 double DiffDriveController::GetAngle() { return m_angleSensor.GetOutput(); }
 
@@ -63,3 +119,85 @@ bool DiffDriveController::AtPosition() const {
 }
 
 bool DiffDriveController::AtAngle() const { return m_angleError.InTolerance(); }
+
+/**
+ * Sets the log each control cycle is recorded to, or nullptr to stop
+ * recording.
+ *
+ * The log must outlive recording to it. Its fields must be
+ * GetTelemetryFields().
+ *
+ * @param log the log to record to
+ */
+void DiffDriveController::SetTelemetryLog(TelemetryLog* log) {
+    m_telemetryLog = log;
+}
+
+/**
+ * Returns the names of the values recorded each control cycle, in the order
+ * Record() logs them.
+ */
+std::vector<std::string> DiffDriveController::GetTelemetryFields() {
+    return {"positionRef",   "velocityRef",   "accelerationRef",
+            "positionError", "positionP",     "positionI",
+            "positionD",     "positionFF",    "positionOutput",
+            "angleRef",      "angularVelRef", "angularAccelRef",
+            "angleError",    "angleP",        "angleI",
+            "angleD",        "angleFF",       "angleOutput",
+            "leftOutput",    "rightOutput",   "leftEncoder",
+            "rightEncoder",  "angle"};
+}
+
+void DiffDriveController::Record() {
+    auto log = m_telemetryLog.load();
+    if (log == nullptr) {
+        return;
+    }
+
+    // Each node was already computed this cycle, so these are cached reads
+    log->Log(INode::GetTickTimestamp().to<double>(),
+             {m_positionRef.Evaluate(),
+              m_velocityRef.Evaluate(),
+              m_accelerationRef.Evaluate(),
+              m_positionError.Evaluate(),
+              m_positionPID.GetProportionalNode().Evaluate(),
+              m_positionPID.GetIntegralNode().Evaluate(),
+              m_positionPID.GetDerivativeNode().Evaluate(),
+              m_positionFeedforward.Evaluate(),
+              m_positionPID.Evaluate(),
+              m_angleRef.Evaluate(),
+              m_angularVelocityRef.Evaluate(),
+              m_angularAccelerationRef.Evaluate(),
+              m_angleError.Evaluate(),
+              m_anglePID.GetProportionalNode().Evaluate(),
+              m_anglePID.GetIntegralNode().Evaluate(),
+              m_anglePID.GetDerivativeNode().Evaluate(),
+              m_angleFeedforward.Evaluate(),
+              m_anglePID.Evaluate(),
+              m_leftMotorInput.Evaluate(),
+              m_rightMotorInput.Evaluate(),
+              m_leftEncoder.Evaluate(),
+              m_rightEncoder.Evaluate(),
+              m_angleSensor.Evaluate()});
+}
+
+DiffDriveController::RecordingOutputGroup::RecordingOutputGroup(
+    DiffDriveController& controller)
+    : OutputGroup("DiffDriveController", controller.m_leftOutput,
+                  controller.m_rightOutput),
+      m_controller(controller) {}
+
+DiffDriveController::RecordingOutputGroup::~RecordingOutputGroup() {
+    // Stop the task before this part of the object is gone instead of in
+    // ~OutputGroup()
+    ControlScheduler::GetInstance().Unschedule(this);
+}
+
+void DiffDriveController::RecordingOutputGroup::OutputFunc() {
+    // Joining this cycle keeps the outputs' cached node values alive for
+    // Record()
+    INode::Tick tick;
+
+    OutputGroup::OutputFunc();
+    m_controller.Record();
+}
@@ -0,0 +1,187 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+// macOS only declares the deprecated ucontext functions with _XOPEN_SOURCE
+// defined, which hides its other extensions unless _DARWIN_C_SOURCE is also
+// defined. Both must come before any system header.
+#ifdef __APPLE__
+#define _XOPEN_SOURCE 600
+#define _DARWIN_C_SOURCE
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+#endif
+
+#include "Fiber.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#else
+#error "Fiber isn't implemented for this platform"
+#endif
+
+#include <cstdlib>
+#include <utility>
+
+namespace frc3512 {
+
+#ifndef _WIN32
+struct Fiber::Contexts {
+    ucontext_t fiber;
+    ucontext_t caller;
+};
+#endif
+
+namespace {
+
+#ifndef _WIN32
+// The fiber being entered for the first time, since makecontext() can only
+// portably pass int arguments
+thread_local Fiber* tEntering = nullptr;
+#endif
+
+}  // namespace
+
+/**
+ * Constructs a Fiber and allocates its stack.
+ *
+ * @param stackSize stack size in bytes
+ */
+Fiber::Fiber(size_t stackSize) {
+#ifdef _WIN32
+    m_fiber = CreateFiber(stackSize, &Fiber::Entry, this);
+    if (m_fiber == nullptr) {
+        std::abort();
+    }
+#else
+    // Round up to whole pages, plus one below the stack for the guard page
+    size_t pageSize = sysconf(_SC_PAGESIZE);
+    stackSize = (stackSize + pageSize - 1) / pageSize * pageSize;
+    m_mappingSize = stackSize + pageSize;
+
+    // Populate the stack up front so the first run doesn't page fault
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    m_stack = mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, flags, -1,
+                   0);
+    if (m_stack == MAP_FAILED || mprotect(m_stack, pageSize, PROT_NONE) != 0) {
+        std::abort();
+    }
+#ifndef MAP_POPULATE
+    // Touch each page instead where mmap() can't populate them
+    for (size_t i = pageSize; i < m_mappingSize; i += pageSize) {
+        static_cast<volatile char*>(m_stack)[i] = 0;
+    }
+#endif
+
+    m_contexts = std::make_unique<Contexts>();
+    auto& context = m_contexts->fiber;
+    getcontext(&context);
+    context.uc_stack.ss_sp = static_cast<char*>(m_stack) + pageSize;
+    context.uc_stack.ss_size = stackSize;
+    context.uc_link = nullptr;
+    makecontext(&context, &Fiber::Entry, 0);
+#endif
+}
+
+/**
+ * Frees the stack.
+ *
+ * A function still running is abandoned without destroying its locals, so
+ * resume it until it returns first.
+ */
+Fiber::~Fiber() {
+#ifdef _WIN32
+    DeleteFiber(m_fiber);
+#else
+    munmap(m_stack, m_mappingSize);
+#endif
+}
+
+/**
+ * Sets the function to run on the next Resume().
+ *
+ * The previous function must have returned.
+ *
+ * @param func the function
+ */
+void Fiber::Start(std::function<void()> func) {
+    m_func = std::move(func);
+    m_exception = nullptr;
+    m_running = true;
+}
+
+/**
+ * Runs the function until it suspends or returns.
+ *
+ * Does nothing if the function has returned. If it threw an exception, the
+ * exception is rethrown here.
+ */
+void Fiber::Resume() {
+    if (!m_running) {
+        return;
+    }
+
+#ifdef _WIN32
+    if (!IsThreadAFiber()) {
+        ConvertThreadToFiber(nullptr);
+    }
+    m_caller = GetCurrentFiber();
+    SwitchToFiber(m_fiber);
+#else
+    tEntering = this;
+    swapcontext(&m_contexts->caller, &m_contexts->fiber);
+#endif
+
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+/**
+ * Switches back to the thread's caller of Resume().
+ *
+ * This function should only be called by the running function.
+ */
+void Fiber::Suspend() {
+#ifdef _WIN32
+    SwitchToFiber(m_caller);
+#else
+    swapcontext(&m_contexts->fiber, &m_contexts->caller);
+#endif
+}
+
+/**
+ * Returns true if a function was started and hasn't returned yet.
+ */
+bool Fiber::IsRunning() const { return m_running; }
+
+#ifdef _WIN32
+void __stdcall Fiber::Entry(void* param) { static_cast<Fiber*>(param)->Run(); }
+#else
+void Fiber::Entry() { tEntering->Run(); }
+#endif
+
+/**
+ * Runs each started function in turn on the fiber's stack, switching back to
+ * the caller of Resume() after each returns.
+ */
+void Fiber::Run() {
+    while (true) {
+        try {
+            m_func();
+        } catch (...) {
+            m_exception = std::current_exception();
+        }
+
+        // Destroy the function's captures before the caller can start another
+        m_func = nullptr;
+        m_running = false;
+        Suspend();
+    }
+}
+
+}  // namespace frc3512
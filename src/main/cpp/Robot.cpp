@@ -2,12 +2,30 @@
 
 #include "Robot.hpp"
 
+#include <utility>
+
+#include <frc/Filesystem.h>
+
+#include "AutonomousPaths.hpp"
+
 Robot::Robot() {
-    m_autonChooser.AddAutonomous("LeftGear", [=] { AutoLeftGear(); });
+    m_autonChooser.AddAutonomous(
+        "LeftGear", [=] { AutoLeftGear(); },
+        [=] { m_trajectories.Prefetch("LeftGear"); });
     m_autonChooser.AddAutonomous("CenterGear", [=] { AutoCenterGear(); });
-    m_autonChooser.AddAutonomous("RightGear", [=] { AutoRightGear(); });
+    m_autonChooser.AddAutonomous(
+        "RightGear", [=] { AutoRightGear(); },
+        [=] { m_trajectories.Prefetch("RightGear"); });
     m_autonChooser.AddAutonomous("BaseLine", [=] { AutoBaseLine(); });
 
+    // Load the trajectories saved by the generateTrajectories task
+    for (auto& path : GetAutonomousPaths()) {
+        m_trajectories.Load(
+            path.name,
+            GetTrajectoryPath(frc::filesystem::GetDeployDirectory(), path.name),
+            std::move(path.waypoints), kAutonomousConstraints);
+    }
+
     server.SetSource(camera1);
 
     camera1.SetResolution(160, 120);
@@ -41,6 +59,8 @@ void Robot::TestInit() {
 void Robot::RobotPeriodic() { DS_PrintOut(); }
 
 void Robot::DisabledPeriodic() {
+    m_autonChooser.PrefetchSelected();
+
     if (grabberStick.GetRawButtonPressed(12)) {
         robotDrive.CalibrateGyro();
     }
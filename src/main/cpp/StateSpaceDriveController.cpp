@@ -0,0 +1,170 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "StateSpaceDriveController.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <frc/ctrlsys/LQR.h>
+#include <wpi/math>
+
+using namespace frc;
+
+/**
+ * Constructs StateSpaceDriveController and computes its gains.
+ *
+ * @param positionRef      position reference input
+ * @param angleRef         angle reference input in degrees
+ * @param leftEncoder      left encoder
+ * @param rightEncoder     right encoder
+ * @param leftRate         left encoder rate in distance units per second
+ * @param rightRate        right encoder rate in distance units per second
+ * @param angleSensor      angle sensor (e.g, gyroscope) in degrees
+ * @param clockwise        true if clockwise rotation increases angle
+ *                         measurement
+ * @param leftMotor        left motor output
+ * @param rightMotor       right motor output
+ * @param characterization the drive base's characterization
+ * @param trackWidth       distance between the wheels in distance units
+ * @param tolerances       largest acceptable errors and voltage
+ * @param period           the loop time for doing calculations.
+ */
+StateSpaceDriveController::StateSpaceDriveController(
+    INode& positionRef, INode& angleRef, INode& leftEncoder,
+    INode& rightEncoder, INode& leftRate, INode& rightRate, INode& angleSensor,
+    bool clockwise, PIDOutput& leftMotor, PIDOutput& rightMotor,
+    const Characterization& characterization, double trackWidth,
+    const Tolerances& tolerances, units::second_t period)
+    : m_positionRef(positionRef),
+      m_angleRef(angleRef),
+      m_leftEncoder(leftEncoder),
+      m_rightEncoder(rightEncoder),
+      m_leftRate(leftRate),
+      m_rightRate(rightRate),
+      m_angleSensor(angleSensor),
+      m_clockwise(clockwise),
+      m_trackWidth(trackWidth),
+      m_dt(period.to<double>()),
+      m_leftOutput("StateSpaceDriveController left", m_leftVoltage,
+                   leftMotor),
+      m_rightOutput("StateSpaceDriveController right", m_rightVoltage,
+                    rightMotor),
+      m_outputs("StateSpaceDriveController", m_leftOutput, m_rightOutput),
+      m_period(period) {
+    // Each side's acceleration depends on both sides' velocities and voltages
+    // through the linear and angular characterizations
+    const auto& c = characterization;
+    double a1 = 0.5 * (-c.kVLinear / c.kALinear - c.kVAngular / c.kAAngular);
+    double a2 = 0.5 * (-c.kVLinear / c.kALinear + c.kVAngular / c.kAAngular);
+    double b1 = 0.5 * (1.0 / c.kALinear + 1.0 / c.kAAngular);
+    double b2 = 0.5 * (1.0 / c.kALinear - 1.0 / c.kAAngular);
+
+    Matrix<4, 4> contA{{{{0.0, 1.0, 0.0, 0.0},
+                         {0.0, a1, 0.0, a2},
+                         {0.0, 0.0, 0.0, 1.0},
+                         {0.0, a2, 0.0, a1}}}};
+    Matrix<4, 2> contB{{{{0.0, 0.0}, {b1, b2}, {0.0, 0.0}, {b2, b1}}}};
+
+    Matrix<4, 2> B;
+    DiscretizeAB(contA, contB, m_dt, &m_A, &B);
+
+    auto Q = MakeCostMatrix<4>({tolerances.position, tolerances.velocity,
+                                tolerances.position, tolerances.velocity});
+    auto R = MakeCostMatrix<2>({tolerances.voltage, tolerances.voltage});
+    m_K = LQR(m_A, B, Q, R);
+    m_Kff = PlantInversion(B);
+}
+
+void StateSpaceDriveController::Enable() {
+    m_reset = true;
+    m_outputs.Enable(m_period);
+}
+
+void StateSpaceDriveController::Disable() { m_outputs.Disable(); }
+
+/**
+ * Sets the largest voltage applied to either side.
+ *
+ * @param maxVoltage the largest voltage
+ */
+void StateSpaceDriveController::SetMaxVoltage(double maxVoltage) {
+    m_maxVoltage = maxVoltage;
+}
+
+/**
+ * Returns the average of the encoders.
+ *
+ * The encoders are read directly instead of through the position nodes, whose
+ * state belongs to the control thread.
+ */
+double StateSpaceDriveController::GetPosition() {
+    return (m_leftEncoder.GetOutput() + m_rightEncoder.GetOutput()) / 2.0;
+}
+
+double StateSpaceDriveController::GetAngle() {
+    return m_angleSensor.GetOutput();
+}
+
+void StateSpaceDriveController::SetPositionTolerance(double tolerance,
+                                                     double deltaTolerance) {
+    m_positionError.SetTolerance(tolerance, deltaTolerance);
+}
+
+void StateSpaceDriveController::SetAngleTolerance(double tolerance,
+                                                  double deltaTolerance) {
+    m_angleError.SetTolerance(tolerance, deltaTolerance);
+}
+
+bool StateSpaceDriveController::AtPosition() const {
+    return m_positionError.InTolerance();
+}
+
+bool StateSpaceDriveController::AtAngle() const {
+    return m_angleError.InTolerance();
+}
+
+void StateSpaceDriveController::Update() {
+    double positionRef = m_positionRef.Evaluate();
+    double angleRef = m_angleRef.Evaluate();
+    if (m_reset.exchange(false)) {
+        m_lastPositionRef = positionRef;
+        m_lastAngleRef = angleRef;
+        m_lastR = Vector<4>{};
+    }
+
+    // Converts a change in position and angle to each side's change in
+    // position. Turning clockwise moves the left side forward.
+    double turnSign = m_clockwise ? 1.0 : -1.0;
+    auto toSides = [&](double position, double angle) {
+        double turn = turnSign * angle * wpi::math::pi / 180.0 * m_trackWidth /
+                      2.0;
+        return std::make_pair(position + turn, position - turn);
+    };
+
+    // Each side's reference velocity is its change over the period
+    auto [leftStep, rightStep] = toSides(positionRef - m_lastPositionRef,
+                                         angleRef - m_lastAngleRef);
+    m_lastPositionRef = positionRef;
+    m_lastAngleRef = angleRef;
+    Vector<4> r{{{{leftStep}, {leftStep / m_dt}, {rightStep},
+                  {rightStep / m_dt}}}};
+
+    auto [leftError, rightError] =
+        toSides(m_positionError.Evaluate(), m_angleError.Evaluate());
+    Vector<4> error{{{{leftError},
+                      {r(1, 0) - m_leftRate.Evaluate()},
+                      {rightError},
+                      {r(3, 0) - m_rightRate.Evaluate()}}}};
+
+    // The last reference's position is the origin of this step's
+    Vector<4> lastR = m_lastR;
+    lastR(0, 0) = 0.0;
+    lastR(2, 0) = 0.0;
+    m_u = m_K * error + m_Kff * (r - m_A * lastR);
+    m_lastR = r;
+
+    double maxVoltage = m_maxVoltage;
+    for (int i = 0; i < 2; ++i) {
+        m_u(i, 0) = std::clamp(m_u(i, 0), -maxVoltage, maxVoltage);
+    }
+}
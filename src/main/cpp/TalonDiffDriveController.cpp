@@ -0,0 +1,259 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "TalonDiffDriveController.hpp"
+
+#include <cmath>
+
+#include <ctre/phoenix/motorcontrol/DemandType.h>
+#include <ctre/phoenix/motorcontrol/FeedbackDevice.h>
+#include <ctre/phoenix/motorcontrol/FollowerType.h>
+#include <ctre/phoenix/motorcontrol/RemoteSensorSource.h>
+#include <ctre/phoenix/motorcontrol/SensorTerm.h>
+#include <ctre/phoenix/motorcontrol/StatusFrame.h>
+#include <frc/ctrlsys/ControlScheduler.h>
+#include <wpi/math>
+
+using namespace ctre::phoenix::motorcontrol;
+
+/**
+ * Constructs TalonDiffDriveController and configures the Talons' sensors.
+ *
+ * The left leader's selected sensor must already be its encoder (see
+ * CANEncoder).
+ *
+ * @param positionRef      position reference input
+ * @param angleRef         angle reference input in degrees
+ * @param leftLeader       left leader Talon with the left encoder
+ * @param rightLeader      right leader Talon with the right encoder
+ * @param distancePerPulse distance per encoder pulse
+ * @param trackWidth       distance between the wheels in distance units
+ * @param clockwise        true if clockwise rotation increases angle
+ * @param period           the period at which to stream references
+ */
+TalonDiffDriveController::TalonDiffDriveController(
+    frc::INode& positionRef, frc::INode& angleRef, TalonSRX& leftLeader,
+    TalonSRX& rightLeader, double distancePerPulse, double trackWidth,
+    bool clockwise, units::second_t period)
+    : m_positionRef(positionRef),
+      m_angleRef(angleRef),
+      m_leftLeader(leftLeader),
+      m_rightLeader(rightLeader),
+      m_distancePerPulse(distancePerPulse),
+      m_degreesPerPulse(distancePerPulse / trackWidth * 180.0 / wpi::math::pi),
+      m_period(period) {
+    // Read the left encoder through the right leader
+    m_rightLeader.ConfigRemoteFeedbackFilter(
+        m_leftLeader.GetDeviceID(),
+        RemoteSensorSource::RemoteSensorSource_TalonSRX_SelectedSensor, 0,
+        kTimeoutMs);
+
+    // Primary loop: average distance
+    m_rightLeader.ConfigSensorTerm(SensorTerm::SensorTerm_Sum0,
+                                   FeedbackDevice::RemoteSensor0, kTimeoutMs);
+    m_rightLeader.ConfigSensorTerm(SensorTerm::SensorTerm_Sum1,
+                                   FeedbackDevice::QuadEncoder, kTimeoutMs);
+    m_rightLeader.ConfigSelectedFeedbackSensor(FeedbackDevice::SensorSum,
+                                               kPrimaryPID, kTimeoutMs);
+    m_rightLeader.ConfigSelectedFeedbackCoefficient(0.5, kPrimaryPID,
+                                                    kTimeoutMs);
+
+    // Auxiliary loop: heading. Turning clockwise moves the left side forward
+    // relative to the right.
+    if (clockwise) {
+        m_rightLeader.ConfigSensorTerm(SensorTerm::SensorTerm_Diff0,
+                                       FeedbackDevice::RemoteSensor0,
+                                       kTimeoutMs);
+        m_rightLeader.ConfigSensorTerm(SensorTerm::SensorTerm_Diff1,
+                                       FeedbackDevice::QuadEncoder, kTimeoutMs);
+    } else {
+        m_rightLeader.ConfigSensorTerm(SensorTerm::SensorTerm_Diff0,
+                                       FeedbackDevice::QuadEncoder, kTimeoutMs);
+        m_rightLeader.ConfigSensorTerm(SensorTerm::SensorTerm_Diff1,
+                                       FeedbackDevice::RemoteSensor0,
+                                       kTimeoutMs);
+    }
+    m_rightLeader.ConfigSelectedFeedbackSensor(FeedbackDevice::SensorDifference,
+                                               kAuxPID, kTimeoutMs);
+    m_rightLeader.ConfigSelectedFeedbackCoefficient(1.0, kAuxPID, kTimeoutMs);
+
+    // Add the auxiliary output to the side that leads when the heading
+    // increases (the left follower when clockwise) and subtract it from the
+    // other
+    m_rightLeader.ConfigAuxPIDPolarity(clockwise, kTimeoutMs);
+
+    m_rightLeader.ConfigClosedLoopPeriod(kPositionSlot, 1, kTimeoutMs);
+    m_rightLeader.ConfigClosedLoopPeriod(kAngleSlot, 1, kTimeoutMs);
+
+    // The remote sensor and closed-loop errors arrive in these frames
+    m_leftLeader.SetStatusFramePeriod(StatusFrame::Status_2_Feedback0_, 5,
+                                      kTimeoutMs);
+    m_rightLeader.SetStatusFramePeriod(StatusFrame::Status_2_Feedback0_, 5,
+                                       kTimeoutMs);
+    m_rightLeader.SetStatusFramePeriod(StatusFrame::Status_12_Feedback1_, 5,
+                                       kTimeoutMs);
+}
+
+TalonDiffDriveController::~TalonDiffDriveController() {
+    frc::ControlScheduler::GetInstance().Unschedule(this);
+}
+
+/**
+ * Starts closed loop control on the Talons and begins streaming references.
+ */
+void TalonDiffDriveController::Enable() {
+    m_rightLeader.SelectProfileSlot(kPositionSlot, kPrimaryPID);
+    m_rightLeader.SelectProfileSlot(kAngleSlot, kAuxPID);
+
+    StreamReferences();
+    m_leftLeader.Follow(m_rightLeader, FollowerType::FollowerType_AuxOutput1);
+
+    frc::ControlScheduler::GetInstance().Schedule(
+        this, [this] { StreamReferences(); }, m_period);
+}
+
+/**
+ * Stops closed loop control and stops the motors.
+ */
+void TalonDiffDriveController::Disable() {
+    frc::ControlScheduler::GetInstance().Unschedule(this);
+
+    // Setting the left leader to percent output also stops it following
+    m_rightLeader.Set(TalonSRXControlMode::PercentOutput, 0.0);
+    m_leftLeader.Set(TalonSRXControlMode::PercentOutput, 0.0);
+}
+
+/**
+ * Sets the position loop's gains in output fraction per unit of distance.
+ *
+ * @param p Proportional coefficient
+ * @param i Integral coefficient
+ * @param d Differential coefficient
+ */
+void TalonDiffDriveController::SetPositionPID(double p, double i, double d) {
+    SetPID(kPositionSlot, m_distancePerPulse, p, i, d);
+}
+
+/**
+ * Sets the angle loop's gains in output fraction per degree.
+ *
+ * @param p Proportional coefficient
+ * @param i Integral coefficient
+ * @param d Differential coefficient
+ */
+void TalonDiffDriveController::SetAnglePID(double p, double i, double d) {
+    SetPID(kAngleSlot, m_degreesPerPulse, p, i, d);
+}
+
+/**
+ * Limits the position loop's output to [-maxU, maxU].
+ *
+ * @param maxU the maximum output fraction
+ */
+void TalonDiffDriveController::SetPositionOutputRange(double maxU) {
+    m_rightLeader.ConfigClosedLoopPeakOutput(kPositionSlot, maxU, kTimeoutMs);
+}
+
+/**
+ * Limits the angle loop's output to [-maxU, maxU].
+ *
+ * @param maxU the maximum output fraction
+ */
+void TalonDiffDriveController::SetAngleOutputRange(double maxU) {
+    m_rightLeader.ConfigClosedLoopPeakOutput(kAngleSlot, maxU, kTimeoutMs);
+}
+
+/**
+ * Makes the Talon follow a trapezoid profile (Motion Magic) to each position
+ * reference instead of jumping to it.
+ *
+ * @param maxVelocity     maximum velocity in distance units per second
+ * @param maxAcceleration maximum acceleration in distance units per second^2
+ */
+void TalonDiffDriveController::SetMotionMagic(double maxVelocity,
+                                              double maxAcceleration) {
+    // Motion Magic velocities are in pulses per 100 ms
+    m_rightLeader.ConfigMotionCruiseVelocity(
+        maxVelocity / m_distancePerPulse * 0.1, kTimeoutMs);
+    m_rightLeader.ConfigMotionAcceleration(
+        maxAcceleration / m_distancePerPulse * 0.1, kTimeoutMs);
+    m_motionMagic = true;
+}
+
+/**
+ * Returns the average distance of the two sides.
+ */
+double TalonDiffDriveController::GetPosition() {
+    return m_rightLeader.GetSelectedSensorPosition(kPrimaryPID) *
+           m_distancePerPulse;
+}
+
+/**
+ * Returns the heading in degrees estimated from the encoders.
+ */
+double TalonDiffDriveController::GetAngle() {
+    return m_rightLeader.GetSelectedSensorPosition(kAuxPID) * m_degreesPerPulse;
+}
+
+void TalonDiffDriveController::SetPositionTolerance(double tolerance,
+                                                    double deltaTolerance) {
+    m_positionTolerance.SetTolerance(tolerance, deltaTolerance);
+}
+
+void TalonDiffDriveController::SetAngleTolerance(double tolerance,
+                                                 double deltaTolerance) {
+    m_angleTolerance.SetTolerance(tolerance, deltaTolerance);
+}
+
+bool TalonDiffDriveController::AtPosition() const {
+    return m_positionTolerance.InTolerance();
+}
+
+bool TalonDiffDriveController::AtAngle() const {
+    return m_angleTolerance.InTolerance();
+}
+
+/**
+ * Converts gains in output fraction per unit to Talon units and uploads them.
+ *
+ * The Talon's error is in pulses, its output is out of kTalonFullOutput, and
+ * its integral and derivative terms are per 1 ms loop instead of per second.
+ */
+void TalonDiffDriveController::SetPID(int slot, double unitsPerPulse, double p,
+                                      double i, double d) {
+    double scale = unitsPerPulse * kTalonFullOutput;
+
+    m_rightLeader.Config_kP(slot, p * scale, kTimeoutMs);
+    m_rightLeader.Config_kI(slot, i * scale * kTalonPeriod, kTimeoutMs);
+    m_rightLeader.Config_kD(slot, d * scale / kTalonPeriod, kTimeoutMs);
+}
+
+void TalonDiffDriveController::StreamReferences() {
+    double position = m_positionRef.GetOutput();
+    double angle = m_angleRef.GetOutput();
+
+    m_rightLeader.Set(
+        m_motionMagic ? TalonSRXControlMode::MotionMagic
+                      : TalonSRXControlMode::Position,
+        position / m_distancePerPulse, DemandType::DemandType_AuxPID,
+        angle / m_degreesPerPulse);
+
+    m_positionTolerance.Update(position - GetPosition());
+    m_angleTolerance.Update(angle - GetAngle());
+}
+
+void TalonDiffDriveController::ErrorTolerance::SetTolerance(
+    double tolerance, double deltaTolerance) {
+    m_tolerance.Store(Tolerance{tolerance, deltaTolerance});
+}
+
+void TalonDiffDriveController::ErrorTolerance::Update(double error) {
+    m_result.Store(Result{error, m_result.Load().current});
+}
+
+bool TalonDiffDriveController::ErrorTolerance::InTolerance() const {
+    auto result = m_result.Load();
+    auto tolerance = m_tolerance.Load();
+
+    return std::abs(result.current) < tolerance.tolerance &&
+           std::abs(result.current - result.last) < tolerance.deltaTolerance;
+}
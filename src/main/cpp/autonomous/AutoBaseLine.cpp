@@ -1,5 +1,6 @@
 // Copyright (c) 2016-2021 FRC Team 3512. All Rights Reserved.
 
+#include "AutonomousActions.hpp"
 #include "Robot.hpp"
 
 constexpr double kSafetyInches = 10.0;
@@ -18,11 +19,9 @@ void Robot::AutoBaseLine() {
     robotDrive.SetPositionReference(kRobotLength + 120.0 + kSafetyInches);
     robotDrive.SetAngleReference(0);
 
-    while (!robotDrive.PosAtReference()) {
-        m_autonChooser.YieldToMain();
-        if (!IsAutonomousEnabled()) {
-            return;
-        }
+    if (!m_autonChooser.Await(
+            frc3512::WaitUntil{[=] { return robotDrive.PosAtReference(); }})) {
+        return;
     }
 
     robotDrive.StopClosedLoop();
@@ -1,7 +1,6 @@
 // Copyright (c) 2016-2021 FRC Team 3512. All Rights Reserved.
 
-#include <frc2/Timer.h>
-
+#include "AutonomousActions.hpp"
 #include "Robot.hpp"
 
 /* Moves forwards a set distance and then stops with gear penetrated by
@@ -19,14 +18,10 @@ void Robot::AutoCenterGear() {
     robotDrive.SetPositionReference(110.0 - kRobotLength);
     robotDrive.SetAngleReference(0);
 
-    frc2::Timer timer;
-    timer.Start();
-
-    while (!robotDrive.PosAtReference() && !timer.HasPeriodPassed(8_s)) {
-        m_autonChooser.YieldToMain();
-        if (!IsAutonomousEnabled()) {
-            return;
-        }
+    if (!m_autonChooser.Await(frc3512::Timeout{
+            frc3512::WaitUntil{[=] { return robotDrive.PosAtReference(); }},
+            8_s})) {
+        return;
     }
 
     robotDrive.StopClosedLoop();
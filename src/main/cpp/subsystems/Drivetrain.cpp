@@ -6,6 +6,40 @@
 #include <iostream>
 #include <limits>
 
+#include <frc/Filesystem.h>
+#include <frc/ctrlsys/ControlScheduler.h>
+#include <frc/ctrlsys/INode.h>
+#include <frc2/Timer.h>
+#include <wpi/math>
+
+namespace {
+
+double Now() { return frc2::Timer::GetFPGATimestamp().to<double>(); }
+
+/**
+ * Returns a pose relative to one origin as a pose relative to another.
+ *
+ * @param pose      the pose
+ * @param oldOrigin the origin it's relative to
+ * @param newOrigin the origin to make it relative to instead
+ */
+frc::Pose ChangeOrigin(const frc::Pose& pose, const frc::Pose& oldOrigin,
+                       const frc::Pose& newOrigin) {
+    // Rotate the offset from the old origin into the old origin's frame, then
+    // out of the new origin's frame
+    double dx = pose.x - oldOrigin.x;
+    double dy = pose.y - oldOrigin.y;
+    double rotation = newOrigin.heading - oldOrigin.heading;
+    double cosRotation = std::cos(rotation);
+    double sinRotation = std::sin(rotation);
+
+    return frc::Pose{newOrigin.x + dx * cosRotation - dy * sinRotation,
+                     newOrigin.y + dx * sinRotation + dy * cosRotation,
+                     pose.heading + rotation};
+}
+
+}  // namespace
+
 Drivetrain::Drivetrain() {
     m_drive.SetDeadband(kJoystickDeadband);
 
@@ -20,13 +54,82 @@ Drivetrain::Drivetrain() {
     m_controller.GetPositionPID().SetPID(kPosP, kPosI, kPosD);
     m_controller.GetAnglePID().SetPID(kAngleP, kAngleI, kAngleD);
 
-    m_controller.GetPositionPID().SetOutputRange(-0.25, 0.25);
-    m_controller.GetAnglePID().SetOutputRange(-0.5, 0.5);
+    if constexpr (kDriveProfiledFeedforward) {
+        m_controller.GetPositionFeedforward().SetGains(kPosKs, kPosKv, kPosKa);
+        m_controller.GetAngleFeedforward().SetGains(kAngleKs, kAngleKv,
+                                                    kAngleKa);
+
+        // The profiles limit the speed, so the outputs only need room for the
+        // feedforward at the profiles' maximum speeds plus a correction
+        m_controller.GetPositionPID().SetOutputRange(-0.9, 0.9);
+        m_controller.GetAnglePID().SetOutputRange(-0.75, 0.75);
+    } else {
+        m_controller.GetPositionPID().SetOutputRange(-0.25, 0.25);
+        m_controller.GetAnglePID().SetOutputRange(-0.5, 0.5);
+    }
 
     m_controller.SetPositionTolerance(1.5,
                                       std::numeric_limits<double>::infinity());
     m_controller.SetAngleTolerance(1.5,
                                    std::numeric_limits<double>::infinity());
+
+    if constexpr (kDriveTelemetry) {
+        auto prefix = frc::filesystem::GetOperatingDirectory() + "/";
+        prefix += kDriveTelemetryName;
+        m_telemetry.emplace(
+            frc::TelemetryLog::NextPath(prefix, kDriveTelemetryMaxFiles),
+            frc::DiffDriveController::GetTelemetryFields(),
+            frc::TelemetryLog::kDefaultCapacity, kDriveTelemetryBandwidth);
+        m_controller.SetTelemetryLog(&*m_telemetry);
+    }
+
+    if constexpr (kDriveStateSpace) {
+        m_stateSpaceController.emplace(
+            m_posRef, m_angleRef, m_leftEncoderDistance, m_rightEncoderDistance,
+            m_leftEncoderRate, m_rightEncoderRate, m_angleSensor, true,
+            m_leftGrbx, m_rightGrbx,
+            frc::StateSpaceDriveController::Characterization{
+                kDriveKvLinear, kDriveKaLinear, kDriveKvAngular,
+                kDriveKaAngular},
+            kRobotWidth,
+            frc::StateSpaceDriveController::Tolerances{
+                kStateSpacePosTolerance, kStateSpaceVelTolerance,
+                kStateSpaceMaxVoltage});
+
+        m_stateSpaceController->SetPositionTolerance(
+            1.5, std::numeric_limits<double>::infinity());
+        m_stateSpaceController->SetAngleTolerance(
+            1.5, std::numeric_limits<double>::infinity());
+        m_stateSpaceController->SetMaxVoltage(kStateSpaceMaxVoltage);
+    }
+
+    if constexpr (kDriveOnboardClosedLoop) {
+        m_onboardController.emplace(m_posRef, m_angleRef, m_leftFront,
+                                    m_rightFront, kDriveDpP, kRobotWidth, true);
+
+        m_onboardController->SetPositionPID(kPosP, kPosI, kPosD);
+        m_onboardController->SetAnglePID(kAngleP, kAngleI, kAngleD);
+
+        m_onboardController->SetPositionOutputRange(0.25);
+        m_onboardController->SetAngleOutputRange(0.5);
+
+        m_onboardController->SetPositionTolerance(
+            1.5, std::numeric_limits<double>::infinity());
+        m_onboardController->SetAngleTolerance(
+            1.5, std::numeric_limits<double>::infinity());
+    }
+
+    m_estimator.UseMeasuredPeriod();
+
+    m_odometry.Reset(frc::Pose{0.0, 0.0, 0.0}, m_leftEncoder.GetDistance(),
+                     m_rightEncoder.GetDistance(), GetHeading());
+    frc::ControlScheduler::GetInstance().Schedule(
+        &m_odometry, [this] { OdometryTick(); }, frc::INode::kDefaultPeriod);
+}
+
+Drivetrain::~Drivetrain() {
+    frc::ControlScheduler::GetInstance().Unschedule(this);
+    frc::ControlScheduler::GetInstance().Unschedule(&m_odometry);
 }
 
 int32_t Drivetrain::GetLeftRaw() const { return m_leftGrbx.Get(); }
@@ -38,6 +141,7 @@ void Drivetrain::Drive(double throttle, double turn, bool isQuickTurn) {
 }
 
 void Drivetrain::ResetEncoders() {
+    m_sensorResetTime = Now();
     m_leftEncoder.Reset();
     m_rightEncoder.Reset();
 }
@@ -56,60 +160,193 @@ double Drivetrain::GetLeftRate() { return m_leftEncoder.GetRate(); }
 
 double Drivetrain::GetRightRate() { return m_rightEncoder.GetRate(); }
 
-double Drivetrain::GetPosition() { return m_controller.GetPosition(); }
+double Drivetrain::GetPosition() {
+    if constexpr (kDriveOnboardClosedLoop) {
+        return m_onboardController->GetPosition();
+    } else if constexpr (kDriveStateSpace) {
+        return m_stateSpaceController->GetPosition();
+    } else {
+        return m_controller.GetPosition();
+    }
+}
 
-double Drivetrain::GetAngle() { return m_controller.GetAngle(); }
+double Drivetrain::GetAngle() {
+    if constexpr (kDriveOnboardClosedLoop) {
+        return m_onboardController->GetAngle();
+    } else if constexpr (kDriveStateEstimator) {
+        // Evaluating the angle sensor here would update the estimator outside
+        // the control loop
+        return -m_estimator.GetEstimate().pose.heading * 180.0 /
+               wpi::math::pi;
+    } else if constexpr (kDriveStateSpace) {
+        return m_stateSpaceController->GetAngle();
+    } else {
+        return m_controller.GetAngle();
+    }
+}
 
 double Drivetrain::GetAngularRate() const { return m_gyro.GetRate(); }
 
-void Drivetrain::StartClosedLoop() { m_controller.Enable(); }
+void Drivetrain::StartClosedLoop() {
+    if constexpr (kDriveOnboardClosedLoop) {
+        m_onboardController->Enable();
+    } else if constexpr (kDriveStateSpace) {
+        m_stateSpaceController->Enable();
+    } else {
+        m_controller.Enable();
+    }
+}
+
+void Drivetrain::StopClosedLoop() {
+    frc::ControlScheduler::GetInstance().Unschedule(this);
 
-void Drivetrain::StopClosedLoop() { m_controller.Disable(); }
+    if constexpr (kDriveOnboardClosedLoop) {
+        m_onboardController->Disable();
+    } else if constexpr (kDriveStateSpace) {
+        m_stateSpaceController->Disable();
+    } else {
+        m_controller.Disable();
+    }
+}
 
 void Drivetrain::SetPositionReference(double position) {
     m_posRef.Set(position);
+
+    if constexpr (kDriveProfiledFeedforward) {
+        // The encoders may not have applied a recent reset yet, but they read
+        // zero once they have
+        double current = 0.0;
+        if (Now() - m_sensorResetTime >= kOdometrySensorResetTime) {
+            current = GetPosition();
+        }
+        m_posProfile.SetGoal(position, current);
+    }
 }
 
-void Drivetrain::SetAngleReference(double angle) { m_angleRef.Set(angle); }
+void Drivetrain::SetAngleReference(double angle) {
+    m_angleRef.Set(angle);
+
+    if constexpr (kDriveProfiledFeedforward) {
+        m_angleProfile.SetGoal(angle, GetAngle());
+    }
+}
 
 double Drivetrain::GetPosReference() const { return m_posRef.GetOutput(); }
 
 double Drivetrain::GetAngleReference() const { return m_angleRef.GetOutput(); }
 
-bool Drivetrain::PosAtReference() const { return m_controller.AtPosition(); }
+bool Drivetrain::PosAtReference() const {
+    if constexpr (kDriveOnboardClosedLoop) {
+        return m_onboardController->AtPosition();
+    } else if constexpr (kDriveStateSpace) {
+        return m_stateSpaceController->AtPosition();
+    } else {
+        return (!kDriveProfiledFeedforward || m_posProfile.AtGoal()) &&
+               m_controller.AtPosition();
+    }
+}
+
+bool Drivetrain::AngleAtReference() const {
+    if constexpr (kDriveOnboardClosedLoop) {
+        return m_onboardController->AtAngle();
+    } else if constexpr (kDriveStateSpace) {
+        return m_stateSpaceController->AtAngle();
+    } else {
+        return (!kDriveProfiledFeedforward || m_angleProfile.AtGoal()) &&
+               m_controller.AtAngle();
+    }
+}
+
+void Drivetrain::FollowTrajectory(const frc::DriveTrajectory& trajectory) {
+    // The position and angle loops would fight the follower
+    StopClosedLoop();
+
+    m_trajectory = &trajectory;
+    m_trajectoryDone = false;
+    m_trajectoryOrigin = m_odometry.GetPose();
+    m_trajectoryStartTime = Now();
 
-bool Drivetrain::AngleAtReference() const { return m_controller.AtAngle(); }
+    frc::ControlScheduler::GetInstance().Schedule(
+        this, [this] { FollowTrajectoryTick(); }, frc::INode::kDefaultPeriod);
+}
 
-void Drivetrain::ResetGyro() { m_gyro.Reset(); }
+bool Drivetrain::AtTrajectoryEnd() const { return m_trajectoryDone; }
+
+frc::Pose Drivetrain::GetPose() const { return m_odometry.GetPose(); }
+
+std::optional<frc::Pose> Drivetrain::GetPose(units::second_t timestamp) const {
+    return m_odometry.GetPose(timestamp.to<double>());
+}
+
+void Drivetrain::ResetGyro() {
+    m_sensorResetTime = Now();
+    m_gyro.Reset();
+    m_estimator.Reset();
+}
 
 void Drivetrain::CalibrateGyro() { m_gyro.Calibrate(); }
 
+double Drivetrain::GetHeading() {
+    // The gyro's angle increases clockwise
+    return -m_gyro.GetAngle() * wpi::math::pi / 180.0;
+}
+
+double Drivetrain::GetHeadingRate() {
+    return -m_gyro.GetRate() * wpi::math::pi / 180.0;
+}
+
+double Drivetrain::GetAngleSensor() {
+    if constexpr (kDriveStateEstimator) {
+        return -m_estimator.GetHeadingNode().Evaluate() * 180.0 /
+               wpi::math::pi;
+    } else {
+        return m_gyro.GetAngle();
+    }
+}
+
+void Drivetrain::OdometryTick() {
+    double left = m_leftEncoder.GetDistance();
+    double right = m_rightEncoder.GetDistance();
+    double heading = GetHeading();
+    double now = Now();
+
+    // The reset time is stored before resetting, so readings taken after a
+    // reset always see it
+    if (now - m_sensorResetTime < kOdometrySensorResetTime) {
+        m_odometry.ResetSensors(left, right, heading);
+    } else {
+        m_odometry.Update(left, right, heading, now);
+    }
+}
+
+void Drivetrain::FollowTrajectoryTick() {
+    double time = Now() - m_trajectoryStartTime;
+
+    // The trajectory starts where the robot was when following started
+    auto pose = ChangeOrigin(m_odometry.GetPose(), m_trajectoryOrigin,
+                             m_trajectory->Sample(0.0).pose);
+    auto [velocity, angularVelocity] =
+        m_follower.Calculate(pose, m_trajectory->Sample(time));
+
+    if (time >= m_trajectory->TotalTime()) {
+        velocity = 0.0;
+        angularVelocity = 0.0;
+        m_trajectoryDone = true;
+    }
+
+    // Convert to wheel velocities, then to outputs
+    double turn = angularVelocity * kRobotWidth / 2.0;
+    m_leftGrbx.Set((velocity - turn) / kDriveFullOutputVelocity);
+    m_rightGrbx.Set((velocity + turn) / kDriveFullOutputVelocity);
+}
+
 void Drivetrain::Debug() {
-    // Motor Out/Input
-    // std::cout << "Left MO: " << m_leftOutput.Get() << std::endl;
-    // std::cout << "Left MI: " << m_leftMotorInput.Get() << std::endl;
-    // std::cout << "Right MO: " << m_rightOutput.Get() << std::endl;
-    // std::cout << "Right MI: " << m_rightMotorInput.Get() << std::endl;
-
-    // Gyro Values
-    // std::cout << "Gyro Rate: " << m_gyro.GetRate();
-    // std::cout << " Angle: " << m_gyro.GetAngle() << std::endl;
-
-    // Velocity and Position
-    // std::cout << "Left Velocity: " << m_leftGrbx.GetSpeed() << std::endl;
-    // std::cout << "Right Velocity: " << m_rightGrbx.GetSpeed() << std::endl;
-    // std::cout << "Left Position: " << m_leftGrbx.GetPosition()
-    // << "Right: " << m_rightGrbx.GetPosition() << std::endl;
-
-    // PID
-    // std::cout << "Pos PID: " << m_posPID.Get() << std::endl;
-    // std::cout << "Velocity PID: " << m_velPID.Get() << std::endl;
-    // std::cout << "Angle PID: " << m_anglePID.Get() << std::endl;
-    // std::cout << "Angle Error: " << m_angleError.Get() << std::endl;
-    // std::cout << "Pos Error: " << m_posError.Get() << std::endl;
-    // std::cout << "Rotate: " << m_rotatePID.Get() << std::endl;
-
-    // References
-    // std::cout << "References: Position: " << m_posRef.Get()
-    // << "Angle: " << m_angleRef.Get() << std::endl;
+    // The control cycles are recorded by m_telemetry instead of printed here,
+    // which is too slow to leave enabled. Only report records it dropped
+    // because it couldn't keep up.
+    if (m_telemetry && m_telemetry->GetDroppedCount() != m_reportedDropCount) {
+        m_reportedDropCount = m_telemetry->GetDroppedCount();
+        std::cout << "Telemetry dropped " << m_reportedDropCount << " records"
+                  << std::endl;
+    }
 }
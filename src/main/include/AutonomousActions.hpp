@@ -0,0 +1,339 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <array>
+#include <tuple>
+#include <utility>
+
+#include <frc2/Timer.h>
+#include <units/time.h>
+
+/**
+ * Actions that autonomous modes compose from drive segments and mechanism
+ * moves, and run with AutonomousChooser::Await().
+ *
+ * An action has three member functions:
+ *
+ *   void Start();   Called once before the first Update()
+ *   bool Update();  Called once per robot period; returns true when finished
+ *   void Stop();    Called instead of further Update() calls if the action is
+ *                   interrupted before finishing (e.g., by Race or Timeout)
+ *
+ * Combinators hold their actions by value and dispatch to them statically, so
+ * a routine's whole action tree is one object on the autonomous mode's stack.
+ * Running it allocates nothing and spawns no threads; every action advances
+ * once per period from the autonomous mode's Fiber.
+ *
+ * When an action in a Sequence finishes, the next one starts in the same
+ * period, so chained actions don't wait a period between each other.
+ */
+namespace frc3512 {
+
+namespace detail {
+
+/**
+ * Calls func with the element of tuple at a runtime index and returns its
+ * result.
+ */
+template <typename Tuple, typename F, size_t... I>
+bool VisitAt(Tuple& tuple, size_t index, F&& func,
+             std::index_sequence<I...>) {
+    bool result = false;
+    ((I == index ? (result = func(std::get<I>(tuple)), true) : false) || ...);
+    return result;
+}
+
+/**
+ * Calls func with each element of tuple and its index.
+ */
+template <typename Tuple, typename F, size_t... I>
+void ForEachIndexed(Tuple& tuple, F&& func, std::index_sequence<I...>) {
+    (func(std::get<I>(tuple), I), ...);
+}
+
+}  // namespace detail
+
+/**
+ * An action made of callables: one that starts it, one that returns whether
+ * it's finished, and optionally one that stops it if it's interrupted.
+ */
+template <typename StartFunc, typename DoneFunc, typename StopFunc = void (*)()>
+class Action {
+public:
+    Action(StartFunc start, DoneFunc isDone, StopFunc stop = [] {})
+        : m_start(std::move(start)),
+          m_isDone(std::move(isDone)),
+          m_stop(std::move(stop)) {}
+
+    void Start() { m_start(); }
+    bool Update() { return m_isDone(); }
+    void Stop() { m_stop(); }
+
+private:
+    StartFunc m_start;
+    DoneFunc m_isDone;
+    StopFunc m_stop;
+};
+
+template <typename StartFunc, typename DoneFunc>
+Action(StartFunc, DoneFunc) -> Action<StartFunc, DoneFunc>;
+
+template <typename StartFunc, typename DoneFunc, typename StopFunc>
+Action(StartFunc, DoneFunc, StopFunc) -> Action<StartFunc, DoneFunc, StopFunc>;
+
+/**
+ * An action that runs a callable once and finishes immediately.
+ */
+template <typename F>
+class Instant {
+public:
+    explicit Instant(F func) : m_func(std::move(func)) {}
+
+    void Start() { m_func(); }
+    bool Update() { return true; }
+    void Stop() {}
+
+private:
+    F m_func;
+};
+
+template <typename F>
+Instant(F) -> Instant<F>;
+
+/**
+ * An action that finishes once a predicate returns true.
+ */
+template <typename Predicate>
+class WaitUntil {
+public:
+    explicit WaitUntil(Predicate isDone) : m_isDone(std::move(isDone)) {}
+
+    void Start() {}
+    bool Update() { return m_isDone(); }
+    void Stop() {}
+
+private:
+    Predicate m_isDone;
+};
+
+template <typename Predicate>
+WaitUntil(Predicate) -> WaitUntil<Predicate>;
+
+/**
+ * An action that finishes after a duration.
+ */
+class Wait {
+public:
+    explicit Wait(units::second_t duration) : m_duration(duration) {}
+
+    void Start() { m_endTime = frc2::Timer::GetFPGATimestamp() + m_duration; }
+    bool Update() { return frc2::Timer::GetFPGATimestamp() >= m_endTime; }
+    void Stop() {}
+
+private:
+    units::second_t m_duration;
+    units::second_t m_endTime{0.0};
+};
+
+/**
+ * An action that runs actions one after another, finishing after the last.
+ */
+template <typename... Actions>
+class Sequence {
+public:
+    static_assert(sizeof...(Actions) > 0, "Sequence needs an action");
+
+    explicit Sequence(Actions... actions) : m_actions(std::move(actions)...) {}
+
+    void Start() {
+        m_index = 0;
+        Visit([](auto& action) {
+            action.Start();
+            return true;
+        });
+    }
+
+    bool Update() {
+        while (Visit([](auto& action) { return action.Update(); })) {
+            if (++m_index == sizeof...(Actions)) {
+                return true;
+            }
+            Visit([](auto& action) {
+                action.Start();
+                return true;
+            });
+        }
+        return false;
+    }
+
+    void Stop() {
+        Visit([](auto& action) {
+            action.Stop();
+            return true;
+        });
+    }
+
+private:
+    std::tuple<Actions...> m_actions;
+
+    // Index of the running action
+    size_t m_index = 0;
+
+    template <typename F>
+    bool Visit(F&& func) {
+        return detail::VisitAt(m_actions, m_index, func,
+                               std::index_sequence_for<Actions...>{});
+    }
+};
+
+template <typename... Actions>
+Sequence(Actions...) -> Sequence<Actions...>;
+
+/**
+ * An action that runs actions at the same time, finishing after all of them
+ * have.
+ */
+template <typename... Actions>
+class Parallel {
+public:
+    explicit Parallel(Actions... actions) : m_actions(std::move(actions)...) {}
+
+    void Start() {
+        m_done.fill(false);
+        ForEach([](auto& action, bool&) { action.Start(); });
+    }
+
+    bool Update() {
+        bool allDone = true;
+        ForEach([&](auto& action, bool& done) {
+            if (!done) {
+                done = action.Update();
+            }
+            allDone = allDone && done;
+        });
+        return allDone;
+    }
+
+    void Stop() {
+        ForEach([](auto& action, bool& done) {
+            if (!done) {
+                action.Stop();
+            }
+        });
+    }
+
+private:
+    std::tuple<Actions...> m_actions;
+    std::array<bool, sizeof...(Actions)> m_done{};
+
+    template <typename F>
+    void ForEach(F&& func) {
+        detail::ForEachIndexed(
+            m_actions,
+            [&](auto& action, size_t i) { func(action, m_done[i]); },
+            std::index_sequence_for<Actions...>{});
+    }
+};
+
+template <typename... Actions>
+Parallel(Actions...) -> Parallel<Actions...>;
+
+/**
+ * An action that runs actions at the same time, finishing when the first of
+ * them does. The others are stopped.
+ */
+template <typename... Actions>
+class Race {
+public:
+    explicit Race(Actions... actions) : m_actions(std::move(actions)...) {}
+
+    void Start() {
+        m_done.fill(false);
+        ForEach([](auto& action, bool&) { action.Start(); });
+    }
+
+    bool Update() {
+        bool anyDone = false;
+        ForEach([&](auto& action, bool& done) {
+            done = action.Update();
+            anyDone = anyDone || done;
+        });
+        if (anyDone) {
+            Stop();
+        }
+        return anyDone;
+    }
+
+    void Stop() {
+        ForEach([](auto& action, bool& done) {
+            if (!done) {
+                action.Stop();
+            }
+        });
+    }
+
+private:
+    std::tuple<Actions...> m_actions;
+    std::array<bool, sizeof...(Actions)> m_done{};
+
+    template <typename F>
+    void ForEach(F&& func) {
+        detail::ForEachIndexed(
+            m_actions,
+            [&](auto& action, size_t i) { func(action, m_done[i]); },
+            std::index_sequence_for<Actions...>{});
+    }
+};
+
+template <typename... Actions>
+Race(Actions...) -> Race<Actions...>;
+
+/**
+ * An action that runs an action until it finishes or a duration passes,
+ * whichever is first.
+ */
+template <typename A>
+class Timeout {
+public:
+    Timeout(A action, units::second_t duration)
+        : m_action(std::move(action)), m_duration(duration) {}
+
+    void Start() {
+        m_endTime = frc2::Timer::GetFPGATimestamp() + m_duration;
+        m_timedOut = false;
+        m_action.Start();
+    }
+
+    bool Update() {
+        if (m_action.Update()) {
+            return true;
+        }
+        if (frc2::Timer::GetFPGATimestamp() >= m_endTime) {
+            m_action.Stop();
+            m_timedOut = true;
+            return true;
+        }
+        return false;
+    }
+
+    void Stop() { m_action.Stop(); }
+
+    /**
+     * Returns true if the action was stopped because the duration passed.
+     */
+    bool TimedOut() const { return m_timedOut; }
+
+private:
+    A m_action;
+    units::second_t m_duration;
+    units::second_t m_endTime{0.0};
+    bool m_timedOut = false;
+};
+
+template <typename A>
+Timeout(A, units::second_t) -> Timeout<A>;
+
+}  // namespace frc3512
@@ -2,25 +2,38 @@
 
 #pragma once
 
+#include <stddef.h>
+
 #include <atomic>
 #include <functional>
 #include <string>
-#include <thread>
 #include <vector>
 
+#include <frc/DriverStation.h>
 #include <frc/smartdashboard/Sendable.h>
 #include <frc/smartdashboard/SendableBuilder.h>
 #include <networktables/NetworkTableEntry.h>
-#include <wpi/StringMap.h>
+#include <units/time.h>
 #include <wpi/StringRef.h>
-#include <wpi/condition_variable.h>
-#include <wpi/mutex.h>
+
+#include "Fiber.hpp"
 
 namespace frc3512 {
 
 /**
  * A convenience wrapper around a SendableChooser for managing, selecting, and
  * running autonomous modes.
+ *
+ * The selected autonomous mode runs in a Fiber on the main robot thread. Each
+ * YieldToMain() switches back to AwaitRunAutonomous() and the mode continues
+ * from there on the next call, so the mode and the rest of the robot program
+ * never run concurrently.
+ *
+ * The modes are kept sorted by name, and the selection is an index into them.
+ * Once the main robot thread first prefetches, selects, or starts a mode, the
+ * modes are published to the dashboard and no more can be added. The
+ * dashboard's selections then only swap the index, so they never contend with
+ * the main robot thread.
  */
 class AutonomousChooser : public frc::Sendable {
 public:
@@ -40,11 +53,30 @@ public:
     /**
      * Adds an autonomous mode.
      *
+     * Modes must be added before the first call to any of SelectAutonomous(),
+     * PrefetchSelected(), or AwaitStartAutonomous().
+     *
      * @param name Name of autonomous mode.
      * @param func Autonomous mode function.
      */
     void AddAutonomous(wpi::StringRef name, std::function<void()> func);
 
+    /**
+     * Adds an autonomous mode with a function that prepares it to start.
+     *
+     * @param name     Name of autonomous mode.
+     * @param func     Autonomous mode function.
+     * @param prefetch Function that loads the autonomous mode's resources. It's
+     *                 called repeatedly while the mode is selected, so it
+     *                 should be cheap once they're loaded. Sensor resets
+     *                 belong at the start of the mode instead; they only queue
+     *                 a CAN frame and zero the gyro, and resetting every
+     *                 disabled period would hold the odometry still through
+     *                 the first kOdometrySensorResetTime of the mode.
+     */
+    void AddAutonomous(wpi::StringRef name, std::function<void()> func,
+                       std::function<void()> prefetch);
+
     /**
      * Sets the selected autonomous mode for unit testing purposes.
      *
@@ -60,62 +92,107 @@ public:
     /**
      * Yield to main robot thread and wait for next chance to run.
      *
-     * This function should only be called by the autonomous mode. A call by the
-     * main robot thread will block indefinitely.
+     * This function should only be called by the autonomous mode.
      */
     void YieldToMain();
 
     /**
-     * Return to main robot thread.
+     * Runs an action (see AutonomousActions.hpp) until it finishes, yielding
+     * to the main robot thread each period.
+     *
+     * If autonomous is disabled first, the action is stopped and this returns
+     * false, after which the autonomous mode should return.
      *
      * This function should only be called by the autonomous mode.
+     *
+     * @param action The action.
      */
-    void Return();
+    template <typename Action>
+    bool Await(Action&& action);
 
     /**
-     * Runs the selected autonomous mode function.
+     * Runs the selected autonomous mode's prefetch function, if it has one.
+     *
+     * This function should be called periodically by the main robot thread
+     * while disabled, so the autonomous mode doesn't wait on its resources when
+     * it starts.
+     */
+    void PrefetchSelected();
+
+    /**
+     * Runs the selected autonomous mode function until it first yields.
+     *
+     * The time this takes is published as "startLatency" in milliseconds.
+     * Autonomous modes command their first actuation before yielding, so it's
+     * the latency from autonomous being enabled to the first actuation.
      */
     void AwaitStartAutonomous();
 
     /**
-     * Notify autonomous mode to run.
+     * Returns how long the last AwaitStartAutonomous() call took.
+     */
+    units::second_t GetStartLatency() const;
+
+    /**
+     * Runs autonomous mode until it yields again.
      *
-     * This function should only be called by the main robot thread. It will
-     * block until the autonomous mode function waits to be run again. This
-     * ensures the main robot thread and autonomous mode won't race for
-     * resources.
+     * This function should only be called by the main robot thread.
      */
     void AwaitRunAutonomous();
 
     /**
-     * Notify autonomous mode so it can exit.
+     * Runs autonomous mode until it returns.
+     *
+     * Autonomous modes should return once autonomous is disabled.
      */
     void EndAutonomous();
 
     void InitSendable(frc::SendableBuilder& builder) override;
 
 private:
-    std::thread m_autonThread;
-    wpi::mutex m_mutex;
-    wpi::mutex m_autonMutex;
-    std::unique_lock<wpi::mutex> m_mainLock{m_autonMutex};
-    std::unique_lock<wpi::mutex> m_autonLock{m_autonMutex, std::defer_lock};
-    wpi::condition_variable m_cond;
-    bool m_awaitingAuton = false;
-    bool m_autonRunning = false;
+    struct Choice {
+        std::function<void()> func;
+        std::function<void()> prefetch;
+    };
+
+    Fiber m_autonFiber;
 
     std::string m_defaultChoice;
-    std::string m_selectedChoice;
-    wpi::StringMap<std::function<void()>> m_choices;
+
+    // Sorted by name, with m_choices[i] named m_names[i]. Immutable once
+    // published.
     std::vector<std::string> m_names;
-    std::function<void()>* m_selectedAuton;
+    std::vector<Choice> m_choices;
+    bool m_published = false;
+
+    // Index of the selected mode
+    std::atomic<size_t> m_selected{0};
+
+    std::atomic<double> m_startLatency{0.0};
 
     nt::NetworkTableEntry m_defaultEntry;
     nt::NetworkTableEntry m_optionsEntry;
     nt::NetworkTableEntry m_selectedEntry;
     nt::NetworkTableEntry m_activeEntry;
+    nt::NetworkTableEntry m_startLatencyEntry;
+
+    NT_EntryListener m_selectedListenerHandle = 0;
 
-    NT_EntryListener m_selectedListenerHandle;
+    void Publish();
+    size_t Find(wpi::StringRef name) const;
 };
 
+template <typename Action>
+bool AutonomousChooser::Await(Action&& action) {
+    action.Start();
+    while (!action.Update()) {
+        YieldToMain();
+        if (!frc::DriverStation::GetInstance().IsAutonomousEnabled()) {
+            action.Stop();
+            return false;
+        }
+    }
+    return true;
+}
+
 }  // namespace frc3512
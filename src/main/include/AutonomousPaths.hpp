@@ -0,0 +1,30 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <frc/ctrlsys/DriveTrajectory.h>
+#include <frc/ctrlsys/Pose.h>
+
+#include "Constants.hpp"
+
+/**
+ * A path followed by an autonomous mode.
+ *
+ * The trajectory generator saves each path's trajectory to
+ * trajectories/<name>.traj in the deploy directory.
+ */
+struct AutonomousPath {
+    std::string name;
+    std::vector<frc::Pose> waypoints;
+};
+
+constexpr frc::DriveTrajectory::Constraints kAutonomousConstraints{
+    kTrajectoryMaxV, kTrajectoryMaxA, kTrajectoryMaxCentripetalA, kRobotWidth};
+
+std::vector<AutonomousPath> GetAutonomousPaths();
+
+std::string GetTrajectoryPath(const std::string& directory,
+                              const std::string& name);
@@ -3,20 +3,59 @@
 #pragma once
 
 #include <ctre/phoenix/motorcontrol/can/TalonSRX.h>
-
+#include <frc/ctrlsys/INode.h>
+#include <frc/ctrlsys/SeqLock.h>
+#include <units/time.h>
+
+/**
+ * Reads a quadrature encoder connected to a Talon SRX.
+ *
+ * The Talon sends the encoder's position and velocity in a status frame, whose
+ * period is set to the control loop's period here. Readings are cached and the
+ * Talon is only queried once per control cycle (see frc::INode::Tick), or once
+ * per status frame period outside a cycle, so every consumer in a cycle sees
+ * the same sample.
+ */
 class CANEncoder {
 public:
+    /**
+     * A snapshot of the encoder.
+     */
+    struct Sample {
+        // Distance in distance units
+        double distance;
+
+        // Rate in distance units per 100 ms
+        double rate;
+
+        // FPGA time at which the sample was read
+        units::second_t timestamp;
+
+        // Start of the control cycle that read the sample, or 0 s
+        units::second_t tickTimestamp;
+    };
+
     CANEncoder(ctre::phoenix::motorcontrol::can::TalonSRX& motor,
-               double distancePerPulse = 1.0, bool reverseDirection = false);
+               double distancePerPulse = 1.0, bool reverseDirection = false,
+               units::second_t framePeriod = frc::INode::kDefaultPeriod);
 
     double GetDistance();
 
     double GetRate();
 
+    Sample GetSample();
+
+    units::second_t GetAge() const;
+    bool IsStale() const;
+
     void Reset();
 
 private:
     ctre::phoenix::motorcontrol::can::TalonSRX& m_motor;
 
     double m_distancePerPulse;
+    units::second_t m_framePeriod;
+
+    frc::SeqLock<Sample> m_sample{Sample{0.0, 0.0, units::second_t{0.0},
+                                         units::second_t{0.0}}};
 };
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <wpi/math>
+
 // Includes definition for Talons and etc that connect to the RoboRIO
 
 /* Order of subsystem constants:
@@ -45,16 +47,94 @@ constexpr double kRobotWidth = 30.0;   // inches
 constexpr double kRobotLength = 39.0;  // inches
 
 // DriveTrain position PID, Extra //'s mean practice PID values
-constexpr double kDriveMaxSpeed = 24000;  // in/sec
-constexpr double kPosP = 0.07;            // 0.07
-constexpr double kPosI = 0.00;            // 0.00
-constexpr double kPosD = 0.08;            // 0.08
+constexpr double kDriveMaxSpeed = 120.0;       // in/sec
+constexpr double kDriveTimeToMaxSpeed = 1.2;   // sec
+constexpr double kPosP = 0.07;                 // 0.07
+constexpr double kPosI = 0.00;                 // 0.00
+constexpr double kPosD = 0.08;                 // 0.08
 
 // DriveTrain angle PID
-constexpr double kRotateMaxSpeed = 320;
-constexpr double kAngleP = 0.75;  // 0.75
-constexpr double kAngleI = 0.00;  // 0.00
-constexpr double kAngleD = 0.05;  // 0.05
+constexpr double kRotateMaxSpeed = 320.0;      // deg/sec
+constexpr double kRotateTimeToMaxSpeed = 0.5;  // sec
+constexpr double kAngleP = 0.75;               // 0.75
+constexpr double kAngleI = 0.00;               // 0.00
+constexpr double kAngleD = 0.05;               // 0.05
+
+// Run the DriveTrain position and angle PID on the Talons instead of the RIO.
+// The Talons estimate the angle from the encoders instead of the gyro.
+constexpr bool kDriveOnboardClosedLoop = false;
+
+// Run a state-space (LQR and feedforward) controller on the RIO instead of the
+// DriveTrain position and angle PID. kDriveOnboardClosedLoop takes precedence.
+constexpr bool kDriveStateSpace = false;
+
+// DriveTrain characterization, estimated from kDriveFullOutputVelocity until
+// it's measured
+constexpr double kDriveKvLinear = 0.08;   // V/(in/sec)
+constexpr double kDriveKaLinear = 0.03;   // V/(in/sec^2)
+constexpr double kDriveKvAngular = 0.09;  // V/(in/sec)
+constexpr double kDriveKaAngular = 0.04;  // V/(in/sec^2)
+
+// Drive the DriveTrain position and angle PID from trapezoid profiles, with
+// feedforward from the characterization and wider output ranges. Leave this
+// off until the characterization has been measured.
+constexpr bool kDriveProfiledFeedforward = false;
+
+// DriveTrain position and angle PID feedforward from the characterization,
+// with outputs as a fraction of 12 V. Rotating one degree moves each wheel
+// kDriveWheelPerDegree inches.
+constexpr double kDriveWheelPerDegree =
+    kRobotWidth / 2.0 * wpi::math::pi / 180.0;  // in/deg
+constexpr double kPosKs = 0.05;
+constexpr double kPosKv = kDriveKvLinear / 12.0;  // 1/(in/sec)
+constexpr double kPosKa = kDriveKaLinear / 12.0;  // 1/(in/sec^2)
+constexpr double kAngleKs = 0.05;
+constexpr double kAngleKv =
+    kDriveKvAngular / 12.0 * kDriveWheelPerDegree;  // 1/(deg/sec)
+constexpr double kAngleKa =
+    kDriveKaAngular / 12.0 * kDriveWheelPerDegree;  // 1/(deg/sec^2)
+
+// DriveTrain state-space controller tolerances and output limit
+constexpr double kStateSpacePosTolerance = 1.5;   // in
+constexpr double kStateSpaceVelTolerance = 20.0;  // in/sec
+constexpr double kStateSpaceMaxVoltage = 9.0;     // V
+
+// Use a Kalman filter fusing the encoders and gyro rate for the angle PID's
+// heading instead of the gyro's angle
+constexpr bool kDriveStateEstimator = false;
+
+// DriveTrain state estimator noise standard deviations
+constexpr double kEstimatorAccelStdDev = 30.0;           // in/sec^2
+constexpr double kEstimatorAngularAccelStdDev = 3.0;     // rad/sec^2
+constexpr double kEstimatorEncoderVelocityStdDev = 2.0;  // in/sec
+constexpr double kEstimatorEncoderRateStdDev = 4.0;      // in/sec
+constexpr double kEstimatorGyroRateStdDev = 0.02;        // rad/sec
+
+// DriveTrain trajectory limits
+constexpr double kTrajectoryMaxV = 120.0;            // in/sec
+constexpr double kTrajectoryMaxA = 100.0;            // in/sec^2
+constexpr double kTrajectoryMaxCentripetalA = 80.0;  // in/sec^2
+
+// Ramsete trajectory follower gains. b is 2 rad^2/m^2 converted to inches.
+constexpr double kRamseteB = 2.0 / (39.37 * 39.37);
+constexpr double kRamseteZeta = 0.7;
+
+// Wheel velocity at full output in high gear
+constexpr double kDriveFullOutputVelocity = 150.0;  // in/sec
+
+// DriveTrain odometry. The history covers camera latency, and the odometry
+// holds still after a sensor reset until the Talons have applied it.
+constexpr double kOdometryHistoryLength = 1.0;     // sec
+constexpr double kOdometrySensorResetTime = 0.05;  // sec
+
+// DriveTrain position and angle PID telemetry, recorded every control cycle to
+// "<kDriveTelemetryName>-N.tlog" in the operating directory (/home/lvuser).
+// Each boot writes the next of kDriveTelemetryMaxFiles files, keeping the
+// newest kDriveTelemetryMaxFiles - 1 logs.
+constexpr bool kDriveTelemetry = false;
+constexpr char kDriveTelemetryName[] = "drive";
+constexpr int kDriveTelemetryMaxFiles = 10;
+constexpr double kDriveTelemetryBandwidth = 16.0 * 1024.0;  // bytes/sec
 
 // CheesyDrive constants
 constexpr double kLowGearSensitive = 0.75;
@@ -2,15 +2,22 @@
 
 #pragma once
 
+#include <atomic>
+#include <string>
+#include <vector>
+
 #include <units/time.h>
 
 #include <frc/PIDOutput.h>
-#include <frc/ctrlsys/FuncNode.h>
+#include <frc/ctrlsys/FeedforwardNode.h>
+#include <frc/ctrlsys/GainNode.h>
 #include <frc/ctrlsys/INode.h>
 #include <frc/ctrlsys/Output.h>
 #include <frc/ctrlsys/OutputGroup.h>
 #include <frc/ctrlsys/PIDNode.h>
+#include <frc/ctrlsys/RefInput.h>
 #include <frc/ctrlsys/SumNode.h>
+#include <frc/ctrlsys/TelemetryLog.h>
 
 namespace frc {
 
@@ -36,6 +43,17 @@ namespace frc {
  *
  * Set the position and angle PID constants via GetPositionPID()->SetPID() and
  * GetAnglePID()->SetPID() before enabling this controller.
+ *
+ * Each controller can also be given velocity and acceleration references, such
+ * as a MotionProfile's velocity and acceleration nodes, whose feedforward is
+ * added to its PID output. Set the feedforward gains via
+ * GetPositionFeedforward()->SetGains() and GetAngleFeedforward()->SetGains().
+ * The feedforward then supplies most of the output needed to follow the
+ * profile, and the PID controllers only correct the remaining error. Without
+ * these references, the feedforward is zero.
+ *
+ * Every control cycle can be recorded to a TelemetryLog with the fields from
+ * GetTelemetryFields() by passing it to SetTelemetryLog().
  */
 class DiffDriveController {
 public:
@@ -43,6 +61,13 @@ public:
                         INode& rightEncoder, INode& angleSensor, bool clockwise,
                         PIDOutput& leftMotor, PIDOutput& rightMotor,
                         units::second_t period = INode::kDefaultPeriod);
+    DiffDriveController(INode& positionRef, INode& velocityRef,
+                        INode& accelerationRef, INode& angleRef,
+                        INode& angularVelocityRef,
+                        INode& angularAccelerationRef, INode& leftEncoder,
+                        INode& rightEncoder, INode& angleSensor, bool clockwise,
+                        PIDOutput& leftMotor, PIDOutput& rightMotor,
+                        units::second_t period = INode::kDefaultPeriod);
 
     void Enable();
     void Disable();
@@ -50,6 +75,9 @@ public:
     PIDNode& GetPositionPID();
     PIDNode& GetAnglePID();
 
+    FeedforwardNode& GetPositionFeedforward();
+    FeedforwardNode& GetAngleFeedforward();
+
     double GetPosition();
     double GetAngle();
 
@@ -59,10 +87,34 @@ public:
     bool AtPosition() const;
     bool AtAngle() const;
 
+    void SetTelemetryLog(TelemetryLog* log);
+    static std::vector<std::string> GetTelemetryFields();
+
 private:
+    // Records each cycle after the outputs are set, while the nodes' outputs
+    // for it are still cached
+    class RecordingOutputGroup : public OutputGroup {
+    public:
+        explicit RecordingOutputGroup(DiffDriveController& controller);
+        ~RecordingOutputGroup() override;
+
+    protected:
+        void OutputFunc() override;
+
+    private:
+        DiffDriveController& m_controller;
+    };
+
+    // Velocity and acceleration references when none are given
+    RefInput m_zeroRef{0.0};
+
     // Control system references
     INode& m_positionRef;
+    INode& m_velocityRef;
+    INode& m_accelerationRef;
     INode& m_angleRef;
+    INode& m_angularVelocityRef;
+    INode& m_angularAccelerationRef;
 
     // Encoders
     INode& m_leftEncoder;
@@ -77,15 +129,19 @@ private:
     PIDOutput& m_rightMotor;
 
     // Position PID
-    FuncNode m_positionCalc{[&] {
-        return (m_leftEncoder.GetOutput() + m_rightEncoder.GetOutput()) / 2.0;
-    }};
+    SumNode m_encoderSum{m_leftEncoder, true, m_rightEncoder, true};
+    GainNode m_positionCalc{0.5, m_encoderSum};
     SumNode m_positionError{m_positionRef, true, m_positionCalc, false};
-    PIDNode m_positionPID{0.0, 0.0, 0.0, m_positionError};
+    FeedforwardNode m_positionFeedforward{0.0, 0.0, 0.0, m_velocityRef,
+                                          m_accelerationRef};
+    PIDNode m_positionPID{0.0, 0.0, 0.0, m_positionFeedforward,
+                          m_positionError};
 
     // Angle PID
     SumNode m_angleError{m_angleRef, true, m_angleSensor, false};
-    PIDNode m_anglePID{0.0, 0.0, 0.0, m_angleError};
+    FeedforwardNode m_angleFeedforward{0.0, 0.0, 0.0, m_angularVelocityRef,
+                                       m_angularAccelerationRef};
+    PIDNode m_anglePID{0.0, 0.0, 0.0, m_angleFeedforward, m_angleError};
 
     // Combine outputs for left motor
     SumNode m_leftMotorInput;
@@ -95,8 +151,12 @@ private:
     SumNode m_rightMotorInput;
     Output m_rightOutput;
 
-    OutputGroup m_outputs;
+    std::atomic<TelemetryLog*> m_telemetryLog{nullptr};
+
+    RecordingOutputGroup m_outputs{*this};
     units::second_t m_period;
+
+    void Record();
 };
 
 }  // namespace frc
@@ -0,0 +1,73 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <exception>
+#include <functional>
+#include <memory>
+
+namespace frc3512 {
+
+/**
+ * A stackful coroutine that runs a function on the thread resuming it.
+ *
+ * Resume() switches to the function's stack and runs it until it calls
+ * Suspend() or returns, then switches back. Switching never blocks or goes
+ * through the scheduler, so handing control back and forth is cheaper than
+ * waking another thread. It isn't free, though: ucontext's swapcontext() also
+ * saves and restores the signal mask, which costs a sigprocmask system call on
+ * each switch. Windows fibers switch without one.
+ *
+ * The stack is allocated once at construction and reused by each function
+ * started afterward, so starting a function doesn't allocate. On Linux and
+ * macOS, the stack is populated at construction so it doesn't page fault on
+ * first use, and it has a guard page so an overflow crashes instead of
+ * corrupting memory.
+ *
+ * Windows uses its native fibers. Linux and macOS use ucontext, which is
+ * deprecated on macOS but still supported there.
+ */
+class Fiber {
+public:
+    static constexpr size_t kDefaultStackSize = 512 * 1024;
+
+    explicit Fiber(size_t stackSize = kDefaultStackSize);
+    ~Fiber();
+
+    Fiber(const Fiber&) = delete;
+    Fiber& operator=(const Fiber&) = delete;
+
+    void Start(std::function<void()> func);
+    void Resume();
+    void Suspend();
+
+    bool IsRunning() const;
+
+private:
+    std::function<void()> m_func;
+    std::exception_ptr m_exception;
+    bool m_running = false;
+
+#ifdef _WIN32
+    void* m_fiber = nullptr;
+    void* m_caller = nullptr;
+
+    static void __stdcall Entry(void* param);
+#else
+    // The fiber's and caller's ucontexts. They're only declared here so this
+    // header doesn't need the feature macros macOS requires for ucontext.
+    struct Contexts;
+
+    void* m_stack = nullptr;
+    size_t m_mappingSize = 0;
+    std::unique_ptr<Contexts> m_contexts;
+
+    static void Entry();
+#endif
+
+    [[noreturn]] void Run();
+};
+
+}  // namespace frc3512
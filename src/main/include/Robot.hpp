@@ -11,6 +11,7 @@
 #include <frc/Joystick.h>
 #include <frc/Solenoid.h>
 #include <frc/TimedRobot.h>
+#include <frc/ctrlsys/TrajectoryCache.h>
 
 #include "AutonomousChooser.hpp"
 #include "Constants.hpp"
@@ -57,6 +58,10 @@ private:
     frc::Joystick driveStick2{kDriveStick2Port};
     frc::Joystick grabberStick{kGrabberStickPort};
 
+    // Autonomous mode trajectories, generated at startup. The autonomous
+    // modes use them, so they're declared before the chooser.
+    frc::TrajectoryCache m_trajectories;
+
     frc3512::AutonomousChooser m_autonChooser{"No-op", [] {}};
 
     // Camera
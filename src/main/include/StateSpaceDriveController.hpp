@@ -0,0 +1,149 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+
+#include <frc/PIDOutput.h>
+#include <frc/ctrlsys/FuncNode.h>
+#include <frc/ctrlsys/GainNode.h>
+#include <frc/ctrlsys/INode.h>
+#include <frc/ctrlsys/Matrix.h>
+#include <frc/ctrlsys/Output.h>
+#include <frc/ctrlsys/OutputGroup.h>
+#include <frc/ctrlsys/SumNode.h>
+#include <units/time.h>
+
+namespace frc {
+
+/**
+ * A state-space alternative to DiffDriveController, with the same references,
+ * sensors, and interface.
+ *
+ * The drive base is modeled from its characterization as the position and
+ * velocity of each side, driven by each side's voltage. A linear-quadratic
+ * regulator computed from the model at construction drives the error in each
+ * side's position and velocity to zero, and plant inversion feedforward
+ * supplies the voltage that moves the model along the references. The
+ * references' velocities are their changes over each period, so references
+ * from a motion profile are followed mostly by feedforward.
+ *
+ * Like DiffDriveController, the position is the average of the encoders and
+ * the angle comes from the angle sensor. The angle error is applied as
+ * opposite position errors on each side.
+ *
+ * The gains are fixed-size matrices, so each control cycle does the same small
+ * amount of work without allocating.
+ */
+class StateSpaceDriveController {
+public:
+    /**
+     * Voltage needed per wheel velocity and acceleration.
+     *
+     * The linear gains are for both sides driving the same direction, and the
+     * angular gains for the sides driving opposite directions, in volts per
+     * wheel distance unit per second and per second^2.
+     */
+    struct Characterization {
+        double kVLinear;
+        double kALinear;
+        double kVAngular;
+        double kAAngular;
+    };
+
+    /**
+     * The largest acceptable error in each side's position and velocity and
+     * each side's voltage, which weight the regulator (Bryson's rule).
+     * Smaller position and velocity tolerances make it more aggressive.
+     */
+    struct Tolerances {
+        double position;
+        double velocity;
+        double voltage;
+    };
+
+    StateSpaceDriveController(INode& positionRef, INode& angleRef,
+                              INode& leftEncoder, INode& rightEncoder,
+                              INode& leftRate, INode& rightRate,
+                              INode& angleSensor, bool clockwise,
+                              PIDOutput& leftMotor, PIDOutput& rightMotor,
+                              const Characterization& characterization,
+                              double trackWidth, const Tolerances& tolerances,
+                              units::second_t period = INode::kDefaultPeriod);
+
+    void Enable();
+    void Disable();
+
+    void SetMaxVoltage(double maxVoltage);
+
+    double GetPosition();
+    double GetAngle();
+
+    void SetPositionTolerance(double tolerance, double deltaTolerance);
+    void SetAngleTolerance(double tolerance, double deltaTolerance);
+
+    bool AtPosition() const;
+    bool AtAngle() const;
+
+private:
+    // Battery voltage the outputs are scaled by
+    static constexpr double kNominalVoltage = 12.0;
+
+    // Control system references
+    INode& m_positionRef;
+    INode& m_angleRef;
+
+    // Encoders
+    INode& m_leftEncoder;
+    INode& m_rightEncoder;
+    INode& m_leftRate;
+    INode& m_rightRate;
+
+    // Angle sensor (e.g., gyroscope)
+    INode& m_angleSensor;
+    bool m_clockwise;
+
+    double m_trackWidth;
+    double m_dt;
+
+    // The model's discrete system matrix, and the regulator and feedforward
+    // gains. The state is each side's position and velocity.
+    Matrix<4, 4> m_A;
+    Matrix<2, 4> m_K;
+    Matrix<2, 4> m_Kff;
+
+    std::atomic<double> m_maxVoltage{kNominalVoltage};
+
+    // Set by Enable() so the next cycle starts without reference velocities
+    std::atomic<bool> m_reset{true};
+
+    // Owned by the thread evaluating the outputs
+    double m_lastPositionRef = 0.0;
+    double m_lastAngleRef = 0.0;
+    Vector<4> m_lastR;
+    Vector<2> m_u;
+
+    // Errors for AtPosition() and AtAngle()
+    SumNode m_encoderSum{m_leftEncoder, true, m_rightEncoder, true};
+    GainNode m_positionCalc{0.5, m_encoderSum};
+    SumNode m_positionError{m_positionRef, true, m_positionCalc, false};
+    SumNode m_angleError{m_angleRef, true, m_angleSensor, false};
+
+    FuncNode m_leftVoltage{[this] {
+        Update();
+        return m_u(0, 0) / kNominalVoltage;
+    }};
+    FuncNode m_rightVoltage{[this] {
+        m_leftVoltage.Evaluate();
+        return m_u(1, 0) / kNominalVoltage;
+    }};
+
+    Output m_leftOutput;
+    Output m_rightOutput;
+    OutputGroup m_outputs;
+    units::second_t m_period;
+
+    void Update();
+};
+
+}  // namespace frc
@@ -0,0 +1,124 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <limits>
+
+#include <ctre/phoenix/motorcontrol/can/TalonSRX.h>
+#include <frc/ctrlsys/INode.h>
+#include <frc/ctrlsys/SeqLock.h>
+#include <units/time.h>
+
+/**
+ * A DiffDriveController backend that runs the position and angle loops on the
+ * Talon SRXs instead of the roboRIO.
+ *
+ * The right leader's primary closed loop uses the average of both sides'
+ * encoders. The left leader's encoder is read as a remote sensor. The
+ * auxiliary loop holds the heading, estimated from the difference between the
+ * encoders. The left leader follows the right with the auxiliary output
+ * applied in the opposite direction. Both loops run on the Talon every 1 ms,
+ * so sensor readings don't take a CAN round trip to the roboRIO.
+ *
+ * The roboRIO only streams the references. It uses the ControlScheduler at the
+ * given period and polls the closed-loop errors from the Talons' status frames
+ * for AtPosition() and AtAngle().
+ *
+ * Gains use the same units as DiffDriveController's PIDNodes (output fraction
+ * per unit of distance or degree) and are converted to Talon units.
+ */
+class TalonDiffDriveController {
+public:
+    using TalonSRX = ctre::phoenix::motorcontrol::can::TalonSRX;
+
+    TalonDiffDriveController(frc::INode& positionRef, frc::INode& angleRef,
+                             TalonSRX& leftLeader, TalonSRX& rightLeader,
+                             double distancePerPulse, double trackWidth,
+                             bool clockwise,
+                             units::second_t period =
+                                 frc::INode::kDefaultPeriod);
+    ~TalonDiffDriveController();
+
+    TalonDiffDriveController(const TalonDiffDriveController&) = delete;
+    TalonDiffDriveController& operator=(const TalonDiffDriveController&) =
+        delete;
+
+    void Enable();
+    void Disable();
+
+    void SetPositionPID(double p, double i, double d);
+    void SetAnglePID(double p, double i, double d);
+
+    void SetPositionOutputRange(double maxU);
+    void SetAngleOutputRange(double maxU);
+
+    void SetMotionMagic(double maxVelocity, double maxAcceleration);
+
+    double GetPosition();
+    double GetAngle();
+
+    void SetPositionTolerance(double tolerance, double deltaTolerance);
+    void SetAngleTolerance(double tolerance, double deltaTolerance);
+
+    bool AtPosition() const;
+    bool AtAngle() const;
+
+private:
+    static constexpr int kPositionSlot = 0;
+    static constexpr int kAngleSlot = 1;
+    static constexpr int kPrimaryPID = 0;
+    static constexpr int kAuxPID = 1;
+    static constexpr int kTimeoutMs = 10;
+
+    // Talon closed loops run every 1 ms
+    static constexpr double kTalonPeriod = 0.001;
+
+    // Talon closed loop output at 100%
+    static constexpr double kTalonFullOutput = 1023.0;
+
+    /**
+     * Tracks a loop's error with the same tolerance semantics as SumNode.
+     */
+    class ErrorTolerance {
+    public:
+        void SetTolerance(double tolerance, double deltaTolerance);
+        void Update(double error);
+        bool InTolerance() const;
+
+    private:
+        struct Result {
+            double current;
+            double last;
+        };
+
+        struct Tolerance {
+            double tolerance;
+            double deltaTolerance;
+        };
+
+        frc::SeqLock<Result> m_result{Result{0.0, 0.0}};
+        frc::SeqLock<Tolerance> m_tolerance{
+            Tolerance{std::numeric_limits<double>::infinity(),
+                      std::numeric_limits<double>::infinity()}};
+    };
+
+    frc::INode& m_positionRef;
+    frc::INode& m_angleRef;
+
+    TalonSRX& m_leftLeader;
+    TalonSRX& m_rightLeader;
+
+    double m_distancePerPulse;
+    double m_degreesPerPulse;
+
+    units::second_t m_period;
+
+    std::atomic<bool> m_motionMagic{false};
+
+    ErrorTolerance m_positionTolerance;
+    ErrorTolerance m_angleTolerance;
+
+    void SetPID(int slot, double unitsPerPulse, double p, double i, double d);
+    void StreamReferences();
+};
@@ -2,16 +2,32 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <atomic>
+#include <optional>
+
 #include <ctre/phoenix/motorcontrol/can/WPI_TalonSRX.h>
 #include <frc/ADXRS450_Gyro.h>
 #include <frc/Encoder.h>
+#include <frc/ctrlsys/DriveOdometry.h>
+#include <frc/ctrlsys/DriveStateEstimator.h>
+#include <frc/ctrlsys/DriveTrajectory.h>
 #include <frc/ctrlsys/FuncNode.h>
+#include <frc/ctrlsys/INode.h>
+#include <frc/ctrlsys/Pose.h>
+#include <frc/ctrlsys/RamseteFollower.h>
 #include <frc/ctrlsys/RefInput.h>
+#include <frc/ctrlsys/TelemetryLog.h>
+#include <frc/ctrlsys/TrapezoidProfile.h>
 #include <frc/drive/DifferentialDrive.h>
+#include <units/time.h>
 
 #include "CANEncoder.hpp"
 #include "Constants.hpp"
 #include "DiffDriveController.hpp"
+#include "StateSpaceDriveController.hpp"
+#include "TalonDiffDriveController.hpp"
 #include "TalonSRXGroup.hpp"
 
 /**
@@ -22,6 +38,7 @@ public:
     using WPI_TalonSRX = ctre::phoenix::motorcontrol::can::WPI_TalonSRX;
 
     Drivetrain();
+    ~Drivetrain();
 
     int32_t GetLeftRaw() const;
     int32_t GetRightRaw() const;
@@ -71,13 +88,29 @@ public:
     bool PosAtReference() const;
     bool AngleAtReference() const;
 
+    /* Follows a trajectory starting at the robot's current position. The
+     * trajectory must outlive following it. Stop with StopClosedLoop().
+     */
+    void FollowTrajectory(const frc::DriveTrajectory& trajectory);
+
+    // Returns whether or not the trajectory's end time has passed
+    bool AtTrajectoryEnd() const;
+
+    // Returns robot's field-relative pose from odometry
+    frc::Pose GetPose() const;
+
+    /* Returns robot's pose at a past FPGA timestamp, such as when a camera
+     * frame was captured, or nothing if it's older than the odometry history.
+     */
+    std::optional<frc::Pose> GetPose(units::second_t timestamp) const;
+
     // Resets gyro
     void ResetGyro();
 
     // Calibrates gyro
     void CalibrateGyro();
 
-    // Sends print statements for debugging purposes
+    // Reports telemetry log problems for debugging purposes
     void Debug();
 
 private:
@@ -102,19 +135,95 @@ private:
     frc::RefInput m_posRef{0.0};
     frc::RefInput m_angleRef{0.0};
 
+    // Profiles from the current position and angle to the references, which
+    // drive the position and angle PID and their feedforward if
+    // kDriveProfiledFeedforward is true
+    frc::TrapezoidProfile m_posProfile{kDriveMaxSpeed, kDriveTimeToMaxSpeed};
+    frc::TrapezoidProfile m_angleProfile{kRotateMaxSpeed,
+                                         kRotateTimeToMaxSpeed};
+
     // Sensor adapters
     frc::FuncNode m_leftEncoderDistance{
         [this] { return m_leftEncoder.GetDistance(); }};
     frc::FuncNode m_rightEncoderDistance{
         [this] { return m_rightEncoder.GetDistance(); }};
-    frc::FuncNode m_angleSensor{[this] { return m_gyro.GetAngle(); }};
-
-    frc::DiffDriveController m_controller{m_posRef,
-                                          m_angleRef,
-                                          m_leftEncoderDistance,
-                                          m_rightEncoderDistance,
-                                          m_angleSensor,
-                                          true,
-                                          m_leftGrbx,
-                                          m_rightGrbx};
+    // The Talons report rates per 100 ms
+    frc::FuncNode m_leftEncoderRate{
+        [this] { return m_leftEncoder.GetRate() * 10.0; }};
+    frc::FuncNode m_rightEncoderRate{
+        [this] { return m_rightEncoder.GetRate() * 10.0; }};
+    frc::FuncNode m_gyroRate{[this] { return GetHeadingRate(); }};
+
+    frc::DriveStateEstimator m_estimator{
+        m_leftEncoderDistance,
+        m_rightEncoderDistance,
+        m_leftEncoderRate,
+        m_rightEncoderRate,
+        m_gyroRate,
+        kRobotWidth,
+        {kEstimatorAccelStdDev, kEstimatorAngularAccelStdDev,
+         kEstimatorEncoderVelocityStdDev, kEstimatorEncoderRateStdDev,
+         kEstimatorGyroRateStdDev}};
+
+    frc::FuncNode m_angleSensor{[this] { return GetAngleSensor(); }};
+
+    // Records m_controller's control cycles if kDriveTelemetry is true. It's
+    // declared first so it outlives recording.
+    std::optional<frc::TelemetryLog> m_telemetry;
+    uint64_t m_reportedDropCount = 0;
+
+    // The feedforward gains are zero unless kDriveProfiledFeedforward is true,
+    // so only the position references need to be chosen
+    frc::DiffDriveController m_controller{
+        kDriveProfiledFeedforward ? m_posProfile.GetPositionNode() : m_posRef,
+        m_posProfile.GetVelocityNode(),
+        m_posProfile.GetAccelerationNode(),
+        kDriveProfiledFeedforward ? m_angleProfile.GetPositionNode()
+                                  : m_angleRef,
+        m_angleProfile.GetVelocityNode(),
+        m_angleProfile.GetAccelerationNode(),
+        m_leftEncoderDistance,
+        m_rightEncoderDistance,
+        m_angleSensor,
+        true,
+        m_leftGrbx,
+        m_rightGrbx};
+
+    // Used instead of m_controller if kDriveStateSpace is true. It's only
+    // constructed then, since constructing it discretizes the drive model and
+    // solves for the LQR gains.
+    std::optional<frc::StateSpaceDriveController> m_stateSpaceController;
+
+    // Used instead of m_controller if kDriveOnboardClosedLoop is true. It's
+    // only constructed then, since constructing it reconfigures the Talons'
+    // feedback sensors and status frames.
+    std::optional<TalonDiffDriveController> m_onboardController;
+
+    // Field-relative odometry, updated by the control thread every period
+    frc::DriveOdometry m_odometry{static_cast<size_t>(
+        kOdometryHistoryLength / frc::INode::kDefaultPeriod.to<double>())};
+
+    // FPGA time of the last encoder or gyro reset
+    std::atomic<double> m_sensorResetTime{0.0};
+
+    // Trajectory following. The trajectory is owned by the control thread
+    // while following, which follows it from the odometry's pose when it
+    // started.
+    frc::RamseteFollower m_follower{kRamseteB, kRamseteZeta};
+    const frc::DriveTrajectory* m_trajectory = nullptr;
+    frc::Pose m_trajectoryOrigin{0.0, 0.0, 0.0};
+    double m_trajectoryStartTime = 0.0;
+    std::atomic<bool> m_trajectoryDone{false};
+
+    // Returns gyro's angle as a counterclockwise heading in radians
+    double GetHeading();
+
+    // Returns gyro's rate in counterclockwise radians per second
+    double GetHeadingRate();
+
+    // Returns the angle PID's measurement in clockwise degrees
+    double GetAngleSensor();
+
+    void OdometryTick();
+    void FollowTrajectoryTick();
 };
@@ -0,0 +1,29 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "AllocationCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Per thread so background threads, such as the ControlScheduler's, don't
+// affect the count
+thread_local size_t tAllocations = 0;
+
+}  // namespace
+
+size_t GetAllocationCount() { return tAllocations; }
+
+// The array and nothrow forms call these by default
+void* operator new(size_t size) {
+    ++tAllocations;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
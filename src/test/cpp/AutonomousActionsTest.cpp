@@ -0,0 +1,114 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "AutonomousActions.hpp"
+
+namespace {
+
+/**
+ * An action that records its calls and finishes after a number of updates.
+ */
+struct CountingAction {
+    explicit CountingAction(int updates, std::string* log, char name)
+        : updates(updates), log(log), name(name) {}
+
+    void Start() {
+        *log += name;
+        *log += 's';
+        count = 0;
+    }
+
+    bool Update() {
+        *log += name;
+        return ++count >= updates;
+    }
+
+    void Stop() {
+        *log += name;
+        *log += 'x';
+    }
+
+    int updates;
+    int count = 0;
+    std::string* log;
+    char name;
+};
+
+/**
+ * Runs an action like AutonomousChooser::Await() and returns the number of
+ * periods it took.
+ */
+template <typename Action>
+int RunToEnd(Action& action) {
+    int periods = 1;
+    action.Start();
+    while (!action.Update()) {
+        ++periods;
+    }
+    return periods;
+}
+
+}  // namespace
+
+TEST(AutonomousActionsTest, SequenceStartsNextInSamePeriod) {
+    std::string log;
+    frc3512::Sequence action{CountingAction{2, &log, 'a'},
+                             CountingAction{1, &log, 'b'},
+                             CountingAction{2, &log, 'c'}};
+
+    EXPECT_EQ(RunToEnd(action), 3);
+    EXPECT_EQ(log, "asaabsbcscc");
+}
+
+TEST(AutonomousActionsTest, ParallelFinishesAfterAll) {
+    std::string log;
+    frc3512::Parallel action{CountingAction{3, &log, 'a'},
+                             CountingAction{1, &log, 'b'}};
+
+    EXPECT_EQ(RunToEnd(action), 3);
+    EXPECT_EQ(log, "asbsabaa");
+}
+
+TEST(AutonomousActionsTest, RaceStopsOthers) {
+    std::string log;
+    frc3512::Race action{CountingAction{3, &log, 'a'},
+                         CountingAction{2, &log, 'b'}};
+
+    EXPECT_EQ(RunToEnd(action), 2);
+    EXPECT_EQ(log, "asbsababax");
+}
+
+TEST(AutonomousActionsTest, Timeout) {
+    std::string log;
+    frc3512::Timeout action{CountingAction{1000000000, &log, 'a'}, 10_ms};
+
+    RunToEnd(action);
+    EXPECT_TRUE(action.TimedOut());
+    EXPECT_EQ(log.substr(log.size() - 2), "ax");
+
+    frc3512::Timeout quick{CountingAction{2, &log, 'b'}, 10_s};
+    EXPECT_EQ(RunToEnd(quick), 2);
+    EXPECT_FALSE(quick.TimedOut());
+}
+
+TEST(AutonomousActionsTest, Compose) {
+    int shifts = 0;
+    bool atReference = false;
+    std::string log;
+
+    // Drive while a mechanism moves, then shift once both are done
+    frc3512::Sequence action{
+        frc3512::Parallel{
+            frc3512::Timeout{
+                frc3512::WaitUntil{[&] { return atReference; }}, 10_s},
+            frc3512::Sequence{CountingAction{2, &log, 'a'},
+                              frc3512::Instant{[&] { atReference = true; }}}},
+        frc3512::Instant{[&] { ++shifts; }}};
+
+    EXPECT_EQ(RunToEnd(action), 3);
+    EXPECT_EQ(shifts, 1);
+    EXPECT_EQ(log, "asaa");
+}
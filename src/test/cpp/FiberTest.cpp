@@ -0,0 +1,130 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Fiber.hpp"
+
+namespace {
+
+/**
+ * Recurses depth times with a kilobyte of locals per call, suspends the fiber
+ * at the bottom, then returns true if every call's locals survived.
+ */
+bool FillStack(frc3512::Fiber& fiber, int depth) {
+    volatile char locals[1024];
+    for (auto& local : locals) {
+        local = static_cast<char>(depth);
+    }
+
+    bool intact = true;
+    if (depth > 0) {
+        intact = FillStack(fiber, depth - 1);
+    } else {
+        fiber.Suspend();
+    }
+
+    for (auto& local : locals) {
+        intact = intact && local == static_cast<char>(depth);
+    }
+    return intact;
+}
+
+}  // namespace
+
+TEST(FiberTest, SuspendAndResume) {
+    frc3512::Fiber fiber;
+    std::vector<int> order;
+
+    fiber.Start([&] {
+        order.emplace_back(1);
+        fiber.Suspend();
+        order.emplace_back(3);
+    });
+    EXPECT_TRUE(fiber.IsRunning());
+
+    fiber.Resume();
+    order.emplace_back(2);
+    EXPECT_TRUE(fiber.IsRunning());
+
+    fiber.Resume();
+    EXPECT_FALSE(fiber.IsRunning());
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+
+    // Resuming a returned function does nothing
+    fiber.Resume();
+    EXPECT_EQ(order.size(), 3u);
+}
+
+TEST(FiberTest, RunsOnCallingThread) {
+    frc3512::Fiber fiber;
+    std::thread::id id;
+
+    fiber.Start([&] { id = std::this_thread::get_id(); });
+    fiber.Resume();
+
+    EXPECT_EQ(id, std::this_thread::get_id());
+}
+
+TEST(FiberTest, ReusesStack) {
+    frc3512::Fiber fiber;
+
+    for (int run = 0; run < 3; ++run) {
+        int count = 0;
+        fiber.Start([&] {
+            for (int i = 0; i < 10; ++i) {
+                ++count;
+                fiber.Suspend();
+            }
+        });
+        while (fiber.IsRunning()) {
+            fiber.Resume();
+        }
+        EXPECT_EQ(count, 10);
+    }
+}
+
+TEST(FiberTest, RethrowsException) {
+    frc3512::Fiber fiber;
+
+    fiber.Start([&] {
+        fiber.Suspend();
+        throw std::runtime_error{"autonomous"};
+    });
+    fiber.Resume();
+
+    EXPECT_THROW(fiber.Resume(), std::runtime_error);
+    EXPECT_FALSE(fiber.IsRunning());
+
+    // The fiber still works afterward
+    bool ran = false;
+    fiber.Start([&] { ran = true; });
+    fiber.Resume();
+    EXPECT_TRUE(ran);
+}
+
+TEST(FiberTest, PreservesStackWhileSuspended) {
+    frc3512::Fiber fiber;
+
+    // Suspend with about half of the default stack in use, then run another
+    // fiber in between
+    bool intact = false;
+    fiber.Start([&] { intact = FillStack(fiber, 256); });
+    fiber.Resume();
+    ASSERT_TRUE(fiber.IsRunning());
+
+    frc3512::Fiber other;
+    bool otherIntact = false;
+    other.Start([&] { otherIntact = FillStack(other, 256); });
+    while (other.IsRunning()) {
+        other.Resume();
+    }
+    EXPECT_TRUE(otherIntact);
+
+    fiber.Resume();
+    EXPECT_FALSE(fiber.IsRunning());
+    EXPECT_TRUE(intact);
+}
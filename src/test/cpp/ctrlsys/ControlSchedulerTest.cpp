@@ -0,0 +1,94 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <frc/ctrlsys/ControlScheduler.h>
+#include <gtest/gtest.h>
+#include <units/time.h>
+
+namespace {
+
+constexpr units::second_t kPeriod{0.005};
+
+/**
+ * Waits up to a second for a condition to become true and returns whether it
+ * did.
+ */
+template <typename F>
+bool WaitFor(F&& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(ControlSchedulerTest, TaskCanUnscheduleItself) {
+    auto& scheduler = frc::ControlScheduler::GetInstance();
+
+    int owner;
+    std::atomic<int> calls{0};
+    scheduler.Schedule(
+        &owner,
+        [&] {
+            ++calls;
+            scheduler.Unschedule(&owner);
+        },
+        kPeriod);
+
+    ASSERT_TRUE(WaitFor([&] { return calls > 0; }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(ControlSchedulerTest, TaskCanScheduleAnother) {
+    auto& scheduler = frc::ControlScheduler::GetInstance();
+
+    int owner;
+    int otherOwner;
+    std::atomic<bool> otherRan{false};
+    scheduler.Schedule(
+        &owner,
+        [&] {
+            scheduler.Schedule(
+                &otherOwner, [&] { otherRan = true; }, kPeriod);
+            scheduler.Unschedule(&owner);
+        },
+        kPeriod);
+
+    EXPECT_TRUE(WaitFor([&] { return otherRan.load(); }));
+    scheduler.Unschedule(&otherOwner);
+}
+
+TEST(ControlSchedulerTest, UnscheduleWaitsForRunningTask) {
+    auto& scheduler = frc::ControlScheduler::GetInstance();
+
+    int owner;
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+    scheduler.Schedule(
+        &owner,
+        [&] {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            finished = true;
+        },
+        kPeriod);
+
+    ASSERT_TRUE(WaitFor([&] { return started.load(); }));
+    scheduler.Unschedule(&owner);
+
+    // The task may have started again before Unschedule() took the lock, but
+    // it can't still be running
+    EXPECT_TRUE(finished);
+    finished = false;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(finished);
+}
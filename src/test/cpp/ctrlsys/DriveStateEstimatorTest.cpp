@@ -0,0 +1,186 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include <frc/ctrlsys/DriveStateEstimator.h>
+#include <frc/ctrlsys/INode.h>
+#include <frc/ctrlsys/RefInput.h>
+#include <gtest/gtest.h>
+
+#include "AllocationCounter.hpp"
+
+namespace {
+
+constexpr double kDt = 0.005;
+constexpr double kTrackWidth = 30.0;
+
+// Inches and radians
+constexpr frc::DriveStateEstimator::StandardDeviations kStdDevs{30.0, 3.0, 2.0,
+                                                                4.0, 0.02};
+
+/**
+ * Simulates a robot driving an S-curve with noisy sensors.
+ */
+class Simulation {
+public:
+    frc::RefInput leftDistance;
+    frc::RefInput rightDistance;
+    frc::RefInput leftRate;
+    frc::RefInput rightRate;
+    frc::RefInput gyroRate;
+
+    frc::DriveStateEstimator estimator{leftDistance, rightDistance, leftRate,
+                                       rightRate,    gyroRate,      kTrackWidth,
+                                       kStdDevs,     units::second_t{kDt}};
+
+    double x = 0.0;
+    double y = 0.0;
+    double heading = 0.0;
+    double velocity = 0.0;
+    double angularVelocity = 0.0;
+
+    // Offset subtracted from the encoder distances to simulate a reset
+    double encoderOffset = 0.0;
+
+    void Step(double time) {
+        velocity = 60.0 * std::sin(0.5 * time) + 20.0;
+        angularVelocity = 0.8 * std::sin(1.3 * time);
+
+        x += velocity * std::cos(heading + 0.5 * angularVelocity * kDt) * kDt;
+        y += velocity * std::sin(heading + 0.5 * angularVelocity * kDt) * kDt;
+        heading += angularVelocity * kDt;
+
+        double left = velocity - 0.5 * kTrackWidth * angularVelocity;
+        double right = velocity + 0.5 * kTrackWidth * angularVelocity;
+        m_left += left * kDt;
+        m_right += right * kDt;
+
+        // Encoders quantize distance, and rates and the gyro are noisy
+        constexpr double kDistancePerPulse = 0.02;
+        leftDistance.Set(
+            std::round((m_left - encoderOffset) / kDistancePerPulse) *
+            kDistancePerPulse);
+        rightDistance.Set(
+            std::round((m_right - encoderOffset) / kDistancePerPulse) *
+            kDistancePerPulse);
+        leftRate.Set(left + m_rateNoise(m_generator));
+        rightRate.Set(right + m_rateNoise(m_generator));
+        gyroRate.Set(angularVelocity + m_gyroNoise(m_generator));
+
+        frc::INode::Tick tick;
+        estimator.GetHeadingNode().Evaluate();
+        estimator.GetVelocityNode().Evaluate();
+    }
+
+private:
+    double m_left = 0.0;
+    double m_right = 0.0;
+
+    std::mt19937 m_generator{3512};
+    std::normal_distribution<double> m_rateNoise{0.0, 4.0};
+    std::normal_distribution<double> m_gyroNoise{0.0, 0.02};
+};
+
+}  // namespace
+
+TEST(DriveStateEstimatorTest, TracksNoisyRobot) {
+    Simulation sim;
+
+    double maxVelocityError = 0.0;
+    for (int i = 1; i <= 2000; ++i) {
+        sim.Step(i * kDt);
+
+        // The estimate starts at rest, so let it catch up first
+        auto estimate = sim.estimator.GetEstimate();
+        if (i > 50) {
+            maxVelocityError = std::max(
+                maxVelocityError, std::abs(estimate.velocity - sim.velocity));
+        }
+    }
+
+    auto estimate = sim.estimator.GetEstimate();
+    EXPECT_NEAR(estimate.pose.x, sim.x, 1.0);
+    EXPECT_NEAR(estimate.pose.y, sim.y, 1.0);
+    EXPECT_NEAR(estimate.pose.heading, sim.heading, 0.01);
+    EXPECT_NEAR(estimate.angularVelocity, sim.angularVelocity, 0.05);
+
+    // The rate noise alone has a standard deviation of 4 in/s
+    EXPECT_LT(maxVelocityError, 3.0);
+
+    // The covariance is symmetric and positive on the diagonal, and the
+    // heading's uncertainty grows without an absolute measurement
+    const auto& P = estimate.covariance;
+    for (int i = 0; i < frc::DriveStateEstimator::kStates; ++i) {
+        EXPECT_GT(P[i][i], 0.0);
+        for (int j = 0; j < i; ++j) {
+            EXPECT_NEAR(P[i][j], P[j][i], 1e-9);
+        }
+    }
+    EXPECT_LT(std::sqrt(P[2][2]), 0.05);
+}
+
+TEST(DriveStateEstimatorTest, RejectsEncoderReset) {
+    Simulation sim;
+
+    for (int i = 1; i <= 400; ++i) {
+        sim.Step(i * kDt);
+    }
+
+    // The distances jump back to zero for one cycle
+    sim.encoderOffset = sim.leftDistance.GetOutput();
+    sim.Step(401 * kDt);
+
+    auto estimate = sim.estimator.GetEstimate();
+    EXPECT_NEAR(estimate.velocity, sim.velocity, 3.0);
+}
+
+TEST(DriveStateEstimatorTest, Reset) {
+    Simulation sim;
+
+    for (int i = 1; i <= 400; ++i) {
+        sim.Step(i * kDt);
+    }
+
+    sim.estimator.Reset(frc::Pose{10.0, 20.0, 1.0});
+    sim.x = 10.0;
+    sim.y = 20.0;
+    sim.heading = 1.0;
+    sim.Step(401 * kDt);
+
+    auto estimate = sim.estimator.GetEstimate();
+    EXPECT_NEAR(estimate.pose.x, sim.x, 0.1);
+    EXPECT_NEAR(estimate.pose.y, sim.y, 0.1);
+    EXPECT_NEAR(estimate.pose.heading, sim.heading, 0.01);
+    EXPECT_NEAR(estimate.distance, sim.velocity * kDt, 0.1);
+    EXPECT_NEAR(estimate.velocity, sim.velocity, 3.0);
+}
+
+TEST(DriveStateEstimatorTest, UpdateBenchmark) {
+    constexpr int kIterations = 100000;
+
+    frc::RefInput distance;
+    frc::RefInput rate;
+    frc::DriveStateEstimator estimator{distance, distance,    rate,    rate,
+                                       rate,     kTrackWidth, kStdDevs};
+
+    size_t allocations = GetAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        distance.Set(i * 0.01);
+        rate.Set(2.0);
+        estimator.GetDistanceNode().Evaluate();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double updateNs =
+        std::chrono::duration<double, std::nano>(end - start).count() /
+        kIterations;
+
+    std::cout << "Update: " << updateNs << " ns" << std::endl;
+    EXPECT_TRUE(std::isfinite(estimator.GetEstimate().pose.x));
+
+    EXPECT_EQ(GetAllocationCount(), allocations);
+}
@@ -0,0 +1,248 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <frc/ctrlsys/DriveOdometry.h>
+#include <frc/ctrlsys/DriveTrajectory.h>
+#include <frc/ctrlsys/Pose.h>
+#include <frc/ctrlsys/RamseteFollower.h>
+#include <frc/ctrlsys/TrajectoryCache.h>
+#include <gtest/gtest.h>
+#include <wpi/math>
+
+#include "AllocationCounter.hpp"
+
+namespace {
+
+constexpr double kPi = wpi::math::pi;
+
+// Limits in inches and seconds
+constexpr frc::DriveTrajectory::Constraints kConstraints{120.0, 120.0, 100.0,
+                                                         30.0};
+
+const std::vector<frc::Pose> kWaypoints{
+    {0.0, 0.0, 0.0}, {80.0, -10.0, -kPi / 6.0}, {105.0, -40.0, -kPi / 3.0}};
+
+}  // namespace
+
+TEST(DriveTrajectoryTest, PassesThroughWaypoints) {
+    auto trajectory = frc::DriveTrajectory::Generate(kWaypoints, kConstraints);
+    const auto& states = trajectory.GetStates();
+
+    for (const auto& waypoint : kWaypoints) {
+        double closest = INFINITY;
+        for (const auto& state : states) {
+            closest = std::min(closest, std::hypot(state.pose.x - waypoint.x,
+                                                   state.pose.y - waypoint.y));
+        }
+        EXPECT_LT(closest, 1e-9);
+    }
+
+    EXPECT_NEAR(states.back().pose.heading, -kPi / 3.0, 1e-9);
+    EXPECT_EQ(states.front().velocity, 0.0);
+    EXPECT_EQ(states.back().velocity, 0.0);
+}
+
+TEST(DriveTrajectoryTest, RespectsConstraints) {
+    auto trajectory = frc::DriveTrajectory::Generate(kWaypoints, kConstraints);
+    const auto& states = trajectory.GetStates();
+
+    for (size_t i = 0; i < states.size(); ++i) {
+        const auto& state = states[i];
+        double turn = 0.5 * kConstraints.trackWidth * state.curvature;
+        double outerWheel = state.velocity * (1.0 + std::abs(turn));
+
+        EXPECT_LE(outerWheel, kConstraints.maxVelocity + 1e-9);
+        EXPECT_LE(state.velocity * state.velocity * std::abs(state.curvature),
+                  kConstraints.maxCentripetalAcceleration + 1e-9);
+        EXPECT_LE(std::abs(state.acceleration),
+                  kConstraints.maxAcceleration + 1e-9);
+
+        if (i > 0) {
+            EXPECT_GT(state.time, states[i - 1].time);
+        }
+    }
+}
+
+TEST(DriveTrajectoryTest, SampleInterpolates) {
+    auto trajectory = frc::DriveTrajectory::Generate(kWaypoints, kConstraints);
+
+    double lastDistance = 0.0;
+    for (double t = 0.0; t < trajectory.TotalTime(); t += 0.005) {
+        auto state = trajectory.Sample(t);
+        EXPECT_GE(state.distance, lastDistance);
+        EXPECT_LE(state.velocity, kConstraints.maxVelocity);
+        lastDistance = state.distance;
+    }
+
+    auto end = trajectory.Sample(trajectory.TotalTime() + 1.0);
+    EXPECT_NEAR(end.pose.x, 105.0, 1e-9);
+    EXPECT_NEAR(end.pose.y, -40.0, 1e-9);
+    EXPECT_EQ(end.velocity, 0.0);
+}
+
+TEST(DriveTrajectoryTest, RamseteConverges) {
+    constexpr double kDt = 0.005;
+
+    auto trajectory = frc::DriveTrajectory::Generate(kWaypoints, kConstraints);
+    frc::RamseteFollower follower{2.0 / (39.37 * 39.37), 0.7};
+
+    // Start off the path
+    frc::Pose pose{-6.0, 4.0, 0.2};
+    for (double t = 0.0; t < trajectory.TotalTime(); t += kDt) {
+        auto [v, omega] = follower.Calculate(pose, trajectory.Sample(t));
+
+        pose.x += v * std::cos(pose.heading) * kDt;
+        pose.y += v * std::sin(pose.heading) * kDt;
+        pose.heading += omega * kDt;
+    }
+
+    EXPECT_NEAR(pose.x, 105.0, 1.0);
+    EXPECT_NEAR(pose.y, -40.0, 1.0);
+    EXPECT_NEAR(pose.heading, -kPi / 3.0, 0.05);
+}
+
+TEST(DriveTrajectoryTest, OdometryFollowsArc) {
+    constexpr double kRadius = 50.0;
+    constexpr double kTrackWidth = 30.0;
+
+    frc::DriveOdometry odometry;
+    odometry.Reset(frc::Pose{10.0, 0.0, 0.0}, 0.0, 0.0, 1.0);
+
+    // Drive a counterclockwise quarter circle
+    double left = 0.0;
+    double right = 0.0;
+    for (int i = 1; i <= 100; ++i) {
+        double angle = i * (kPi / 2.0) / 100;
+        left = (kRadius - kTrackWidth / 2.0) * angle;
+        right = (kRadius + kTrackWidth / 2.0) * angle;
+        odometry.Update(left, right, 1.0 + angle);
+    }
+
+    auto pose = odometry.GetPose();
+    EXPECT_NEAR(pose.x, 10.0 + kRadius, 0.01);
+    EXPECT_NEAR(pose.y, kRadius, 0.01);
+    EXPECT_NEAR(pose.heading, kPi / 2.0, 1e-12);
+}
+
+TEST(DriveTrajectoryTest, CacheGeneratesInBackground) {
+    frc::TrajectoryCache cache;
+    cache.Generate("Path", kWaypoints, kConstraints);
+
+    EXPECT_EQ(cache.Get("Missing"), nullptr);
+    EXPECT_FALSE(cache.IsReady("Missing"));
+
+    const auto* trajectory = cache.Get("Path");
+    ASSERT_NE(trajectory, nullptr);
+    EXPECT_TRUE(cache.IsReady("Path"));
+    EXPECT_EQ(trajectory->TotalTime(),
+              frc::DriveTrajectory::Generate(kWaypoints, kConstraints)
+                  .TotalTime());
+}
+
+TEST(DriveTrajectoryTest, SaveAndLoad) {
+    const std::string path = "DriveTrajectoryTest.traj";
+
+    auto trajectory = frc::DriveTrajectory::Generate(kWaypoints, kConstraints);
+    auto hash = frc::DriveTrajectory::Hash(kWaypoints, kConstraints);
+    ASSERT_TRUE(trajectory.Save(path, hash));
+
+    {
+        auto loaded = frc::DriveTrajectory::Load(path, hash);
+        ASSERT_TRUE(loaded.has_value());
+        loaded->Prefetch();
+
+        ASSERT_EQ(loaded->GetStates().size(), trajectory.GetStates().size());
+        for (double t = 0.0; t < trajectory.TotalTime() + 0.1; t += 0.01) {
+            auto expected = trajectory.Sample(t);
+            auto actual = loaded->Sample(t);
+            EXPECT_EQ(actual.pose.x, expected.pose.x);
+            EXPECT_EQ(actual.pose.y, expected.pose.y);
+            EXPECT_EQ(actual.pose.heading, expected.pose.heading);
+            EXPECT_EQ(actual.velocity, expected.velocity);
+        }
+
+        // Changing the input invalidates the file
+        auto constraints = kConstraints;
+        constraints.maxVelocity += 1.0;
+        EXPECT_FALSE(frc::DriveTrajectory::Load(
+            path, frc::DriveTrajectory::Hash(kWaypoints, constraints)));
+        EXPECT_TRUE(frc::DriveTrajectory::Load(path).has_value());
+    }
+
+    // Truncated files are rejected
+    {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        file << "TRAJ";
+    }
+    EXPECT_FALSE(frc::DriveTrajectory::Load(path).has_value());
+    EXPECT_FALSE(frc::DriveTrajectory::Load("Missing.traj").has_value());
+
+    std::remove(path.c_str());
+}
+
+TEST(DriveTrajectoryTest, CacheLoadsOrGenerates) {
+    const std::string path = "DriveTrajectoryTestCache.traj";
+
+    auto trajectory = frc::DriveTrajectory::Generate(kWaypoints, kConstraints);
+    ASSERT_TRUE(trajectory.Save(
+        path, frc::DriveTrajectory::Hash(kWaypoints, kConstraints)));
+
+    frc::TrajectoryCache cache;
+    cache.Load("Saved", path, kWaypoints, kConstraints);
+    cache.Load("Missing", "Missing.traj", kWaypoints, kConstraints);
+
+    const auto* saved = cache.Get("Saved");
+    const auto* missing = cache.Get("Missing");
+    ASSERT_NE(saved, nullptr);
+    ASSERT_NE(missing, nullptr);
+    EXPECT_EQ(saved->TotalTime(), trajectory.TotalTime());
+    EXPECT_EQ(missing->TotalTime(), trajectory.TotalTime());
+
+    cache.Prefetch("Saved");
+
+    // The mapping outlives the file's directory entry
+    std::remove(path.c_str());
+    EXPECT_EQ(saved->Sample(1.0).pose.x, trajectory.Sample(1.0).pose.x);
+}
+
+TEST(DriveTrajectoryTest, GenerateBenchmark) {
+    constexpr int kIterations = 100;
+
+    size_t states = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        states += frc::DriveTrajectory::Generate(kWaypoints, kConstraints)
+                      .GetStates()
+                      .size();
+    }
+    auto generate = std::chrono::steady_clock::now() - start;
+
+    auto trajectory = frc::DriveTrajectory::Generate(kWaypoints, kConstraints);
+    double sum = 0.0;
+    size_t allocations = GetAllocationCount();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100000; ++i) {
+        sum += trajectory.Sample(i * 1e-5 * trajectory.TotalTime()).velocity;
+    }
+    auto sample = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(GetAllocationCount(), allocations);
+
+    double generateUs =
+        std::chrono::duration<double, std::micro>(generate).count() /
+        kIterations;
+    double sampleNs =
+        std::chrono::duration<double, std::nano>(sample).count() / 100000;
+
+    std::cout << "Generate: " << generateUs << " us for "
+              << states / kIterations << " states, sample: " << sampleNs
+              << " ns" << std::endl;
+    EXPECT_GT(sum, 0.0);
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <frc/ctrlsys/ExecutionPlan.h>
+#include <frc/ctrlsys/INode.h>
+#include <gtest/gtest.h>
+
+#include "AllocationCounter.hpp"
+#include "DrivetrainGraph.hpp"
+
+namespace {
+
+struct TickStats {
+    double mean;
+    double stddev;
+    double max;
+};
+
+template <typename F>
+TickStats Measure(F&& update) {
+    constexpr int kTicks = 100000;
+
+    std::vector<double> times;
+    times.reserve(kTicks);
+    for (int i = 0; i < kTicks; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        update();
+        auto end = std::chrono::steady_clock::now();
+        times.emplace_back(
+            std::chrono::duration<double, std::nano>(end - start).count());
+    }
+
+    TickStats stats{0.0, 0.0, 0.0};
+    for (auto time : times) {
+        stats.mean += time / kTicks;
+        stats.max = std::max(stats.max, time);
+    }
+    for (auto time : times) {
+        stats.stddev += (time - stats.mean) * (time - stats.mean) / kTicks;
+    }
+    stats.stddev = std::sqrt(stats.stddev);
+
+    return stats;
+}
+
+}  // namespace
+
+TEST(ExecutionPlanTest, IncludesEachNodeOnce) {
+    DrivetrainGraph graph;
+
+    frc::ExecutionPlan plan;
+    plan.Compile({&graph.leftMotorInput, &graph.rightMotorInput});
+
+    // 3 sensors, 2 references, 4 position and angle nodes, 2 PIDNodes with 4
+    // internal nodes each, and 2 motor inputs
+    EXPECT_EQ(plan.Size(), 21u);
+}
+
+TEST(ExecutionPlanTest, MatchesRecursiveEvaluation) {
+    DrivetrainGraph planned;
+    DrivetrainGraph recursive;
+
+    frc::ExecutionPlan plan;
+    plan.Compile({&planned.leftMotorInput, &planned.rightMotorInput});
+
+    for (int i = 0; i < 10; ++i) {
+        frc::INode::Tick tick;
+        plan.Run();
+
+        EXPECT_DOUBLE_EQ(plan.GetOutput(0),
+                         recursive.leftMotorInput.Evaluate());
+        EXPECT_DOUBLE_EQ(plan.GetOutput(1),
+                         recursive.rightMotorInput.Evaluate());
+
+        // Plan results are visible to Evaluate() for the rest of the cycle
+        EXPECT_DOUBLE_EQ(planned.leftMotorInput.Evaluate(), plan.GetOutput(0));
+    }
+
+    EXPECT_EQ(planned.leftReads, 10);
+    EXPECT_EQ(planned.gyroReads, 10);
+}
+
+TEST(ExecutionPlanTest, Benchmark) {
+    DrivetrainGraph planned;
+    DrivetrainGraph recursive;
+
+    frc::ExecutionPlan plan;
+    plan.Compile({&planned.leftMotorInput, &planned.rightMotorInput});
+
+    auto recursiveStats = Measure([&] { recursive.Update(true); });
+    auto planStats = Measure([&] {
+        frc::INode::Tick tick;
+        plan.Run();
+    });
+
+    std::cout << "Recursive: mean " << recursiveStats.mean << " ns, stddev "
+              << recursiveStats.stddev << " ns, max " << recursiveStats.max
+              << " ns\n";
+    std::cout << "Plan: mean " << planStats.mean << " ns, stddev "
+              << planStats.stddev << " ns, max " << planStats.max << " ns\n";
+
+    size_t allocations = GetAllocationCount();
+    for (int i = 0; i < 1000; ++i) {
+        frc::INode::Tick tick;
+        plan.Run();
+    }
+    EXPECT_EQ(GetAllocationCount(), allocations);
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include <frc/ctrlsys/FeedforwardNode.h>
+#include <frc/ctrlsys/PIDNode.h>
+#include <frc/ctrlsys/RefInput.h>
+#include <frc/ctrlsys/SumNode.h>
+#include <frc/ctrlsys/TrapezoidProfile.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr double kDt = 0.005;
+
+// A drivetrain side's characterization, with outputs as a fraction of 12 V
+constexpr double kKs = 0.05;
+constexpr double kKv = 0.08 / 12.0;
+constexpr double kKa = 0.03 / 12.0;
+
+/**
+ * Returns the largest position error while a PID controller with the given
+ * feedforward gains drives a side along a trapezoid profile.
+ */
+double MaxProfileError(double Ks, double Kv, double Ka) {
+    frc::TrapezoidProfile profile{120.0, 1.2};
+    profile.SetGoal(100.0);
+    profile.GetPositionNode().GetOutput();
+    double timeTotal = profile.ProfileTimeTotal();
+
+    frc::RefInput positionRef;
+    frc::RefInput velocityRef;
+    frc::RefInput accelerationRef;
+    frc::RefInput position;
+    frc::SumNode error{positionRef, true, position, false};
+    frc::FeedforwardNode feedforward{Ks, Kv, Ka, velocityRef,
+                                     accelerationRef};
+    frc::PIDNode pid{0.07, 0.0, 0.0, feedforward, error,
+                     units::second_t{kDt}};
+
+    double x = 0.0;
+    double v = 0.0;
+    double maxError = 0.0;
+    for (double t = 0.0; t < timeTotal; t += kDt) {
+        auto [r, rv, ra] = profile.Sample(t);
+        positionRef.Set(r);
+        velocityRef.Set(rv);
+        accelerationRef.Set(ra);
+        position.Set(x);
+
+        double u = pid.GetOutput();
+
+        // Static friction opposes motion, and the rest of the output beyond it
+        // accelerates the side against back-EMF
+        double net = u;
+        if (v != 0.0) {
+            net -= std::copysign(kKs, v);
+        } else {
+            net = std::copysign(std::max(std::abs(u) - kKs, 0.0), u);
+        }
+        v += (net - kKv * v) / kKa * kDt;
+        x += v * kDt;
+
+        maxError = std::max(maxError, std::abs(r - x));
+    }
+
+    return maxError;
+}
+
+}  // namespace
+
+TEST(FeedforwardNodeTest, Output) {
+    frc::RefInput velocity{10.0};
+    frc::RefInput acceleration{-4.0};
+    frc::FeedforwardNode feedforward{0.5, 0.1, 0.25, velocity, acceleration};
+
+    EXPECT_DOUBLE_EQ(feedforward.GetOutput(), 0.5 + 1.0 - 1.0);
+
+    velocity.Set(-10.0);
+    EXPECT_DOUBLE_EQ(feedforward.GetOutput(), -0.5 - 1.0 - 1.0);
+
+    feedforward.SetGains(0.0, 0.2, 0.0);
+    EXPECT_DOUBLE_EQ(feedforward.GetOutput(), -2.0);
+    EXPECT_EQ(feedforward.GetKv(), 0.2);
+}
+
+TEST(FeedforwardNodeTest, ZeroAtRest) {
+    frc::RefInput velocity{0.0};
+    frc::RefInput acceleration{0.0};
+    frc::FeedforwardNode feedforward{0.5, 0.1, 0.25, velocity, acceleration};
+
+    EXPECT_EQ(feedforward.GetOutput(), 0.0);
+}
+
+TEST(FeedforwardNodeTest, TracksProfileWithLessError) {
+    double feedbackError = MaxProfileError(0.0, 0.0, 0.0);
+    double feedforwardError = MaxProfileError(kKs, kKv, kKa);
+
+    // The gains match the model, so the PID only corrects the error from
+    // simulating it in discrete steps
+    EXPECT_LT(feedforwardError, 1.0);
+    EXPECT_LT(feedforwardError * 10.0, feedbackError);
+}
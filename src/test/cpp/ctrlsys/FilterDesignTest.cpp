@@ -0,0 +1,117 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+#include <frc/ctrlsys/FilterDesign.h>
+#include <frc/ctrlsys/LinearFilter.h>
+#include <frc/ctrlsys/RefInput.h>
+#include <gtest/gtest.h>
+#include <wpi/ArrayRef.h>
+#include <wpi/math>
+
+namespace {
+
+constexpr double kSampleRate = 200.0;
+
+// Designed at compile time
+constexpr auto kLowPass = frc::ButterworthLowPass<5>(20.0, kSampleRate);
+static_assert(kLowPass.size() == 3);
+static_assert(kLowPass[2].b2 == 0.0 && kLowPass[2].a2 == 0.0);
+
+/**
+ * Returns the magnitude of the cascade's frequency response.
+ */
+double Gain(wpi::ArrayRef<frc::SecondOrderSection> sections,
+            double frequency) {
+    auto z = std::polar(1.0, -2.0 * wpi::math::pi * frequency / kSampleRate);
+
+    std::complex<double> response = 1.0;
+    for (const auto& s : sections) {
+        response *= (s.b0 + s.b1 * z + s.b2 * z * z) /
+                    (1.0 + s.a1 * z + s.a2 * z * z);
+    }
+    return std::abs(response);
+}
+
+}  // namespace
+
+TEST(FilterDesignTest, Trigonometry) {
+    // Standard libraries differ from each other by a few ulps, which is about
+    // 1e-15 near 1.0
+    for (double x = -10.0; x <= 10.0; x += 0.01) {
+        EXPECT_NEAR(frc::detail::Sin(x), std::sin(x), 4e-15);
+        EXPECT_NEAR(frc::detail::Cos(x), std::cos(x), 4e-15);
+    }
+}
+
+TEST(FilterDesignTest, ButterworthLowPass) {
+    auto secondOrder = frc::ButterworthLowPass<2>(20.0, kSampleRate);
+    using Sections = wpi::ArrayRef<frc::SecondOrderSection>;
+
+    for (auto sections : {Sections{kLowPass}, Sections{secondOrder}}) {
+        EXPECT_NEAR(Gain(sections, 0.0), 1.0, 1e-12);
+        EXPECT_NEAR(Gain(sections, 20.0), std::sqrt(0.5), 1e-12);
+        EXPECT_NEAR(Gain(sections, kSampleRate / 2.0), 0.0, 1e-12);
+
+        // Maximally flat: the gain only falls with frequency
+        for (double f = 1.0; f < kSampleRate / 2.0; f += 1.0) {
+            EXPECT_LT(Gain(sections, f), Gain(sections, f - 1.0));
+        }
+    }
+
+    // The gain matches the analog prototype's at the prewarped frequency
+    for (double f = 0.0; f < kSampleRate / 2.0; f += 1.0) {
+        double ratio = std::tan(wpi::math::pi * f / kSampleRate) /
+                       std::tan(wpi::math::pi * 20.0 / kSampleRate);
+        double expected = 1.0 / std::sqrt(1.0 + std::pow(ratio, 10));
+        EXPECT_NEAR(Gain(kLowPass, f), expected, 1e-12);
+    }
+}
+
+TEST(FilterDesignTest, ButterworthHighPass) {
+    auto sections = frc::ButterworthHighPass<3>(5.0, kSampleRate);
+
+    EXPECT_NEAR(Gain(sections, 0.0), 0.0, 1e-12);
+    EXPECT_NEAR(Gain(sections, 5.0), std::sqrt(0.5), 1e-12);
+    EXPECT_NEAR(Gain(sections, kSampleRate / 2.0), 1.0, 1e-12);
+}
+
+TEST(FilterDesignTest, Notch) {
+    auto notch = frc::Notch(30.0, 5.0, kSampleRate);
+
+    EXPECT_NEAR(Gain(notch, 30.0), 0.0, 1e-12);
+    EXPECT_NEAR(Gain(notch, 0.0), 1.0, 1e-12);
+    EXPECT_NEAR(Gain(notch, kSampleRate / 2.0), 1.0, 1e-12);
+    EXPECT_GT(Gain(notch, 10.0), 0.95);
+}
+
+TEST(FilterDesignTest, BandPass) {
+    auto bandPass = frc::BandPass(30.0, 5.0, kSampleRate);
+
+    EXPECT_NEAR(Gain(bandPass, 30.0), 1.0, 1e-12);
+    EXPECT_NEAR(Gain(bandPass, 0.0), 0.0, 1e-12);
+    EXPECT_NEAR(Gain(bandPass, kSampleRate / 2.0), 0.0, 1e-12);
+}
+
+TEST(FilterDesignTest, FilterMatchesResponse) {
+    frc::RefInput input;
+
+    // After settling, sinusoids come out scaled by the filter's gain
+    for (double frequency : {2.0, 20.0, 50.0}) {
+        frc::LinearFilter filter{input, kLowPass};
+
+        double amplitude = 0.0;
+        for (int n = 0; n < 2000; ++n) {
+            double t = n / kSampleRate;
+            input.Set(std::sin(2.0 * wpi::math::pi * frequency * t));
+
+            double output = filter.GetOutput();
+            if (n >= 1000) {
+                amplitude = std::max(amplitude, std::abs(output));
+            }
+        }
+        EXPECT_NEAR(amplitude, Gain(kLowPass, frequency), 0.01);
+    }
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <chrono>
+#include <iostream>
+
+#include <frc/ctrlsys/INode.h>
+#include <gtest/gtest.h>
+
+#include "AllocationCounter.hpp"
+#include "DrivetrainGraph.hpp"
+
+namespace {
+
+double NsPerTick(DrivetrainGraph& graph, bool memoized) {
+    constexpr int kTicks = 100000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTicks; ++i) {
+        graph.Update(memoized);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           kTicks;
+}
+
+}  // namespace
+
+TEST(INodeTest, TickReadsEachSensorOnce) {
+    DrivetrainGraph graph;
+
+    for (int i = 0; i < 10; ++i) {
+        graph.Update(true);
+    }
+
+    EXPECT_EQ(graph.leftReads, 10);
+    EXPECT_EQ(graph.rightReads, 10);
+    EXPECT_EQ(graph.gyroReads, 10);
+}
+
+TEST(INodeTest, TickMatchesUnmemoizedOutput) {
+    DrivetrainGraph memoized;
+    DrivetrainGraph unmemoized;
+
+    // Without integral or derivative state, both modes see the same inputs
+    memoized.positionPID.SetPID(0.07, 0.0, 0.0);
+    memoized.anglePID.SetPID(0.75, 0.0, 0.0);
+    unmemoized.positionPID.SetPID(0.07, 0.0, 0.0);
+    unmemoized.anglePID.SetPID(0.75, 0.0, 0.0);
+
+    double left = unmemoized.leftMotorInput.Evaluate();
+    double right = unmemoized.rightMotorInput.Evaluate();
+
+    frc::INode::Tick tick;
+    EXPECT_DOUBLE_EQ(memoized.leftMotorInput.Evaluate(), left);
+    EXPECT_DOUBLE_EQ(memoized.rightMotorInput.Evaluate(), right);
+}
+
+TEST(INodeTest, NestedTickJoinsCycle) {
+    DrivetrainGraph graph;
+
+    frc::INode::Tick outer;
+    graph.leftMotorInput.Evaluate();
+    {
+        frc::INode::Tick inner;
+        graph.rightMotorInput.Evaluate();
+    }
+    graph.leftMotorInput.Evaluate();
+
+    EXPECT_EQ(graph.leftReads, 1);
+    EXPECT_EQ(graph.gyroReads, 1);
+}
+
+TEST(INodeTest, Benchmark) {
+    DrivetrainGraph graph;
+    graph.Update(false);
+    int unmemoizedReads = graph.leftReads + graph.rightReads + graph.gyroReads;
+
+    double unmemoizedNs = NsPerTick(graph, false);
+    size_t allocations = GetAllocationCount();
+    double memoizedNs = NsPerTick(graph, true);
+
+    std::cout << "Sensor reads per tick: " << unmemoizedReads
+              << " unmemoized, 3 memoized\n";
+    std::cout << "Time per tick: " << unmemoizedNs << " ns unmemoized, "
+              << memoizedNs << " ns memoized\n";
+
+    EXPECT_GT(unmemoizedReads, 3);
+
+    EXPECT_EQ(GetAllocationCount(), allocations);
+}
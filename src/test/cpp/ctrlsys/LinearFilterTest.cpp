@@ -0,0 +1,283 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <frc/ctrlsys/LinearFilter.h>
+#include <frc/ctrlsys/RefInput.h>
+#include <frc/ctrlsys/SecondOrderSection.h>
+#include <gtest/gtest.h>
+
+#include "AllocationCounter.hpp"
+
+namespace {
+
+/**
+ * Evaluates the filter's difference equation directly from histories of
+ * inputs and outputs, like LinearFilter used to.
+ */
+class DirectFormFilter {
+public:
+    DirectFormFilter(std::vector<double> ffGains, std::vector<double> fbGains)
+        : m_inputGains(std::move(ffGains)),
+          m_outputGains(std::move(fbGains)),
+          m_inputs(m_inputGains.size(), 0.0),
+          m_outputs(m_outputGains.size(), 0.0) {}
+
+    double Compute(double input) {
+        if (!m_inputs.empty()) {
+            m_inputIndex = (m_inputIndex + m_inputs.size() - 1) %
+                           m_inputs.size();
+            m_inputs[m_inputIndex] = input;
+        }
+
+        double output = 0.0;
+        for (size_t i = 0; i < m_inputGains.size(); ++i) {
+            output += m_inputs[(m_inputIndex + i) % m_inputs.size()] *
+                      m_inputGains[i];
+        }
+        for (size_t i = 0; i < m_outputGains.size(); ++i) {
+            output -= m_outputs[(m_outputIndex + i) % m_outputs.size()] *
+                      m_outputGains[i];
+        }
+
+        if (!m_outputs.empty()) {
+            m_outputIndex = (m_outputIndex + m_outputs.size() - 1) %
+                            m_outputs.size();
+            m_outputs[m_outputIndex] = output;
+        }
+        return output;
+    }
+
+private:
+    std::vector<double> m_inputGains;
+    std::vector<double> m_outputGains;
+    std::vector<double> m_inputs;
+    std::vector<double> m_outputs;
+    size_t m_inputIndex = 0;
+    size_t m_outputIndex = 0;
+};
+
+std::vector<double> Noise(size_t size) {
+    std::mt19937 generator{3512};
+    std::uniform_real_distribution<double> distribution{-1.0, 1.0};
+
+    std::vector<double> samples(size);
+    for (auto& sample : samples) {
+        sample = distribution(generator);
+    }
+    return samples;
+}
+
+// A stable fourth-order low-pass filter as two sections, and its transfer
+// function
+constexpr frc::SecondOrderSection kSections[] = {
+    {0.0201, 0.0402, 0.0201, -1.5610, 0.6414},
+    {1.0, 2.0, 1.0, -1.3101, 0.3151}};
+
+std::vector<double> Multiply(const std::vector<double>& lhs,
+                             const std::vector<double>& rhs) {
+    std::vector<double> product(lhs.size() + rhs.size() - 1, 0.0);
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        for (size_t j = 0; j < rhs.size(); ++j) {
+            product[i + j] += lhs[i] * rhs[j];
+        }
+    }
+    return product;
+}
+
+/**
+ * Returns the feedforward and feedback gains of kSections' product.
+ */
+std::tuple<std::vector<double>, std::vector<double>> TransferFunction() {
+    const auto& s0 = kSections[0];
+    const auto& s1 = kSections[1];
+
+    auto ffGains = Multiply({s0.b0, s0.b1, s0.b2}, {s1.b0, s1.b1, s1.b2});
+    auto fbGains = Multiply({1.0, s0.a1, s0.a2}, {1.0, s1.a1, s1.a2});
+    fbGains.erase(fbGains.begin());
+    return {ffGains, fbGains};
+}
+
+}  // namespace
+
+TEST(LinearFilterTest, TransposedMatchesDirectForm) {
+    frc::RefInput input;
+    const std::vector<double> ffGains{0.3, -0.2, 0.1, 0.05};
+    const std::vector<double> fbGains{-0.5, 0.25};
+
+    frc::LinearFilter filter{input, ffGains, fbGains};
+    DirectFormFilter reference{ffGains, fbGains};
+
+    for (double sample : Noise(1000)) {
+        input.Set(sample);
+        EXPECT_NEAR(filter.GetOutput(), reference.Compute(sample), 1e-12);
+    }
+}
+
+TEST(LinearFilterTest, SinglePoleIIR) {
+    frc::RefInput input{1.0};
+    frc::LinearFilter filter{frc::kSinglePoleIIR, input, 0.1, 0.005};
+
+    double gain = std::exp(-0.005 / 0.1);
+    double expected = 0.0;
+    for (int i = 0; i < 100; ++i) {
+        expected = (1.0 - gain) + gain * expected;
+        EXPECT_NEAR(filter.GetOutput(), expected, 1e-12);
+    }
+
+    filter.Reset();
+    EXPECT_NEAR(filter.GetOutput(), 1.0 - gain, 1e-12);
+}
+
+TEST(LinearFilterTest, MovingAverage) {
+    constexpr int kTaps = 7;
+
+    frc::RefInput input;
+    frc::LinearFilter filter{frc::kMovingAverage, input, kTaps};
+
+    auto samples = Noise(1000);
+    for (size_t n = 0; n < samples.size(); ++n) {
+        double sum = 0.0;
+        for (size_t i = 0; i < kTaps && i <= n; ++i) {
+            sum += samples[n - i];
+        }
+
+        input.Set(samples[n]);
+        EXPECT_NEAR(filter.GetOutput(), sum / kTaps, 1e-12);
+    }
+}
+
+TEST(LinearFilterTest, MovingAverageDoesntDrift) {
+    frc::RefInput input;
+    frc::LinearFilter filter{frc::kMovingAverage, input, 5};
+
+    // Samples with large offsets lose precision in a plain running sum
+    for (double sample : Noise(1000000)) {
+        input.Set(1e6 + sample * 1e3);
+        filter.GetOutput();
+    }
+    for (int i = 0; i < 5; ++i) {
+        input.Set(0.25);
+        filter.GetOutput();
+    }
+
+    input.Set(0.25);
+    EXPECT_NEAR(filter.GetOutput(), 0.25, 1e-12);
+}
+
+TEST(LinearFilterTest, SectionsMatchTransferFunction) {
+    frc::RefInput input;
+    frc::LinearFilter filter{input, kSections};
+
+    auto [ffGains, fbGains] = TransferFunction();
+    DirectFormFilter reference{ffGains, fbGains};
+
+    for (double sample : Noise(1000)) {
+        input.Set(sample);
+        EXPECT_NEAR(filter.GetOutput(), reference.Compute(sample), 1e-9);
+    }
+}
+
+TEST(LinearFilterTest, BlockMatchesSamples) {
+    frc::RefInput input;
+    auto samples = Noise(1000);
+
+    std::vector<frc::LinearFilter> filters;
+    filters.emplace_back(input, std::vector<double>{0.5, 0.3, 0.2},
+                         std::vector<double>{-0.4});
+    filters.emplace_back(frc::kMovingAverage, input, 16);
+    filters.emplace_back(input, kSections);
+
+    for (auto& filter : filters) {
+        // Filter in uneven blocks, in place
+        std::vector<double> block = samples;
+        for (size_t start = 0; start < block.size(); start += 37) {
+            size_t size = std::min<size_t>(37, block.size() - start);
+            filter.Filter(
+                wpi::ArrayRef<double>{block.data() + start, size},
+                wpi::MutableArrayRef<double>{block.data() + start, size});
+        }
+
+        filter.Reset();
+        for (size_t n = 0; n < samples.size(); ++n) {
+            EXPECT_DOUBLE_EQ(filter.Compute(&samples[n]), block[n]);
+        }
+    }
+}
+
+TEST(LinearFilterTest, Benchmark) {
+    constexpr size_t kSamples = 20000;
+
+    frc::RefInput input;
+    auto samples = Noise(kSamples);
+    std::vector<double> outputs(kSamples);
+
+    auto nsPerSample = [](auto&& func) {
+        size_t allocations = GetAllocationCount();
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        EXPECT_EQ(GetAllocationCount(), allocations);
+        return std::chrono::duration<double, std::nano>(end - start).count() /
+               kSamples;
+    };
+
+    double sum = 0.0;
+    for (int taps = 1; taps <= 256; taps *= 4) {
+        std::vector<double> gains(taps, 1.0 / taps);
+        DirectFormFilter direct{gains, {}};
+        frc::LinearFilter fir{input, gains, {}};
+        frc::LinearFilter average{frc::kMovingAverage, input, taps};
+
+        double directTime = nsPerSample([&] {
+            for (double sample : samples) {
+                sum += direct.Compute(sample);
+            }
+        });
+        double firTime = nsPerSample([&] {
+            for (double sample : samples) {
+                sum += fir.Compute(&sample);
+            }
+        });
+        double averageTime = nsPerSample([&] {
+            for (double sample : samples) {
+                sum += average.Compute(&sample);
+            }
+        });
+
+        std::cout << taps << " taps: direct form " << directTime
+                  << " ns, transposed " << firTime << " ns, running sum "
+                  << averageTime << " ns" << std::endl;
+    }
+
+    // A fourth-order IIR, as a transfer function and as sections
+    auto [ffGains, fbGains] = TransferFunction();
+    DirectFormFilter direct{ffGains, fbGains};
+    frc::LinearFilter sections{input, kSections};
+
+    double directTime = nsPerSample([&] {
+        for (double sample : samples) {
+            sum += direct.Compute(sample);
+        }
+    });
+    double sampleTime = nsPerSample([&] {
+        for (double sample : samples) {
+            sum += sections.Compute(&sample);
+        }
+    });
+    sections.Reset();
+    double blockTime = nsPerSample([&] { sections.Filter(samples, outputs); });
+
+    std::cout << "4th order IIR: direct form " << directTime
+              << " ns, sections " << sampleTime << " ns, sections in a block "
+              << blockTime << " ns" << std::endl;
+
+    EXPECT_TRUE(std::isfinite(sum + outputs.back()));
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <frc/ctrlsys/Histogram.h>
+#include <frc/ctrlsys/LoopTiming.h>
+#include <gtest/gtest.h>
+#include <units/time.h>
+
+#include "AllocationCounter.hpp"
+
+TEST(LoopTimingTest, HistogramPercentiles) {
+    frc::Histogram histogram;
+    EXPECT_EQ(histogram.GetPercentile(0.5), 0u);
+
+    for (uint64_t i = 1; i <= 100000; ++i) {
+        histogram.Record(i);
+    }
+
+    EXPECT_EQ(histogram.GetCount(), 100000u);
+    EXPECT_EQ(histogram.GetMax(), 100000u);
+    EXPECT_NEAR(histogram.GetPercentile(0.5), 50000.0, 50000.0 * 0.04);
+    EXPECT_NEAR(histogram.GetPercentile(0.99), 99000.0, 99000.0 * 0.04);
+    EXPECT_EQ(histogram.GetPercentile(1.0), 100000u);
+
+    // Small values are exact
+    frc::Histogram small;
+    for (uint64_t i = 0; i < 10; ++i) {
+        small.Record(i);
+    }
+    EXPECT_EQ(small.GetPercentile(0.5), 4u);
+
+    histogram.Reset();
+    EXPECT_EQ(histogram.GetCount(), 0u);
+}
+
+TEST(LoopTimingTest, MissedDeadlines) {
+    frc::LoopTiming timing{"Test", units::second_t{0.002}};
+
+    for (int i = 0; i < 3; ++i) {
+        frc::LoopTiming::Scope scope{timing};
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(timing.GetMissedDeadlines(), 0u);
+    EXPECT_EQ(timing.GetPeriodHistogram().GetCount(), 2u);
+    EXPECT_EQ(timing.GetExecutionTimeHistogram().GetCount(), 3u);
+
+    {
+        frc::LoopTiming::Scope scope{timing};
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(timing.GetMissedDeadlines(), 1u);
+
+    // The gap while a loop is disabled isn't a period
+    timing.Restart();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    { frc::LoopTiming::Scope scope{timing}; }
+    EXPECT_EQ(timing.GetMissedDeadlines(), 1u);
+    EXPECT_EQ(timing.GetPeriodHistogram().GetCount(), 3u);
+}
+
+TEST(LoopTimingTest, Benchmark) {
+    constexpr int kTicks = 1000000;
+    frc::LoopTiming timing{"Benchmark", units::second_t{0.005}};
+
+    size_t allocations = GetAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTicks; ++i) {
+        frc::LoopTiming::Scope scope{timing};
+    }
+    auto end = std::chrono::steady_clock::now();
+    double overheadNs =
+        std::chrono::duration<double, std::nano>(end - start).count() / kTicks;
+
+    std::cout << "Overhead per iteration: " << overheadNs << " ns\n";
+
+    EXPECT_EQ(GetAllocationCount(), allocations);
+}
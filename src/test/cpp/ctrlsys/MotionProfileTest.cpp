@@ -0,0 +1,356 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <tuple>
+
+#include <frc/ctrlsys/MotionProfile.h>
+#include <frc/ctrlsys/SCurveProfile.h>
+#include <frc/ctrlsys/TrapezoidProfile.h>
+#include <gtest/gtest.h>
+
+#include "AllocationCounter.hpp"
+
+namespace {
+
+/**
+ * The trapezoid profile as it was sampled before plans were tabulated. It
+ * branches through the phases and integrates position with Euler's method.
+ */
+class EulerTrapezoidProfile {
+public:
+    EulerTrapezoidProfile(double maxV, double timeToMaxV, double distance)
+        : m_sign(distance < 0.0 ? -1.0 : 1.0) {
+        m_acceleration = maxV / timeToMaxV;
+        m_timeToMaxVelocity = timeToMaxV;
+        double timeAtMaxV = m_sign * distance / maxV - m_timeToMaxVelocity;
+
+        if (maxV * m_timeToMaxVelocity > m_sign * distance) {
+            m_timeToMaxVelocity = std::sqrt(m_sign * distance / m_acceleration);
+            m_timeFromMaxVelocity = m_timeToMaxVelocity;
+            m_timeTotal = 2 * m_timeToMaxVelocity;
+            m_profileMaxVelocity = m_acceleration * m_timeToMaxVelocity;
+        } else {
+            m_timeFromMaxVelocity = m_timeToMaxVelocity + timeAtMaxV;
+            m_timeTotal = m_timeFromMaxVelocity + m_timeToMaxVelocity;
+            m_profileMaxVelocity = maxV;
+        }
+    }
+
+    frc::MotionProfile::State UpdateSetpoint(double currentTime) {
+        if (currentTime < m_timeToMaxVelocity) {
+            std::get<2>(m_ref) = m_acceleration;
+            std::get<1>(m_ref) = std::get<2>(m_ref) * currentTime;
+        } else if (currentTime < m_timeFromMaxVelocity) {
+            std::get<2>(m_ref) = 0.0;
+            std::get<1>(m_ref) = m_profileMaxVelocity;
+        } else if (currentTime < m_timeTotal) {
+            double decelTime = currentTime - m_timeFromMaxVelocity;
+            std::get<2>(m_ref) = -m_acceleration;
+            std::get<1>(m_ref) =
+                m_profileMaxVelocity + std::get<2>(m_ref) * decelTime;
+        } else {
+            std::get<2>(m_ref) = 0.0;
+            std::get<1>(m_ref) = 0.0;
+        }
+
+        if (currentTime < m_timeTotal) {
+            std::get<0>(m_ref) +=
+                m_sign * std::get<1>(m_ref) * (currentTime - m_lastTime);
+            m_lastTime = currentTime;
+        }
+
+        return std::make_tuple(std::get<0>(m_ref),
+                               m_sign * std::get<1>(m_ref),
+                               m_sign * std::get<2>(m_ref));
+    }
+
+    double TimeTotal() const { return m_timeTotal; }
+
+private:
+    double m_sign;
+    double m_acceleration;
+    double m_profileMaxVelocity;
+    double m_timeToMaxVelocity;
+    double m_timeFromMaxVelocity;
+    double m_timeTotal;
+
+    double m_lastTime = 0.0;
+    frc::MotionProfile::State m_ref = std::make_tuple(0.0, 0.0, 0.0);
+};
+
+/**
+ * Sets the profile's goal and plans it.
+ */
+void Plan(frc::MotionProfile& profile, double goal) {
+    profile.SetGoal(goal);
+    profile.GetPositionNode().GetOutput();
+}
+
+/**
+ * Checks that the profile is continuous, consistent, and within its limits,
+ * and that it ends exactly at the goal.
+ */
+void ExpectWellFormed(frc::MotionProfile& profile, double goal, double maxV,
+                      double maxA, double goalVelocity = 0.0) {
+    constexpr double kDt = 1e-4;
+
+    double timeTotal = profile.ProfileTimeTotal();
+    auto last = profile.Sample(0.0);
+    maxV = std::max(maxV, std::abs(std::get<1>(last)));
+    maxA = std::max(maxA, std::abs(std::get<2>(last)));
+    for (double t = kDt; t < timeTotal; t += kDt) {
+        auto ref = profile.Sample(t);
+        double position = std::get<0>(ref);
+        double velocity = std::get<1>(ref);
+        double acceleration = std::get<2>(ref);
+
+        EXPECT_LE(std::abs(velocity), maxV + 1e-9) << "at t = " << t;
+        EXPECT_LE(std::abs(acceleration), maxA + 1e-9) << "at t = " << t;
+
+        // Position must be the integral of velocity, and velocity the integral
+        // of acceleration
+        EXPECT_NEAR(position - std::get<0>(last),
+                    0.5 * (velocity + std::get<1>(last)) * kDt, 1e-6)
+            << "at t = " << t;
+        EXPECT_LE(std::abs(velocity - std::get<1>(last)), maxA * kDt + 1e-9)
+            << "at t = " << t;
+
+        last = ref;
+    }
+
+    // The reference doesn't jump to the goal at the end
+    auto end = profile.Sample(timeTotal - 1e-9);
+    EXPECT_NEAR(std::get<0>(end), goal, 1e-6);
+    EXPECT_NEAR(std::get<1>(end), goalVelocity, 1e-6);
+    EXPECT_EQ(profile.Sample(timeTotal + 1.0), std::make_tuple(goal, 0.0, 0.0));
+}
+
+}  // namespace
+
+TEST(MotionProfileTest, TrapezoidMatchesEulerIntegration) {
+    constexpr double kDt = 1e-5;
+
+    for (double goal : {10.0, -10.0, 0.5}) {
+        frc::TrapezoidProfile profile{4.0, 1.0};
+        Plan(profile, goal);
+        EulerTrapezoidProfile reference{4.0, 1.0, goal};
+
+        EXPECT_DOUBLE_EQ(profile.ProfileTimeTotal(), reference.TimeTotal());
+
+        for (int i = 1; i * kDt < reference.TimeTotal() + 0.5; ++i) {
+            double t = i * kDt;
+            auto expected = reference.UpdateSetpoint(t);
+            auto actual = profile.Sample(t);
+
+            // Euler integration is off by at most v * dt per phase boundary
+            EXPECT_NEAR(std::get<0>(actual), std::get<0>(expected), 1e-4)
+                << "at t = " << t;
+            EXPECT_NEAR(std::get<1>(actual), std::get<1>(expected), 1e-9)
+                << "at t = " << t;
+            EXPECT_EQ(std::get<2>(actual), std::get<2>(expected))
+                << "at t = " << t;
+        }
+
+        EXPECT_EQ(std::get<0>(profile.Sample(reference.TimeTotal())), goal);
+    }
+}
+
+TEST(MotionProfileTest, TrapezoidWellFormed) {
+    for (double goal : {10.0, -10.0, 0.5}) {
+        frc::TrapezoidProfile profile{4.0, 1.0};
+        Plan(profile, goal);
+        ExpectWellFormed(profile, goal, 4.0, 4.0);
+    }
+}
+
+TEST(MotionProfileTest, SCurveWellFormed) {
+    // Cruises at max velocity, reaches max acceleration but not max velocity,
+    // and reaches neither
+    for (double goal : {10.0, -10.0, 1.5, -0.05}) {
+        frc::SCurveProfile profile{4.0, 4.0, 0.25};
+        Plan(profile, goal);
+        ExpectWellFormed(profile, goal, 4.0, 4.0);
+    }
+}
+
+TEST(MotionProfileTest, SCurveTimeTotal) {
+    frc::SCurveProfile profile{4.0, 4.0, 0.25};
+    Plan(profile, 10.0);
+
+    // Accelerating takes v / a + timeToMaxA, and the remaining distance is
+    // covered at max velocity
+    EXPECT_NEAR(profile.ProfileTimeTotal(), 10.0 / 4.0 + 1.0 + 0.25, 1e-12);
+}
+
+TEST(MotionProfileTest, TrapezoidStartAndGoalVelocity) {
+    for (double goal : {10.0, -3.0, 0.2, 0.0}) {
+        for (double startVelocity : {-3.0, 0.0, 2.0, 6.0}) {
+            for (double goalVelocity : {0.0, 2.0, -1.0}) {
+                SCOPED_TRACE(testing::Message()
+                             << "goal = " << goal << ", v0 = " << startVelocity
+                             << ", vf = " << goalVelocity);
+
+                if (goal == 0.0 && startVelocity == goalVelocity) {
+                    // Already at the goal state, so there's nothing to plan
+                    continue;
+                }
+
+                frc::TrapezoidProfile profile{4.0, 1.0};
+                auto start = std::make_tuple(0.0, startVelocity, 0.0);
+                profile.SetGoal(goal, goalVelocity, start);
+                profile.GetPositionNode().GetOutput();
+
+                auto ref = profile.Sample(0.0);
+                EXPECT_EQ(std::get<0>(ref), 0.0);
+                EXPECT_EQ(std::get<1>(ref), startVelocity);
+                ExpectWellFormed(profile, goal, 4.0, 4.0, goalVelocity);
+            }
+        }
+    }
+}
+
+TEST(MotionProfileTest, SCurveStartAndGoalState) {
+    for (double goal : {10.0, -3.0, 0.2, 0.0}) {
+        for (double startVelocity : {-3.0, 0.0, 2.0, 6.0}) {
+            for (double startAcceleration : {0.0, 3.0, -2.0}) {
+                for (double goalVelocity : {0.0, 2.0, -1.0}) {
+                    SCOPED_TRACE(testing::Message()
+                                 << "goal = " << goal
+                                 << ", v0 = " << startVelocity
+                                 << ", a0 = " << startAcceleration
+                                 << ", vf = " << goalVelocity);
+
+                    if (goal == 0.0 && startVelocity == goalVelocity &&
+                        startAcceleration == 0.0) {
+                        continue;
+                    }
+
+                    frc::SCurveProfile profile{4.0, 4.0, 0.25};
+                    auto start =
+                        std::make_tuple(0.0, startVelocity, startAcceleration);
+                    profile.SetGoal(goal, goalVelocity, start);
+                    profile.GetPositionNode().GetOutput();
+
+                    // Bringing the start acceleration to zero at max jerk can
+                    // exceed max velocity
+                    double maxV = std::max(
+                        4.0, std::abs(startVelocity +
+                                      0.5 * startAcceleration *
+                                          std::abs(startAcceleration) / 16.0));
+
+                    EXPECT_EQ(profile.Sample(0.0), start);
+                    ExpectWellFormed(profile, goal, maxV, 4.0, goalVelocity);
+                }
+            }
+        }
+    }
+}
+
+TEST(MotionProfileTest, SCurveStartAboveMaxVelocity) {
+    // Changing directly to the goal velocity falls short of the goal, but
+    // cruising at max velocity overshoots it
+    for (double goal : {5.5, 6.0, -6.0}) {
+        frc::SCurveProfile profile{4.0, 4.0, 0.25};
+        double startVelocity = std::copysign(6.0, goal);
+        profile.SetGoal(goal, 0.0, std::make_tuple(0.0, startVelocity, 0.0));
+        profile.GetPositionNode().GetOutput();
+
+        ExpectWellFormed(profile, goal, 6.0, 4.0);
+
+        // The profile slows down to max velocity as quickly as it can, which
+        // takes dv / a + timeToMaxA
+        EXPECT_LE(std::abs(std::get<1>(profile.Sample(2.0 / 4.0 + 0.25))),
+                  4.0 + 1e-9);
+    }
+}
+
+TEST(MotionProfileTest, BlendedGoalsDontStop) {
+    frc::TrapezoidProfile whole{4.0, 1.0};
+    Plan(whole, 10.0);
+
+    // Driving halfway without stopping, then the rest of the way, takes as
+    // long as driving the whole way at once
+    frc::TrapezoidProfile first{4.0, 1.0};
+    first.SetGoal(5.0, 4.0, std::make_tuple(0.0, 0.0, 0.0));
+    first.GetPositionNode().GetOutput();
+
+    frc::TrapezoidProfile second{4.0, 1.0};
+    second.SetGoal(10.0, 0.0, std::make_tuple(5.0, 4.0, 0.0));
+    second.GetPositionNode().GetOutput();
+
+    EXPECT_NEAR(first.ProfileTimeTotal() + second.ProfileTimeTotal(),
+                whole.ProfileTimeTotal(), 1e-12);
+
+    // Stopping in between takes a second longer
+    Plan(first, 5.0);
+    EXPECT_NEAR(2 * first.ProfileTimeTotal(), whole.ProfileTimeTotal() + 1.0,
+                1e-12);
+}
+
+TEST(MotionProfileTest, ReplanIsContinuous) {
+    // Start the first plan already moving so the reference changes quickly
+    // without waiting for the profile to get up to speed
+    frc::SCurveProfile profile{4.0, 4.0, 0.25};
+    auto start = std::make_tuple(0.0, 3.0, 0.0);
+    profile.SetGoal(10.0, 0.0, start);
+    profile.GetPositionNode().GetOutput();
+
+    profile.Replan(-2.0);
+
+    // The new plan starts from the old one's reference when Replan() was
+    // called, which is at most a few milliseconds after the first plan started
+    profile.GetPositionNode().GetOutput();
+    auto ref = profile.Sample(0.0);
+    EXPECT_NEAR(std::get<0>(ref), 0.0, 0.01);
+    EXPECT_NEAR(std::get<1>(ref), 3.0, 0.01);
+    ExpectWellFormed(profile, -2.0, 4.0, 4.0);
+}
+
+TEST(MotionProfileTest, SampleOutOfOrder) {
+    frc::SCurveProfile profile{4.0, 4.0, 0.25};
+    Plan(profile, 10.0);
+
+    auto late = profile.Sample(3.0);
+    auto early = profile.Sample(0.5);
+    EXPECT_EQ(profile.Sample(3.0), late);
+    EXPECT_EQ(profile.Sample(0.5), early);
+    EXPECT_EQ(profile.Sample(-1.0), std::make_tuple(0.0, 0.0, 0.0));
+}
+
+TEST(MotionProfileTest, SampleBenchmark) {
+    constexpr int kSamples = 1000000;
+    constexpr double kDt = 1e-6;
+
+    frc::TrapezoidProfile profile{4.0, 1.0};
+    Plan(profile, 10.0);
+    EulerTrapezoidProfile reference{4.0, 1.0, 10.0};
+
+    double tableSum = 0.0;
+    size_t allocations = GetAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kSamples; ++i) {
+        tableSum += std::get<0>(profile.Sample(i * kDt * 3.5));
+    }
+    auto table = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(GetAllocationCount(), allocations);
+
+    double eulerSum = 0.0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kSamples; ++i) {
+        eulerSum += std::get<0>(reference.UpdateSetpoint(i * kDt * 3.5));
+    }
+    auto euler = std::chrono::steady_clock::now() - start;
+
+    double tableNs =
+        std::chrono::duration<double, std::nano>(table).count() / kSamples;
+    double eulerNs =
+        std::chrono::duration<double, std::nano>(euler).count() / kSamples;
+
+    std::cout << "table: " << tableNs << " ns/sample, euler: " << eulerNs
+              << " ns/sample" << std::endl;
+
+    EXPECT_NEAR(tableSum / kSamples, eulerSum / kSamples, 1e-3);
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <frc/ctrlsys/PIDBank.h>
+#include <frc/ctrlsys/PIDNode.h>
+#include <frc/ctrlsys/RefInput.h>
+#include <gtest/gtest.h>
+
+#include "AllocationCounter.hpp"
+
+namespace {
+
+/**
+ * N PIDNodes with the same configuration as a PIDBank for comparison.
+ */
+struct NodeControllers {
+    std::vector<std::unique_ptr<frc::RefInput>> inputs;
+    std::vector<std::unique_ptr<frc::PIDNode>> pids;
+
+    explicit NodeControllers(const frc::PIDBank& bank) {
+        for (size_t i = 0; i < bank.Size(); ++i) {
+            inputs.emplace_back(std::make_unique<frc::RefInput>(0.0));
+            pids.emplace_back(std::make_unique<frc::PIDNode>(
+                bank.GetP(i), bank.GetI(i), bank.GetD(i), *inputs.back()));
+        }
+    }
+
+    void Update(const std::vector<double>& in, std::vector<double>& out) {
+        for (size_t i = 0; i < pids.size(); ++i) {
+            inputs[i]->Set(in[i]);
+            frc::INode::Tick tick;
+            out[i] = pids[i]->GetOutput();
+        }
+    }
+};
+
+void Configure(frc::PIDBank& bank) {
+    for (size_t i = 0; i < bank.Size(); ++i) {
+        bank.SetPID(i, 0.1 + 0.01 * i, 0.5 + 0.1 * i, 0.02 * i);
+    }
+}
+
+}  // namespace
+
+TEST(PIDBankTest, MatchesPIDNode) {
+    frc::PIDBank bank{5};
+    Configure(bank);
+
+    // The integral saturates at the same magnitude with a negative gain
+    bank.SetPID(4, 0.1, -0.5, 0.02);
+    NodeControllers nodes{bank};
+
+    bank.SetOutputRange(1, -0.5, 0.25);
+    nodes.pids[1]->SetOutputRange(-0.5, 0.25);
+
+    // Output range bounds may be given in either order
+    bank.SetOutputRange(0, 0.3, -0.3);
+    nodes.pids[0]->SetOutputRange(-0.3, 0.3);
+    bank.SetOutputRange(3, -0.4, 0.4);
+    nodes.pids[3]->SetOutputRange(0.4, -0.4);
+    bank.SetIZone(2, 1.0);
+    nodes.pids[2]->SetIZone(1.0);
+
+    std::vector<double> in(bank.Size());
+    std::vector<double> bankOut(bank.Size());
+    std::vector<double> nodeOut(bank.Size());
+
+    for (int t = 0; t < 500; ++t) {
+        for (size_t i = 0; i < in.size(); ++i) {
+            in[i] = 2.0 * std::sin(0.01 * t * (i + 1));
+        }
+
+        if (t == 250) {
+            bank.Reset(3);
+            nodes.pids[3]->Reset();
+        }
+
+        bank.Update(in, bankOut);
+        nodes.Update(in, nodeOut);
+
+        for (size_t i = 0; i < in.size(); ++i) {
+            EXPECT_NEAR(bankOut[i], nodeOut[i], 1e-12)
+                << "controller " << i << " at iteration " << t;
+        }
+    }
+}
+
+TEST(PIDBankTest, Benchmark) {
+    constexpr int kTicks = 2000;
+
+    for (size_t size = 2; size <= 1024; size *= 2) {
+        frc::PIDBank bank{size};
+        Configure(bank);
+        NodeControllers nodes{bank};
+
+        std::vector<double> in(size, 0.5);
+        std::vector<double> out(size);
+
+        size_t allocations = GetAllocationCount();
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < kTicks; ++t) {
+            bank.Update(in, out);
+        }
+        auto mid = std::chrono::steady_clock::now();
+        EXPECT_EQ(GetAllocationCount(), allocations) << "N = " << size;
+
+        for (int t = 0; t < kTicks; ++t) {
+            nodes.Update(in, out);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double bankNs =
+            std::chrono::duration<double, std::nano>(mid - start).count() /
+            kTicks;
+        double nodeNs =
+            std::chrono::duration<double, std::nano>(end - mid).count() /
+            kTicks;
+
+        std::cout << "N = " << size << ": " << bankNs << " ns PIDBank, "
+                  << nodeNs << " ns PIDNode per tick\n";
+    }
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#include <frc/ctrlsys/DriveOdometry.h>
+#include <frc/ctrlsys/Pose.h>
+#include <frc/ctrlsys/PoseHistory.h>
+#include <gtest/gtest.h>
+#include <wpi/math>
+
+#include "AllocationCounter.hpp"
+
+namespace {
+
+constexpr double kPi = wpi::math::pi;
+
+}  // namespace
+
+TEST(PoseHistoryTest, Interpolates) {
+    frc::PoseHistory history{10};
+    EXPECT_FALSE(history.Sample(0.0).has_value());
+
+    history.Add(1.0, frc::Pose{0.0, 0.0, 0.0});
+    history.Add(2.0, frc::Pose{10.0, -4.0, 1.0});
+
+    auto pose = history.Sample(1.25);
+    ASSERT_TRUE(pose.has_value());
+    EXPECT_DOUBLE_EQ(pose->x, 2.5);
+    EXPECT_DOUBLE_EQ(pose->y, -1.0);
+    EXPECT_DOUBLE_EQ(pose->heading, 0.25);
+
+    // Newer times return the newest pose and older times return nothing
+    EXPECT_DOUBLE_EQ(history.Sample(5.0)->x, 10.0);
+    EXPECT_FALSE(history.Sample(0.5).has_value());
+
+    // Out of order poses are ignored
+    history.Add(1.5, frc::Pose{100.0, 100.0, 0.0});
+    EXPECT_DOUBLE_EQ(history.Sample(1.5)->x, 5.0);
+}
+
+TEST(PoseHistoryTest, InterpolatesHeadingAcrossWrap) {
+    frc::PoseHistory history{10};
+    history.Add(0.0, frc::Pose{0.0, 0.0, kPi - 0.1});
+    history.Add(1.0, frc::Pose{0.0, 0.0, -kPi + 0.1});
+
+    EXPECT_NEAR(history.Sample(0.5)->heading, kPi, 1e-12);
+}
+
+TEST(PoseHistoryTest, KeepsNewestPoses) {
+    constexpr size_t kCapacity = 50;
+
+    frc::PoseHistory history{kCapacity};
+    for (int i = 0; i < 1000; ++i) {
+        history.Add(i * 0.01, frc::Pose{static_cast<double>(i), 0.0, 0.0});
+    }
+
+    // The oldest pose kept is 1000 - kCapacity
+    EXPECT_FALSE(history.Sample((999 - kCapacity) * 0.01).has_value());
+    EXPECT_DOUBLE_EQ(history.Sample((1000 - kCapacity) * 0.01)->x,
+                     1000 - kCapacity);
+    for (int i = 1000 - kCapacity; i < 999; ++i) {
+        EXPECT_NEAR(history.Sample((i + 0.5) * 0.01)->x, i + 0.5, 1e-9);
+    }
+
+    history.Clear();
+    EXPECT_FALSE(history.Sample(9.99).has_value());
+
+    history.Add(10.0, frc::Pose{-1.0, 0.0, 0.0});
+    EXPECT_DOUBLE_EQ(history.Sample(10.0)->x, -1.0);
+}
+
+TEST(PoseHistoryTest, ReadersNeverSeeReplacedPoses) {
+    constexpr size_t kCapacity = 16;
+
+    frc::PoseHistory history{kCapacity};
+    std::atomic<int> added{0};
+    std::atomic<bool> done{false};
+
+    // Each pose's x is its timestamp, so every interpolated sample's x is the
+    // time sampled
+    std::thread writer{[&] {
+        for (int i = 0; i < 200000; ++i) {
+            history.Add(i, frc::Pose{static_cast<double>(i), 0.0, 0.0});
+            added = i + 1;
+        }
+        done = true;
+    }};
+
+    int wrong = 0;
+    int found = 0;
+    do {
+        // Sample in the older half, whose poses are replaced soonest
+        double time = added - static_cast<double>(kCapacity / 2) + 0.5;
+        auto pose = history.Sample(time);
+        if (pose) {
+            ++found;
+            // Past the newest pose, the sample is the newest pose instead
+            bool newest = pose->x < time && pose->x == std::floor(pose->x);
+            if (pose->x != time && !newest) {
+                ++wrong;
+            }
+        }
+    } while (!done);
+    writer.join();
+
+    // The writer can finish before the reader's first sample
+    if (history.Sample(199990.5)) {
+        ++found;
+    }
+
+    EXPECT_EQ(wrong, 0);
+    EXPECT_GT(found, 0);
+}
+
+TEST(PoseHistoryTest, OdometryLooksUpPastPoses) {
+    frc::DriveOdometry odometry{100};
+    odometry.Reset(frc::Pose{0.0, 0.0, 0.0}, 0.0, 0.0, 0.0);
+
+    // Drive straight at 100 units per second
+    for (int i = 1; i <= 100; ++i) {
+        odometry.Update(i * 0.5, i * 0.5, 0.0, i * 0.005);
+    }
+    EXPECT_NEAR(odometry.GetPose().x, 50.0, 1e-9);
+    EXPECT_NEAR(odometry.GetPose(0.3)->x, 30.0, 1e-9);
+    EXPECT_NEAR(odometry.GetPose(0.1234)->x, 12.34, 1e-9);
+
+    // Resetting the sensors doesn't move the pose
+    odometry.ResetSensors(0.0, 0.0, 1.0);
+    odometry.Update(1.0, 1.0, 1.0, 0.505);
+    EXPECT_NEAR(odometry.GetPose().x, 51.0, 1e-9);
+    EXPECT_NEAR(odometry.GetPose().heading, 0.0, 1e-12);
+
+    // Resetting the pose starts a new history
+    odometry.Reset(frc::Pose{5.0, 5.0, 0.0}, 1.0, 1.0, 1.0);
+    EXPECT_FALSE(odometry.GetPose(0.3).has_value());
+}
+
+TEST(PoseHistoryTest, SampleBenchmark) {
+    constexpr size_t kCapacity = 200;
+    constexpr int kIterations = 100000;
+
+    frc::PoseHistory history{kCapacity};
+    for (size_t i = 0; i < kCapacity; ++i) {
+        history.Add(i * 0.005, frc::Pose{static_cast<double>(i), 0.0, 0.0});
+    }
+
+    double sum = 0.0;
+    size_t allocations = GetAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        sum += history.Sample((i % 997) * 0.001)->x;
+    }
+    auto end = std::chrono::steady_clock::now();
+    double sampleNs =
+        std::chrono::duration<double, std::nano>(end - start).count() /
+        kIterations;
+
+    std::cout << "Sample: " << sampleNs << " ns with " << kCapacity
+              << " poses" << std::endl;
+    EXPECT_GT(sum, 0.0);
+
+    EXPECT_EQ(GetAllocationCount(), allocations);
+}
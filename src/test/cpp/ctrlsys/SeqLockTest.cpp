@@ -0,0 +1,53 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <atomic>
+#include <thread>
+
+#include <frc/ctrlsys/SeqLock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+struct Pair {
+    double first;
+    double second;
+};
+
+}  // namespace
+
+TEST(SeqLockTest, StoreLoad) {
+    frc::SeqLock<Pair> lock{Pair{1.0, 2.0}};
+
+    auto value = lock.Load();
+    EXPECT_EQ(value.first, 1.0);
+    EXPECT_EQ(value.second, 2.0);
+
+    lock.Store(Pair{3.0, 4.0});
+
+    value = lock.Load();
+    EXPECT_EQ(value.first, 3.0);
+    EXPECT_EQ(value.second, 4.0);
+}
+
+TEST(SeqLockTest, ReadersNeverSeeTornValues) {
+    frc::SeqLock<Pair> lock{Pair{0.0, 0.0}};
+    std::atomic<bool> done{false};
+
+    std::thread writer{[&] {
+        for (int i = 1; i <= 100000; ++i) {
+            lock.Store(Pair{static_cast<double>(i), static_cast<double>(-i)});
+        }
+        done = true;
+    }};
+
+    int torn = 0;
+    while (!done) {
+        auto value = lock.Load();
+        if (value.first != -value.second) {
+            ++torn;
+        }
+    }
+    writer.join();
+
+    EXPECT_EQ(torn, 0);
+}
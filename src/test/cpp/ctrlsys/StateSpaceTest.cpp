@@ -0,0 +1,210 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include <frc/ctrlsys/LQR.h>
+#include <frc/ctrlsys/Matrix.h>
+#include <gtest/gtest.h>
+
+#include "AllocationCounter.hpp"
+
+namespace {
+
+constexpr double kDt = 0.005;
+
+/**
+ * A drivetrain's continuous model, with each side's position and velocity as
+ * the state and each side's voltage as the input.
+ */
+void DrivetrainModel(frc::Matrix<4, 4>* A, frc::Matrix<4, 2>* B) {
+    constexpr double kVLinear = 0.08;
+    constexpr double kALinear = 0.03;
+    constexpr double kVAngular = 0.09;
+    constexpr double kAAngular = 0.04;
+
+    double a1 = 0.5 * (-kVLinear / kALinear - kVAngular / kAAngular);
+    double a2 = 0.5 * (-kVLinear / kALinear + kVAngular / kAAngular);
+    double b1 = 0.5 * (1.0 / kALinear + 1.0 / kAAngular);
+    double b2 = 0.5 * (1.0 / kALinear - 1.0 / kAAngular);
+
+    *A = frc::Matrix<4, 4>{{{{0.0, 1.0, 0.0, 0.0},
+                             {0.0, a1, 0.0, a2},
+                             {0.0, 0.0, 0.0, 1.0},
+                             {0.0, a2, 0.0, a1}}}};
+    *B = frc::Matrix<4, 2>{{{{0.0, 0.0}, {b1, b2}, {0.0, 0.0}, {b2, b1}}}};
+}
+
+}  // namespace
+
+TEST(StateSpaceTest, Inverse) {
+    // Needs a row swap for the first pivot
+    frc::Matrix<3, 3> M{
+        {{{0.0, 2.0, 1.0}, {3.0, -1.0, 0.5}, {1.0, 4.0, -2.0}}}};
+
+    auto product = M * M.Inverse();
+    EXPECT_LT((product - frc::Matrix<3, 3>::Identity()).MaxAbs(), 1e-12);
+}
+
+TEST(StateSpaceTest, DiscretizeDoubleIntegrator) {
+    frc::Matrix<2, 2> contA{{{{0.0, 1.0}, {0.0, 0.0}}}};
+    frc::Matrix<2, 1> contB{{{{0.0}, {1.0}}}};
+
+    frc::Matrix<2, 2> discA;
+    frc::Matrix<2, 1> discB;
+    frc::DiscretizeAB(contA, contB, 0.1, &discA, &discB);
+
+    EXPECT_NEAR(discA(0, 0), 1.0, 1e-12);
+    EXPECT_NEAR(discA(0, 1), 0.1, 1e-12);
+    EXPECT_NEAR(discA(1, 1), 1.0, 1e-12);
+    EXPECT_NEAR(discB(0, 0), 0.005, 1e-12);
+    EXPECT_NEAR(discB(1, 0), 0.1, 1e-12);
+}
+
+TEST(StateSpaceTest, DiscretizeDecay) {
+    frc::Matrix<1, 1> contA{{{{-3.0}}}};
+    frc::Matrix<1, 1> contB{{{{2.0}}}};
+
+    frc::Matrix<1, 1> discA;
+    frc::Matrix<1, 1> discB;
+    frc::DiscretizeAB(contA, contB, 0.7, &discA, &discB);
+
+    EXPECT_NEAR(discA(0, 0), std::exp(-2.1), 1e-12);
+    EXPECT_NEAR(discB(0, 0), 2.0 / 3.0 * (1.0 - std::exp(-2.1)), 1e-12);
+}
+
+TEST(StateSpaceTest, LQRMatchesRiccatiIteration) {
+    frc::Matrix<4, 4> contA;
+    frc::Matrix<4, 2> contB;
+    DrivetrainModel(&contA, &contB);
+
+    frc::Matrix<4, 4> A;
+    frc::Matrix<4, 2> B;
+    frc::DiscretizeAB(contA, contB, kDt, &A, &B);
+
+    auto Q = frc::MakeCostMatrix<4>({1.5, 20.0, 1.5, 20.0});
+    auto R = frc::MakeCostMatrix<2>({12.0, 12.0});
+    auto K = frc::LQR(A, B, Q, R);
+
+    // Iterate the Riccati equation to its fixed point
+    auto P = Q;
+    for (int i = 0; i < 100000; ++i) {
+        auto BtP = B.Transpose() * P;
+        P = Q + A.Transpose() * P * A -
+            A.Transpose() * P * B * (R + BtP * B).Inverse() * BtP * A;
+    }
+    auto BtP = B.Transpose() * P;
+    auto expected = (R + BtP * B).Inverse() * BtP * A;
+
+    EXPECT_LT((K - expected).MaxAbs(), 1e-6 * expected.MaxAbs());
+}
+
+TEST(StateSpaceTest, TracksProfileWithFeedforward) {
+    frc::Matrix<4, 4> contA;
+    frc::Matrix<4, 2> contB;
+    DrivetrainModel(&contA, &contB);
+
+    frc::Matrix<4, 4> A;
+    frc::Matrix<4, 2> B;
+    frc::DiscretizeAB(contA, contB, kDt, &A, &B);
+
+    auto K = frc::LQR(A, B, frc::MakeCostMatrix<4>({1.5, 20.0, 1.5, 20.0}),
+                      frc::MakeCostMatrix<2>({12.0, 12.0}));
+    auto Kff = frc::PlantInversion(B);
+
+    // The reference is the model's response to sinusoidal voltages, so it's
+    // feasible
+    frc::Vector<4> r;
+    frc::Vector<4> x;
+    double maxError = 0.0;
+    double maxFeedback = 0.0;
+    for (int k = 0; k < 1000; ++k) {
+        double t = k * kDt;
+        frc::Vector<2> input{{{{8.0 * std::sin(2.0 * t)},
+                               {6.0 * std::sin(3.0 * t)}}}};
+        frc::Vector<4> next = A * r + B * input;
+
+        auto feedback = K * (r - x);
+        frc::Vector<2> u = feedback + Kff * (next - A * r);
+        x = A * x + B * u;
+        r = next;
+
+        maxError = std::max(maxError, (r - x).MaxAbs());
+        maxFeedback = std::max(maxFeedback, feedback.MaxAbs());
+    }
+
+    // The model is exact, so feedforward does all the work
+    EXPECT_LT(maxError, 1e-6);
+    EXPECT_LT(maxFeedback, 1e-6);
+}
+
+TEST(StateSpaceTest, RegulatesStepWithinTolerance) {
+    frc::Matrix<4, 4> contA;
+    frc::Matrix<4, 2> contB;
+    DrivetrainModel(&contA, &contB);
+
+    frc::Matrix<4, 4> A;
+    frc::Matrix<4, 2> B;
+    frc::DiscretizeAB(contA, contB, kDt, &A, &B);
+
+    auto K = frc::LQR(A, B, frc::MakeCostMatrix<4>({1.5, 20.0, 1.5, 20.0}),
+                      frc::MakeCostMatrix<2>({12.0, 12.0}));
+
+    // Drive 60 in forward while turning, limited to 9 V like the robot
+    frc::Vector<4> r{{{{70.0}, {0.0}, {50.0}, {0.0}}}};
+    frc::Vector<4> x;
+    for (int k = 0; k < 600; ++k) {
+        frc::Vector<2> u = K * (r - x);
+        for (int i = 0; i < 2; ++i) {
+            u(i, 0) = std::clamp(u(i, 0), -9.0, 9.0);
+        }
+        x = A * x + B * u;
+    }
+
+    EXPECT_NEAR(x(0, 0), 70.0, 0.1);
+    EXPECT_NEAR(x(2, 0), 50.0, 0.1);
+    EXPECT_NEAR(x(1, 0), 0.0, 0.1);
+    EXPECT_NEAR(x(3, 0), 0.0, 0.1);
+}
+
+TEST(StateSpaceTest, UpdateBenchmark) {
+    constexpr int kIterations = 1000000;
+
+    frc::Matrix<4, 4> contA;
+    frc::Matrix<4, 2> contB;
+    DrivetrainModel(&contA, &contB);
+
+    frc::Matrix<4, 4> A;
+    frc::Matrix<4, 2> B;
+
+    auto start = std::chrono::steady_clock::now();
+    frc::DiscretizeAB(contA, contB, kDt, &A, &B);
+    auto K = frc::LQR(A, B, frc::MakeCostMatrix<4>({1.5, 20.0, 1.5, 20.0}),
+                      frc::MakeCostMatrix<2>({12.0, 12.0}));
+    auto Kff = frc::PlantInversion(B);
+    auto design = std::chrono::steady_clock::now() - start;
+
+    // One controller update per iteration, as in StateSpaceDriveController
+    frc::Vector<4> r{{{{1.0}, {2.0}, {3.0}, {4.0}}}};
+    frc::Vector<4> x;
+    double sum = 0.0;
+    size_t allocations = GetAllocationCount();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        x(0, 0) = i * 1e-6;
+        frc::Vector<2> u = K * (r - x) + Kff * (r - A * x);
+        sum += u(0, 0);
+    }
+    auto update = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(GetAllocationCount(), allocations);
+
+    double designUs = std::chrono::duration<double, std::micro>(design).count();
+    double updateNs =
+        std::chrono::duration<double, std::nano>(update).count() / kIterations;
+
+    std::cout << "Design: " << designUs << " us, update: " << updateNs << " ns"
+              << std::endl;
+    EXPECT_TRUE(std::isfinite(sum));
+}
@@ -0,0 +1,144 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <chrono>
+#include <iostream>
+
+#include <frc/ctrlsys/INode.h>
+#include <frc/ctrlsys/StaticGraph.h>
+#include <gtest/gtest.h>
+
+#include "AllocationCounter.hpp"
+#include "DrivetrainGraph.hpp"
+
+namespace {
+
+using namespace frc::ctrlsys;
+
+double LeftEncoder() { return 1.0; }
+double RightEncoder() { return 2.0; }
+double AngleSensor() { return 3.0; }
+
+/**
+ * DrivetrainGraph with its graph type fixed at compile time.
+ */
+struct StaticDrivetrainGraph {
+    Ref positionRef{10.0};
+    Ref angleRef{5.0};
+
+    Func<double (*)()> leftEncoder{LeftEncoder};
+    Func<double (*)()> rightEncoder{RightEncoder};
+    Func<double (*)()> angleSensor{AngleSensor};
+
+    Sum<Add<decltype(leftEncoder)>, Add<decltype(rightEncoder)>> encoderSum{
+        Add{leftEncoder}, Add{rightEncoder}};
+    Gain<decltype(encoderSum)> positionCalc{0.5, encoderSum};
+    Sum<Add<Ref>, Subtract<decltype(positionCalc)>> positionError{
+        Add{positionRef}, Subtract{positionCalc}};
+    PID<decltype(positionError)> positionPID{0.07, 0.01, 0.08, positionError};
+
+    Sum<Add<Ref>, Subtract<decltype(angleSensor)>> angleError{
+        Add{angleRef}, Subtract{angleSensor}};
+    PID<decltype(angleError)> anglePID{0.75, 0.01, 0.05, angleError};
+
+    double left = 0.0;
+    double right = 0.0;
+
+    void Update() {
+        double position = positionPID.GetOutput();
+        double angle = anglePID.GetOutput();
+
+        left = position + angle;
+        right = position - angle;
+    }
+};
+
+template <typename F>
+double NsPerTick(F&& update) {
+    constexpr int kTicks = 100000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTicks; ++i) {
+        update();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           kTicks;
+}
+
+}  // namespace
+
+TEST(StaticGraphTest, MatchesDynamicGraph) {
+    DrivetrainGraph dynamicGraph;
+    StaticDrivetrainGraph staticGraph;
+
+    for (int i = 0; i < 10; ++i) {
+        frc::INode::Tick tick;
+        staticGraph.Update();
+
+        EXPECT_DOUBLE_EQ(staticGraph.left,
+                         dynamicGraph.leftMotorInput.Evaluate());
+        EXPECT_DOUBLE_EQ(staticGraph.right,
+                         dynamicGraph.rightMotorInput.Evaluate());
+    }
+
+    EXPECT_EQ(staticGraph.positionError.InTolerance(),
+              dynamicGraph.positionError.InTolerance());
+}
+
+TEST(StaticGraphTest, NodeAdapter) {
+    Ref ref{2.0};
+    Gain gain{3.0, ref};
+    NodeAdapter adapter{gain};
+
+    frc::INode& node = adapter;
+    EXPECT_DOUBLE_EQ(node.GetOutput(), 6.0);
+}
+
+TEST(StaticGraphTest, NegativeIntegralGain) {
+    Ref error{1.0};
+    Integral integral{-2.0, error};
+
+    // The total saturates at 1 / |K| so the output saturates at -1
+    double output = 0.0;
+    for (int i = 0; i < 100; ++i) {
+        output = integral.GetOutput();
+    }
+    EXPECT_DOUBLE_EQ(output, -1.0);
+}
+
+TEST(StaticGraphTest, InvertedOutputRange) {
+    Ref error{10.0};
+    PID pid{1.0, 0.0, 0.0, error};
+    pid.SetOutputRange(0.5, -0.5);
+
+    EXPECT_DOUBLE_EQ(pid.GetOutput(), 0.5);
+    error.Set(-10.0);
+    EXPECT_DOUBLE_EQ(pid.GetOutput(), -0.5);
+}
+
+TEST(StaticGraphTest, Feedforward) {
+    Ref feedforward{0.25};
+    Ref error{0.5};
+    PID pid{0.5, 0.0, 0.0, feedforward, error};
+
+    EXPECT_DOUBLE_EQ(pid.GetOutput(), 0.5);
+
+    // The feedforward is added before the output range is applied
+    feedforward.Set(2.0);
+    EXPECT_DOUBLE_EQ(pid.GetOutput(), 1.0);
+}
+
+TEST(StaticGraphTest, Benchmark) {
+    DrivetrainGraph dynamicGraph;
+    StaticDrivetrainGraph staticGraph;
+
+    double dynamicNs = NsPerTick([&] { dynamicGraph.Update(true); });
+    size_t allocations = GetAllocationCount();
+    double staticNs = NsPerTick([&] { staticGraph.Update(); });
+
+    std::cout << "Time per tick: " << dynamicNs << " ns INode, " << staticNs
+              << " ns static\n";
+
+    EXPECT_EQ(GetAllocationCount(), allocations);
+}
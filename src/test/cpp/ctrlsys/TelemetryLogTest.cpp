@@ -0,0 +1,174 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <stdint.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <frc/ctrlsys/TelemetryLog.h>
+#include <gtest/gtest.h>
+
+#include "AllocationCounter.hpp"
+
+namespace {
+
+std::string TempPath(const std::string& name) {
+    return frc::TelemetryLog::NextPath(::testing::TempDir() + name);
+}
+
+std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::ifstream file{path, std::ios::binary};
+    return std::vector<uint8_t>{std::istreambuf_iterator<char>{file},
+                                std::istreambuf_iterator<char>{}};
+}
+
+template <typename T>
+T ReadAt(const std::vector<uint8_t>& data, size_t offset) {
+    T value;
+    std::memcpy(&value, &data[offset], sizeof(value));
+    return value;
+}
+
+}  // namespace
+
+TEST(TelemetryLogTest, WritesSchemaAndRecords) {
+    constexpr int kRecords = 1000;
+
+    std::string path = TempPath("telemetry");
+    {
+        frc::TelemetryLog log{path, {"ref", "error"}};
+        EXPECT_EQ(log.GetRecordSize(), 16u);
+        for (int i = 0; i < kRecords; ++i) {
+            EXPECT_TRUE(log.Log(i * 0.005, {i * 1.0, -i * 0.5}));
+        }
+    }
+
+    auto data = ReadFile(path);
+    std::remove(path.c_str());
+
+    constexpr size_t kHeaderSize = 16 + sizeof("ref") + sizeof("error");
+    ASSERT_EQ(data.size(), kHeaderSize + kRecords * 16u);
+    EXPECT_EQ(std::memcmp(data.data(), "TLOG", 4), 0);
+    EXPECT_EQ(ReadAt<uint32_t>(data, 4), frc::TelemetryLog::kVersion);
+    EXPECT_EQ(ReadAt<uint32_t>(data, 8), 2u);
+    EXPECT_EQ(ReadAt<uint32_t>(data, 12), 16u);
+    EXPECT_STREQ(reinterpret_cast<const char*>(&data[16]), "ref");
+    EXPECT_STREQ(reinterpret_cast<const char*>(&data[20]), "error");
+
+    for (int i = 0; i < kRecords; ++i) {
+        size_t offset = kHeaderSize + i * 16;
+        EXPECT_EQ(ReadAt<double>(data, offset), i * 0.005);
+        EXPECT_EQ(ReadAt<float>(data, offset + 8), i * 1.0f);
+        EXPECT_EQ(ReadAt<float>(data, offset + 12), -i * 0.5f);
+    }
+}
+
+TEST(TelemetryLogTest, DropsRecordsWhenFull) {
+    std::string path = TempPath("telemetry");
+    {
+        // The bandwidth limit is too low for anything to be drained until the
+        // log is destroyed
+        frc::TelemetryLog log{path, {"value"}, 4, 1.0};
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_EQ(log.Log(i, {i * 1.0}), i < 4);
+        }
+        EXPECT_EQ(log.GetDroppedCount(), 6u);
+
+        // Mismatched records are rejected without being counted as dropped
+        EXPECT_FALSE(log.Log(10.0, {1.0, 2.0}));
+        EXPECT_EQ(log.GetDroppedCount(), 6u);
+    }
+
+    auto data = ReadFile(path);
+    std::remove(path.c_str());
+
+    constexpr size_t kHeaderSize = 16 + sizeof("value");
+    ASSERT_EQ(data.size(), kHeaderSize + 4 * 12u);
+    EXPECT_EQ(ReadAt<double>(data, kHeaderSize + 3 * 12), 3.0);
+}
+
+TEST(TelemetryLogTest, LimitsWriteBandwidth) {
+    std::string path = TempPath("telemetry");
+    {
+        // 20 records per second
+        frc::TelemetryLog log{path, {"a", "b", "c"}, 1000, 20.0 * 20.0};
+        for (int i = 0; i < 1000; ++i) {
+            log.Log(i, {1.0, 2.0, 3.0});
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(550));
+        EXPECT_GT(log.GetWrittenCount(), 0u);
+        EXPECT_LE(log.GetWrittenCount(), 12u);
+        EXPECT_EQ(log.GetDroppedCount(), 0u);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(TelemetryLogTest, RotatesLogFiles) {
+    constexpr int kMaxFiles = 3;
+
+    std::string prefix = ::testing::TempDir() + "rotation";
+    auto makePath = [&](int i) {
+        return prefix + "-" + std::to_string(i) + ".tlog";
+    };
+    auto exists = [](const std::string& path) {
+        return static_cast<bool>(std::ifstream{path});
+    };
+    for (int i = 0; i < kMaxFiles; ++i) {
+        std::remove(makePath(i).c_str());
+    }
+
+    for (int boot = 0; boot < 2 * kMaxFiles; ++boot) {
+        std::string path = frc::TelemetryLog::NextPath(prefix, kMaxFiles);
+        EXPECT_EQ(path, makePath(boot % kMaxFiles));
+        std::ofstream{path};
+
+        // The next file in the rotation is deleted so it's used next boot
+        EXPECT_FALSE(exists(makePath((boot + 1) % kMaxFiles)));
+    }
+
+    // Only the newest kMaxFiles - 1 logs are kept
+    int count = 0;
+    for (int i = 0; i < kMaxFiles; ++i) {
+        if (exists(makePath(i))) {
+            ++count;
+        }
+        std::remove(makePath(i).c_str());
+    }
+    EXPECT_EQ(count, kMaxFiles - 1);
+}
+
+TEST(TelemetryLogTest, LogBenchmark) {
+    constexpr int kIterations = 100000;
+
+    std::string path = TempPath("telemetry");
+    {
+        frc::TelemetryLog log{path, std::vector<std::string>(20, "field"),
+                              kIterations};
+
+        std::vector<double> values(20, 1.0);
+        size_t allocations = GetAllocationCount();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kIterations; ++i) {
+            values[0] = i;
+            log.Log(i, values);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        double logNs =
+            std::chrono::duration<double, std::nano>(elapsed).count() /
+            kIterations;
+
+        std::cout << "Log: " << logNs << " ns" << std::endl;
+        EXPECT_EQ(log.GetDroppedCount(), 0u);
+
+        EXPECT_EQ(GetAllocationCount(), allocations);
+    }
+    std::remove(path.c_str());
+}
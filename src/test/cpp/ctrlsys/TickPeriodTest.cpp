@@ -0,0 +1,86 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include <cmath>
+#include <vector>
+
+#include <frc/ctrlsys/FuncNode.h>
+#include <frc/ctrlsys/INode.h>
+#include <frc/ctrlsys/PIDNode.h>
+#include <frc/ctrlsys/RefInput.h>
+#include <frc/ctrlsys/SumNode.h>
+#include <gtest/gtest.h>
+#include <units/time.h>
+
+namespace {
+
+/**
+ * Simulates a PID controller driving a plant whose velocity is the control
+ * input, and returns its position sampled every 0.5 s after the step.
+ *
+ * The reference steps from 0 to 1 at t = 0.5 s. The controller is constructed
+ * with the default period regardless of the loop rate.
+ *
+ * @param period   the simulated loop period in seconds
+ * @param measured whether the controller uses the measured period
+ */
+std::vector<double> StepResponse(double period, bool measured) {
+    double position = 0.0;
+
+    frc::RefInput reference{0.0};
+    frc::FuncNode sensor{[&] { return position; }};
+    frc::SumNode error{reference, true, sensor, false};
+    frc::PIDNode pid{1.0, 0.5, 0.05, error};
+    pid.SetOutputRange(-1000.0, 1000.0);
+    pid.UseMeasuredPeriod(measured);
+
+    std::vector<double> samples;
+    int ticksPerSample = static_cast<int>(std::round(0.5 / period));
+    for (int i = 1; i <= 8 * ticksPerSample; ++i) {
+        double time = i * period;
+        if (i == ticksPerSample) {
+            reference.Set(1.0);
+        }
+
+        if (i > ticksPerSample && i % ticksPerSample == 0) {
+            samples.emplace_back(position);
+        }
+
+        double u;
+        {
+            frc::INode::Tick tick{units::second_t{time}};
+            u = pid.Evaluate();
+        }
+        position += u * period;
+    }
+
+    return samples;
+}
+
+}  // namespace
+
+TEST(TickPeriodTest, StepResponseIndependentOfLoopRate) {
+    auto slow = StepResponse(0.05, true);
+    auto medium = StepResponse(0.01, true);
+    auto fast = StepResponse(0.005, true);
+
+    ASSERT_EQ(slow.size(), fast.size());
+    // The responses differ only by the discretization error of the plant and
+    // controller, which shrinks with the period
+    for (size_t i = 0; i < slow.size(); ++i) {
+        EXPECT_NEAR(slow[i], fast[i], 0.03) << "at t = " << 0.5 * (i + 2);
+        EXPECT_NEAR(medium[i], fast[i], 0.005) << "at t = " << 0.5 * (i + 2);
+    }
+}
+
+TEST(TickPeriodTest, NominalPeriodDependsOnLoopRate) {
+    auto slow = StepResponse(0.05, false);
+    auto fast = StepResponse(0.005, false);
+
+    // With the nominal period, the integral and derivative terms are scaled
+    // wrong at 200 Hz, so the responses diverge
+    double maxDifference = 0.0;
+    for (size_t i = 0; i < slow.size(); ++i) {
+        maxDifference = std::max(maxDifference, std::abs(slow[i] - fast[i]));
+    }
+    EXPECT_GT(maxDifference, 0.2);
+}
@@ -0,0 +1,14 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+
+/**
+ * Returns the number of times the calling thread has called global operator
+ * new.
+ *
+ * The test binary replaces operator new to count calls, so tests can check
+ * that code meant to run every control cycle doesn't allocate.
+ */
+size_t GetAllocationCount();
@@ -0,0 +1,57 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <frc/ctrlsys/FuncNode.h>
+#include <frc/ctrlsys/GainNode.h>
+#include <frc/ctrlsys/INode.h>
+#include <frc/ctrlsys/PIDNode.h>
+#include <frc/ctrlsys/RefInput.h>
+#include <frc/ctrlsys/SumNode.h>
+
+/**
+ * Same node layout as DiffDriveController with sensors that count reads.
+ */
+struct DrivetrainGraph {
+    int leftReads = 0;
+    int rightReads = 0;
+    int gyroReads = 0;
+
+    frc::RefInput positionRef{10.0};
+    frc::RefInput angleRef{5.0};
+
+    frc::FuncNode leftEncoder{[this] {
+        ++leftReads;
+        return 1.0;
+    }};
+    frc::FuncNode rightEncoder{[this] {
+        ++rightReads;
+        return 2.0;
+    }};
+    frc::FuncNode angleSensor{[this] {
+        ++gyroReads;
+        return 3.0;
+    }};
+
+    frc::SumNode encoderSum{leftEncoder, true, rightEncoder, true};
+    frc::GainNode positionCalc{0.5, encoderSum};
+    frc::SumNode positionError{positionRef, true, positionCalc, false};
+    frc::PIDNode positionPID{0.07, 0.01, 0.08, positionError};
+
+    frc::SumNode angleError{angleRef, true, angleSensor, false};
+    frc::PIDNode anglePID{0.75, 0.01, 0.05, angleError};
+
+    frc::SumNode leftMotorInput{positionPID, true, anglePID, true};
+    frc::SumNode rightMotorInput{positionPID, true, anglePID, false};
+
+    void Update(bool memoized) {
+        if (memoized) {
+            frc::INode::Tick tick;
+            leftMotorInput.Evaluate();
+            rightMotorInput.Evaluate();
+        } else {
+            leftMotorInput.Evaluate();
+            rightMotorInput.Evaluate();
+        }
+    }
+};
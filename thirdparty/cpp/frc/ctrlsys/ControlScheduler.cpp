@@ -0,0 +1,218 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/ControlScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <frc2/Timer.h>
+
+#include "frc/DriverStation.h"
+
+using namespace frc;
+
+namespace {
+
+double Now() { return frc2::Timer::GetFPGATimestamp().to<double>(); }
+
+}  // namespace
+
+/**
+ * Returns the scheduler shared by all control loops.
+ */
+ControlScheduler& ControlScheduler::GetInstance() {
+    static ControlScheduler instance;
+    return instance;
+}
+
+ControlScheduler::ControlScheduler()
+    : m_notifier(kPriority, [this] { Run(); }) {}
+
+/**
+ * Runs a task periodically.
+ *
+ * If the owner already has a task, it's replaced as if by Unschedule(). The
+ * first release is immediate.
+ *
+ * @param owner  the object the task belongs to; used as its key
+ * @param task   the function to call
+ * @param period the time between calls
+ */
+void ControlScheduler::Schedule(const void* owner, std::function<void()> task,
+                                units::second_t period) {
+    std::unique_lock lock{m_mutex};
+
+    uint64_t overruns = Remove(owner, lock);
+
+    double now = Now();
+    m_tasks.emplace_back(std::make_unique<Task>(
+        Task{owner, std::move(task), period.to<double>(), now, overruns}));
+
+    RescheduleAlarm(now);
+}
+
+/**
+ * Stops running the owner's task.
+ *
+ * If the task is running on another thread, this blocks until it returns, so
+ * it won't be called again after this returns. If a task unschedules itself,
+ * its current call finishes normally. Does nothing if the owner has no task.
+ *
+ * @param owner the object passed to Schedule()
+ */
+void ControlScheduler::Unschedule(const void* owner) {
+    std::unique_lock lock{m_mutex};
+
+    Remove(owner, lock);
+
+    RescheduleAlarm(Now());
+}
+
+/**
+ * Returns the number of times the owner's task has missed its deadline.
+ *
+ * @param owner the object passed to Schedule()
+ */
+uint64_t ControlScheduler::GetOverrunCount(const void* owner) const {
+    std::scoped_lock lock{m_mutex};
+
+    for (auto& task : m_tasks) {
+        if (task->owner == owner && !task->removed) {
+            return task->overruns;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Runs every released task in deadline order, then sleeps until the next
+ * release.
+ */
+void ControlScheduler::Run() {
+    std::unique_lock lock{m_mutex};
+    m_threadId = std::this_thread::get_id();
+
+    double now = Now();
+    while (true) {
+        // Pick the released task with the earliest deadline. A task's deadline
+        // is its next release, so shorter periods win ties.
+        Task* next = nullptr;
+        for (auto& task : m_tasks) {
+            if (!task->removed && task->release <= now &&
+                (next == nullptr || task->release + task->period <
+                                        next->release + next->period)) {
+                next = task.get();
+            }
+        }
+        if (next == nullptr) {
+            break;
+        }
+
+        m_running = next;
+        lock.unlock();
+        next->func();
+        lock.lock();
+        m_running = nullptr;
+        m_taskDone.notify_all();
+
+        now = Now();
+
+        if (next->removed) {
+            m_tasks.erase(
+                std::find_if(m_tasks.begin(), m_tasks.end(),
+                             [&](auto& t) { return t.get() == next; }));
+            continue;
+        }
+
+        next->release += next->period;
+        if (now > next->release) {
+            ++next->overruns;
+
+            // Skip the missed releases so the task doesn't run back-to-back
+            while (next->release < now) {
+                next->release += next->period;
+            }
+
+            if (now - m_lastWarningTime >= 1.0) {
+                m_lastWarningTime = now;
+                DriverStation::ReportWarning(
+                    "Control loop overran its " +
+                    std::to_string(next->period * 1000.0) + " ms period (" +
+                    std::to_string(next->overruns) + " overruns)");
+            }
+        }
+    }
+
+    RescheduleAlarm(now);
+}
+
+/**
+ * Removes the owner's task and returns its overrun count, or 0 if it has none.
+ *
+ * If the task is running on another thread, this waits for it to return. If
+ * it's running on this thread (it or another task is unscheduling it), it's
+ * marked removed instead and Run() erases it after it returns.
+ *
+ * @param owner the object passed to Schedule()
+ * @param lock  the held lock on m_mutex
+ */
+uint64_t ControlScheduler::Remove(const void* owner,
+                                  std::unique_lock<wpi::mutex>& lock) {
+    auto find = [&] {
+        return std::find_if(m_tasks.begin(), m_tasks.end(), [&](auto& t) {
+            return t->owner == owner && !t->removed;
+        });
+    };
+
+    auto it = find();
+    if (it == m_tasks.end()) {
+        return 0;
+    }
+
+    if (it->get() == m_running) {
+        if (std::this_thread::get_id() == m_threadId) {
+            (*it)->removed = true;
+            return (*it)->overruns;
+        }
+
+        const Task* task = it->get();
+        m_taskDone.wait(lock, [&] { return m_running != task; });
+
+        // The task list may have changed while waiting
+        it = find();
+        if (it == m_tasks.end()) {
+            return 0;
+        }
+    }
+
+    uint64_t overruns = (*it)->overruns;
+    m_tasks.erase(it);
+    return overruns;
+}
+
+/**
+ * Sets the notifier alarm for the earliest release, or stops it if there are
+ * no tasks.
+ *
+ * m_mutex must be held.
+ */
+void ControlScheduler::RescheduleAlarm(double now) {
+    double release = std::numeric_limits<double>::infinity();
+    for (auto& task : m_tasks) {
+        if (!task->removed) {
+            release = std::min(release, task->release);
+        }
+    }
+
+    if (std::isinf(release)) {
+        m_notifier.Stop();
+        return;
+    }
+
+    m_notifier.StartSingle(units::second_t{std::max(release - now, 0.0)});
+}
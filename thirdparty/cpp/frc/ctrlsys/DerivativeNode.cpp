@@ -12,19 +12,24 @@ using namespace frc;
  * @param period the loop time for doing calculations.
  */
 DerivativeNode::DerivativeNode(double K, INode& input, units::second_t period)
-    : NodeBase(input) {
-    m_gain = K;
-    m_period = period;
-}
+    : NodeBase(input), m_gain(K), m_period(period) {}
 
 double DerivativeNode::GetOutput() {
     double input = NodeBase::GetOutput();
+    return Compute(&input);
+}
+
+double DerivativeNode::Compute(const double* inputs) {
+    double period = m_period.Update();
 
-    std::scoped_lock lock(m_mutex);
+    if (m_resetRequested.exchange(false, std::memory_order_relaxed)) {
+        m_prevInput = 0.0;
+    }
 
-    double output = m_gain * (input - m_prevInput) / m_period.to<double>();
+    double output = m_gain.load(std::memory_order_relaxed) *
+                    (inputs[0] - m_prevInput) / period;
 
-    m_prevInput = input;
+    m_prevInput = inputs[0];
 
     return output;
 }
@@ -35,22 +40,31 @@ double DerivativeNode::GetOutput() {
  * @param K a gain to apply
  */
 void DerivativeNode::SetGain(double K) {
-    std::scoped_lock lock(m_mutex);
-    m_gain = K;
+    m_gain.store(K, std::memory_order_relaxed);
 }
 
 /**
  * Return gain applied to node output.
  */
 double DerivativeNode::GetGain() const {
-    std::scoped_lock lock(m_mutex);
-    return m_gain;
+    return m_gain.load(std::memory_order_relaxed);
+}
+
+/**
+ * Selects whether to use the measured time between control cycles instead of
+ * the nominal period passed to the constructor.
+ *
+ * @param measured true to use the measured period
+ */
+void DerivativeNode::UseMeasuredPeriod(bool measured) {
+    m_period.SetMeasured(measured);
 }
 
 /**
  * Clears derivative state.
+ *
+ * The previous input is cleared on the next call to GetOutput().
  */
 void DerivativeNode::Reset() {
-    std::scoped_lock lock(m_mutex);
-    m_prevInput = 0.0;
+    m_resetRequested.store(true, std::memory_order_relaxed);
 }
@@ -0,0 +1,119 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/DriveOdometry.h"
+
+#include <cmath>
+
+#include <wpi/math>
+
+using namespace frc;
+
+/**
+ * Constructs a DriveOdometry.
+ *
+ * @param historySize the number of timestamped poses to keep
+ */
+DriveOdometry::DriveOdometry(size_t historySize) : m_history(historySize) {}
+
+/**
+ * Sets the robot's pose.
+ *
+ * The pose history is cleared, since the poses in it no longer share the new
+ * pose's frame.
+ *
+ * This must be called from the thread calling Update().
+ *
+ * @param pose          the robot's pose
+ * @param leftDistance  the left encoder's current distance
+ * @param rightDistance the right encoder's current distance
+ * @param heading       the heading sensor's current counterclockwise angle in
+ *                      radians
+ */
+void DriveOdometry::Reset(const Pose& pose, double leftDistance,
+                          double rightDistance, double heading) {
+    m_pose = pose;
+    m_lastLeft = leftDistance;
+    m_lastRight = rightDistance;
+    m_headingOffset = pose.heading - heading;
+
+    m_history.Clear();
+    m_published.Store(m_pose);
+}
+
+/**
+ * Takes new sensor readings as the current ones without moving the pose, such
+ * as after the encoders or heading sensor are reset.
+ *
+ * @param leftDistance  the left encoder's current distance
+ * @param rightDistance the right encoder's current distance
+ * @param heading       the heading sensor's current counterclockwise angle in
+ *                      radians
+ */
+void DriveOdometry::ResetSensors(double leftDistance, double rightDistance,
+                                 double heading) {
+    m_lastLeft = leftDistance;
+    m_lastRight = rightDistance;
+    m_headingOffset = m_pose.heading - heading;
+}
+
+/**
+ * Integrates the distance driven since the last update and returns the new
+ * pose.
+ *
+ * @param leftDistance  the left encoder's distance
+ * @param rightDistance the right encoder's distance
+ * @param heading       the heading sensor's counterclockwise angle in radians
+ */
+Pose DriveOdometry::Update(double leftDistance, double rightDistance,
+                           double heading) {
+    double distance =
+        0.5 * ((leftDistance - m_lastLeft) + (rightDistance - m_lastRight));
+    m_lastLeft = leftDistance;
+    m_lastRight = rightDistance;
+
+    // Drive along the average of the old and new headings, which is the
+    // direction of the chord if the robot drove an arc
+    double newHeading = heading + m_headingOffset;
+    double turn = std::remainder(newHeading - m_pose.heading,
+                                 2.0 * wpi::math::pi);
+    double midHeading = m_pose.heading + 0.5 * turn;
+
+    m_pose.x += distance * std::cos(midHeading);
+    m_pose.y += distance * std::sin(midHeading);
+    m_pose.heading = newHeading;
+
+    m_published.Store(m_pose);
+    return m_pose;
+}
+
+/**
+ * Integrates the distance driven since the last update, records the new pose
+ * in the history, and returns it.
+ *
+ * @param leftDistance  the left encoder's distance
+ * @param rightDistance the right encoder's distance
+ * @param heading       the heading sensor's counterclockwise angle in radians
+ * @param timestamp     the time in seconds at which the sensors were read
+ */
+Pose DriveOdometry::Update(double leftDistance, double rightDistance,
+                           double heading, double timestamp) {
+    auto pose = Update(leftDistance, rightDistance, heading);
+    m_history.Add(timestamp, pose);
+    return pose;
+}
+
+/**
+ * Returns the pose as of the last update.
+ */
+Pose DriveOdometry::GetPose() const { return m_published.Load(); }
+
+/**
+ * Returns the pose at a past time, interpolated from the history.
+ *
+ * Returns nothing if the time is older than the history.
+ *
+ * @param timestamp the time in seconds
+ */
+std::optional<Pose> DriveOdometry::GetPose(double timestamp) const {
+    return m_history.Sample(timestamp);
+}
@@ -0,0 +1,248 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/DriveStateEstimator.h"
+
+#include <cmath>
+
+using namespace frc;
+
+namespace {
+
+// Velocities from encoder distances whose innovation exceeds this many
+// standard deviations are rejected
+constexpr double kMaxInnovation = 5.0;
+
+}  // namespace
+
+/**
+ * Constructs a DriveStateEstimator.
+ *
+ * The estimator starts at rest at the origin. Distances and rates can be in
+ * any unit, as long as it's the same for all of them and the track width.
+ *
+ * @param leftDistance  left encoder distance
+ * @param rightDistance right encoder distance
+ * @param leftRate      left encoder rate
+ * @param rightRate     right encoder rate
+ * @param gyroRate      gyro rate in counterclockwise radians per second
+ * @param trackWidth    distance between the wheels
+ * @param stdDevs       standard deviations of the process and measurement
+ *                      noise
+ * @param period        the loop time for doing calculations
+ */
+DriveStateEstimator::DriveStateEstimator(INode& leftDistance,
+                                         INode& rightDistance, INode& leftRate,
+                                         INode& rightRate, INode& gyroRate,
+                                         double trackWidth,
+                                         const StandardDeviations& stdDevs,
+                                         units::second_t period)
+    : m_leftDistance(leftDistance),
+      m_rightDistance(rightDistance),
+      m_leftRate(leftRate),
+      m_rightRate(rightRate),
+      m_gyroRate(gyroRate),
+      m_stdDevs(stdDevs),
+      m_period(period) {
+    // Each side's velocity is the forward velocity plus or minus the angular
+    // velocity times half the track width
+    m_leftRow[kVelocity] = 1.0;
+    m_leftRow[kAngularVelocity] = -0.5 * trackWidth;
+    m_rightRow[kVelocity] = 1.0;
+    m_rightRow[kAngularVelocity] = 0.5 * trackWidth;
+    m_angularRow[kAngularVelocity] = 1.0;
+
+    m_published.Store(Estimate{Pose{}, 0.0, 0.0, 0.0, m_P});
+}
+
+/**
+ * Returns a node whose output is the estimated distance driven since the last
+ * reset.
+ */
+INode& DriveStateEstimator::GetDistanceNode() { return m_distanceNode; }
+
+/**
+ * Returns a node whose output is the estimated counterclockwise heading in
+ * radians.
+ */
+INode& DriveStateEstimator::GetHeadingNode() { return m_headingNode; }
+
+/**
+ * Returns a node whose output is the estimated forward velocity.
+ */
+INode& DriveStateEstimator::GetVelocityNode() { return m_velocityNode; }
+
+/**
+ * Returns a node whose output is the estimated counterclockwise angular
+ * velocity in radians per second.
+ */
+INode& DriveStateEstimator::GetAngularVelocityNode() {
+    return m_angularVelocityNode;
+}
+
+/**
+ * Selects whether to use the measured time between control cycles instead of
+ * the nominal period passed to the constructor.
+ *
+ * @param measured true to use the measured period
+ */
+void DriveStateEstimator::UseMeasuredPeriod(bool measured) {
+    m_period.SetMeasured(measured);
+}
+
+/**
+ * Sets the pose and zeroes the distance driven on the next update.
+ *
+ * The pose is then known exactly. The velocities are kept, so this can be
+ * called while the robot is moving.
+ *
+ * @param pose the robot's pose
+ */
+void DriveStateEstimator::Reset(const Pose& pose) {
+    m_reset.Store(ResetRequest{pose, ++m_resetCount});
+}
+
+/**
+ * Returns the estimate as of the last update.
+ */
+DriveStateEstimator::Estimate DriveStateEstimator::GetEstimate() const {
+    return m_published.Load();
+}
+
+void DriveStateEstimator::Update() {
+    double dt = m_period.Update();
+
+    auto reset = m_reset.Load();
+    if (reset.generation != m_generation) {
+        m_generation = reset.generation;
+
+        m_x[kX] = reset.pose.x;
+        m_x[kY] = reset.pose.y;
+        m_x[kHeading] = reset.pose.heading;
+        m_x[kDistance] = 0.0;
+        for (int i = 0; i < kStates; ++i) {
+            for (int j = 0; j < kStates; ++j) {
+                if (i < kVelocity || j < kVelocity) {
+                    m_P[i][j] = 0.0;
+                }
+            }
+        }
+    }
+
+    Predict(dt);
+
+    double left = m_leftDistance.Evaluate();
+    double right = m_rightDistance.Evaluate();
+    if (m_hasDistances && dt > 0.0) {
+        Correct(m_leftRow, (left - m_lastLeft) / dt, m_stdDevs.encoderVelocity,
+                true);
+        Correct(m_rightRow, (right - m_lastRight) / dt,
+                m_stdDevs.encoderVelocity, true);
+    }
+    m_lastLeft = left;
+    m_lastRight = right;
+    m_hasDistances = true;
+
+    Correct(m_leftRow, m_leftRate.Evaluate(), m_stdDevs.encoderRate);
+    Correct(m_rightRow, m_rightRate.Evaluate(), m_stdDevs.encoderRate);
+    Correct(m_angularRow, m_gyroRate.Evaluate(), m_stdDevs.gyroRate);
+
+    m_published.Store(Estimate{Pose{m_x[kX], m_x[kY], m_x[kHeading]},
+                               m_x[kDistance], m_x[kVelocity],
+                               m_x[kAngularVelocity], m_P});
+}
+
+/**
+ * Advances the state by one cycle assuming constant velocities, and
+ * propagates the covariance through the linearized motion.
+ */
+void DriveStateEstimator::Predict(double dt) {
+    double heading = m_x[kHeading];
+    double velocity = m_x[kVelocity];
+    double cosHeading = std::cos(heading);
+    double sinHeading = std::sin(heading);
+
+    m_x[kX] += velocity * cosHeading * dt;
+    m_x[kY] += velocity * sinHeading * dt;
+    m_x[kHeading] += m_x[kAngularVelocity] * dt;
+    m_x[kDistance] += velocity * dt;
+
+    // Jacobian of the motion with respect to the previous state
+    Matrix F{};
+    for (int i = 0; i < kStates; ++i) {
+        F[i][i] = 1.0;
+    }
+    F[kX][kHeading] = -velocity * sinHeading * dt;
+    F[kX][kVelocity] = cosHeading * dt;
+    F[kY][kHeading] = velocity * cosHeading * dt;
+    F[kY][kVelocity] = sinHeading * dt;
+    F[kHeading][kAngularVelocity] = dt;
+    F[kDistance][kVelocity] = dt;
+
+    // P = F P F^T + Q
+    Matrix FP{};
+    for (int i = 0; i < kStates; ++i) {
+        for (int k = 0; k < kStates; ++k) {
+            if (F[i][k] != 0.0) {
+                for (int j = 0; j < kStates; ++j) {
+                    FP[i][j] += F[i][k] * m_P[k][j];
+                }
+            }
+        }
+    }
+    for (int i = 0; i < kStates; ++i) {
+        for (int j = 0; j < kStates; ++j) {
+            double sum = 0.0;
+            for (int k = 0; k < kStates; ++k) {
+                sum += FP[i][k] * F[j][k];
+            }
+            m_P[i][j] = sum;
+        }
+    }
+
+    m_P[kVelocity][kVelocity] +=
+        m_stdDevs.acceleration * m_stdDevs.acceleration * dt;
+    m_P[kAngularVelocity][kAngularVelocity] +=
+        m_stdDevs.angularAcceleration * m_stdDevs.angularAcceleration * dt;
+}
+
+/**
+ * Corrects the state with one scalar measurement.
+ *
+ * @param row         the measurement's row of the measurement matrix
+ * @param measurement the measured value
+ * @param stdDev      the measurement noise's standard deviation
+ * @param gate        true to reject the measurement if it's implausible
+ */
+void DriveStateEstimator::Correct(const Vector& row, double measurement,
+                                  double stdDev, bool gate) {
+    Vector PHt{};
+    double predicted = 0.0;
+    for (int i = 0; i < kStates; ++i) {
+        for (int j = 0; j < kStates; ++j) {
+            PHt[i] += m_P[i][j] * row[j];
+        }
+        predicted += row[i] * m_x[i];
+    }
+
+    double innovationVariance = stdDev * stdDev;
+    for (int i = 0; i < kStates; ++i) {
+        innovationVariance += row[i] * PHt[i];
+    }
+
+    double innovation = measurement - predicted;
+    if (!std::isfinite(innovation) ||
+        (gate && innovation * innovation >
+                     kMaxInnovation * kMaxInnovation * innovationVariance)) {
+        return;
+    }
+
+    // K = P H^T / S, x += K y, and P -= K H P. P H^T is P's column for the
+    // measurement, so the update stays symmetric.
+    for (int i = 0; i < kStates; ++i) {
+        double gain = PHt[i] / innovationVariance;
+        m_x[i] += gain * innovation;
+        for (int j = 0; j < kStates; ++j) {
+            m_P[i][j] -= gain * PHt[j];
+        }
+    }
+}
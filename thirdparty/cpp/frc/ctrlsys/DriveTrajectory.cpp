@@ -0,0 +1,419 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/DriveTrajectory.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+
+#include <wpi/math>
+
+#include "frc/ctrlsys/HermiteSpline.h"
+
+using namespace frc;
+
+namespace {
+
+// Trajectory files are a FileHeader followed by the states exactly as they're
+// laid out in memory. The roboRIO and desktop platforms are all little-endian
+// with the same double layout, so files are portable between them.
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t stateSize;
+    uint32_t reserved;
+
+    // Hash() of the input the states were generated from
+    uint64_t sourceHash;
+
+    uint64_t count;
+};
+
+// "TRAJ" when read from a little-endian file
+constexpr uint32_t kMagic = 0x4A415254;
+
+// Incremented when the file layout changes or when Generate() produces
+// different states from the same input, which makes old files fail to load
+constexpr uint32_t kVersion = 1;
+
+static_assert(std::is_trivially_copyable_v<DriveTrajectory::State>);
+static_assert(sizeof(DriveTrajectory::State) == 8 * sizeof(double));
+static_assert(sizeof(FileHeader) % alignof(DriveTrajectory::State) == 0);
+
+/**
+ * Maps a file into memory read-only.
+ *
+ * Returns nullptr if the file couldn't be opened or is empty.
+ *
+ * @param path path to the file
+ * @param size set to the file's size in bytes
+ */
+std::shared_ptr<const uint8_t> MapFile(const std::string& path, size_t& size) {
+#ifdef _WIN32
+    // Desktop builds on Windows only run simulations, so reading the file is
+    // fine. The buffer is uint64_t so the states are aligned.
+    std::ifstream file{path, std::ios::binary | std::ios::ate};
+    if (!file || file.tellg() <= 0) {
+        return nullptr;
+    }
+    size = file.tellg();
+    auto buffer = std::make_shared<std::vector<uint64_t>>((size + 7) / 8);
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(buffer->data()), size)) {
+        return nullptr;
+    }
+    return std::shared_ptr<const uint8_t>(
+        buffer, reinterpret_cast<const uint8_t*>(buffer->data()));
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+    size = status.st_size;
+
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+
+    return std::shared_ptr<const uint8_t>(
+        static_cast<const uint8_t*>(addr), [size](const uint8_t* mapping) {
+            munmap(const_cast<uint8_t*>(mapping), size);
+        });
+#endif
+}
+
+/**
+ * Mixes the bytes of an object into a 64-bit FNV-1a hash.
+ */
+template <typename T>
+void HashBytes(uint64_t& hash, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (auto byte : bytes) {
+        hash = (hash ^ byte) * 0x100000001B3;
+    }
+}
+
+// Splines are subdivided until each piece turns less than this many radians
+constexpr double kMaxHeadingChange = 0.05;
+
+// and is shorter than this fraction of the distance between its waypoints
+constexpr double kMaxChordFraction = 1.0 / 64.0;
+
+// Bounds the recursion for degenerate splines
+constexpr int kMaxDepth = 16;
+
+/**
+ * Returns the angle wrapped to [-pi, pi].
+ */
+double WrapAngle(double angle) {
+    return std::remainder(angle, 2.0 * wpi::math::pi);
+}
+
+/**
+ * Appends points on the spline in (t0, t1] to the trajectory.
+ */
+void Subdivide(const HermiteSpline& spline, double t0, const Pose& p0,
+               double t1, double maxChord, int depth,
+               std::vector<DriveTrajectory::State>& states) {
+    Pose p1 = spline.GetPose(t1);
+
+    if (depth < kMaxDepth &&
+        (std::abs(WrapAngle(p1.heading - p0.heading)) > kMaxHeadingChange ||
+         std::hypot(p1.x - p0.x, p1.y - p0.y) > maxChord)) {
+        double mid = 0.5 * (t0 + t1);
+        Pose pm = spline.GetPose(mid);
+        Subdivide(spline, t0, p0, mid, maxChord, depth + 1, states);
+        Subdivide(spline, mid, pm, t1, maxChord, depth + 1, states);
+        return;
+    }
+
+    DriveTrajectory::State state{};
+    state.distance =
+        states.back().distance + std::hypot(p1.x - p0.x, p1.y - p0.y);
+    state.pose = p1;
+    state.curvature = spline.GetCurvature(t1);
+    states.emplace_back(state);
+}
+
+}  // namespace
+
+/**
+ * Constructs a DriveTrajectory from precomputed states.
+ *
+ * @param states states in order of increasing time
+ */
+DriveTrajectory::DriveTrajectory(std::vector<State> states)
+    : m_size(states.size()) {
+    if (!states.empty()) {
+        auto storage = std::make_shared<std::vector<State>>(std::move(states));
+        m_states = std::shared_ptr<const State>(storage, storage->data());
+    }
+}
+
+DriveTrajectory::DriveTrajectory(std::shared_ptr<const State> states,
+                                 size_t size)
+    : m_states(std::move(states)), m_size(size) {}
+
+/**
+ * Generates a trajectory through the waypoints.
+ *
+ * @param waypoints   at least two poses to pass through in order
+ * @param constraints limits on the robot's motion
+ */
+DriveTrajectory DriveTrajectory::Generate(const std::vector<Pose>& waypoints,
+                                          const Constraints& constraints) {
+    std::vector<State> states;
+    if (waypoints.empty()) {
+        return DriveTrajectory{};
+    }
+
+    State start{};
+    start.pose = waypoints[0];
+    states.emplace_back(start);
+
+    for (size_t i = 1; i < waypoints.size(); ++i) {
+        const auto& p0 = waypoints[i - 1];
+        const auto& p1 = waypoints[i];
+
+        HermiteSpline spline{p0, p1};
+        states.back().curvature = spline.GetCurvature(0.0);
+
+        double maxChord =
+            kMaxChordFraction * std::hypot(p1.x - p0.x, p1.y - p0.y);
+        Subdivide(spline, 0.0, p0, 1.0, maxChord, 0, states);
+    }
+
+    // Limit the velocity at each point by the curvature
+    for (auto& state : states) {
+        double curvature = std::abs(state.curvature);
+        double velocity = constraints.maxVelocity /
+                          (1.0 + 0.5 * constraints.trackWidth * curvature);
+        if (curvature > 0.0) {
+            velocity = std::min(
+                velocity,
+                std::sqrt(constraints.maxCentripetalAcceleration / curvature));
+        }
+        state.velocity = velocity;
+    }
+
+    // Start and end at rest, and limit acceleration and deceleration between
+    // points with forward and backward passes
+    states.front().velocity = 0.0;
+    states.back().velocity = 0.0;
+    for (size_t i = 1; i < states.size(); ++i) {
+        double ds = states[i].distance - states[i - 1].distance;
+        states[i].velocity = std::min(
+            states[i].velocity,
+            std::sqrt(states[i - 1].velocity * states[i - 1].velocity +
+                      2.0 * constraints.maxAcceleration * ds));
+    }
+    for (size_t i = states.size() - 1; i > 0; --i) {
+        double ds = states[i].distance - states[i - 1].distance;
+        states[i - 1].velocity =
+            std::min(states[i - 1].velocity,
+                     std::sqrt(states[i].velocity * states[i].velocity +
+                               2.0 * constraints.maxAcceleration * ds));
+    }
+
+    // With constant acceleration between points, the time taken is the
+    // distance over the average velocity
+    for (size_t i = 1; i < states.size(); ++i) {
+        auto& last = states[i - 1];
+        double ds = states[i].distance - last.distance;
+        double dt = 0.0;
+        if (ds > 0.0) {
+            dt = 2.0 * ds / (last.velocity + states[i].velocity);
+            last.acceleration = (states[i].velocity - last.velocity) / dt;
+        }
+        states[i].time = last.time + dt;
+    }
+
+    return DriveTrajectory{std::move(states)};
+}
+
+/**
+ * Loads a trajectory saved with Save().
+ *
+ * The file is memory-mapped and stays mapped while any copy of the trajectory
+ * exists. Returns an empty optional if the file is missing, was written by an
+ * incompatible version, or doesn't match the source hash.
+ *
+ * @param path       path to the file
+ * @param sourceHash Hash() of the input the trajectory is expected to be
+ *                   generated from, or 0 to accept any
+ */
+std::optional<DriveTrajectory> DriveTrajectory::Load(const std::string& path,
+                                                     uint64_t sourceHash) {
+    size_t size = 0;
+    auto file = MapFile(path, size);
+    if (file == nullptr || size < sizeof(FileHeader)) {
+        return std::nullopt;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, file.get(), sizeof(header));
+    size_t stateBytes = size - sizeof(FileHeader);
+    if (header.magic != kMagic || header.version != kVersion ||
+        header.stateSize != sizeof(State) ||
+        (sourceHash != 0 && header.sourceHash != sourceHash) ||
+        header.count == 0 || stateBytes % sizeof(State) != 0 ||
+        header.count != stateBytes / sizeof(State)) {
+        return std::nullopt;
+    }
+
+    auto states = std::shared_ptr<const State>(
+        file, reinterpret_cast<const State*>(file.get() + sizeof(FileHeader)));
+    return DriveTrajectory{std::move(states),
+                           static_cast<size_t>(header.count)};
+}
+
+/**
+ * Saves the trajectory so it can be loaded with Load().
+ *
+ * Returns false if the file couldn't be written.
+ *
+ * @param path       path to the file, which is replaced if it exists
+ * @param sourceHash Hash() of the input the trajectory was generated from
+ */
+bool DriveTrajectory::Save(const std::string& path, uint64_t sourceHash) const {
+    FileHeader header{kMagic, kVersion, sizeof(State), 0, sourceHash, m_size};
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(m_states.get()),
+               m_size * sizeof(State));
+    return file.good();
+}
+
+/**
+ * Returns a hash identifying the trajectory Generate() produces from the
+ * given input.
+ *
+ * Saved trajectories record the hash so stale files can be detected when the
+ * waypoints or constraints change.
+ *
+ * @param waypoints   poses to pass through in order
+ * @param constraints limits on the robot's motion
+ */
+uint64_t DriveTrajectory::Hash(const std::vector<Pose>& waypoints,
+                               const Constraints& constraints) {
+    uint64_t hash = 0xCBF29CE484222325;
+    HashBytes(hash, kVersion);
+    for (const auto& waypoint : waypoints) {
+        HashBytes(hash, waypoint.x);
+        HashBytes(hash, waypoint.y);
+        HashBytes(hash, waypoint.heading);
+    }
+    HashBytes(hash, constraints.maxVelocity);
+    HashBytes(hash, constraints.maxAcceleration);
+    HashBytes(hash, constraints.maxCentripetalAcceleration);
+    HashBytes(hash, constraints.trackWidth);
+
+    // 0 means "any" to Load()
+    return hash == 0 ? 1 : hash;
+}
+
+/**
+ * Returns the state at the given time.
+ *
+ * The state is interpolated between the two nearest precomputed ones. Times
+ * outside the trajectory return its first or last state.
+ *
+ * @param time time since the start of the trajectory in seconds
+ */
+DriveTrajectory::State DriveTrajectory::Sample(double time) const {
+    auto states = GetStates();
+    if (states.empty()) {
+        return State{};
+    }
+    if (time <= states.front().time) {
+        return states.front();
+    }
+    if (time >= states.back().time) {
+        return states.back();
+    }
+
+    auto next = std::upper_bound(
+        states.begin(), states.end(), time,
+        [](double t, const State& state) { return t < state.time; });
+    const auto& s0 = *(next - 1);
+    const auto& s1 = *next;
+
+    double dt = time - s0.time;
+    double ds = s0.velocity * dt + 0.5 * s0.acceleration * dt * dt;
+    double fraction = 0.0;
+    if (s1.distance > s0.distance) {
+        fraction = ds / (s1.distance - s0.distance);
+    }
+
+    State state;
+    state.time = time;
+    state.distance = s0.distance + ds;
+    state.pose.x = s0.pose.x + fraction * (s1.pose.x - s0.pose.x);
+    state.pose.y = s0.pose.y + fraction * (s1.pose.y - s0.pose.y);
+    state.pose.heading =
+        s0.pose.heading +
+        fraction * WrapAngle(s1.pose.heading - s0.pose.heading);
+    state.curvature = s0.curvature + fraction * (s1.curvature - s0.curvature);
+    state.velocity = s0.velocity + s0.acceleration * dt;
+    state.acceleration = s0.acceleration;
+    return state;
+}
+
+/**
+ * Returns the time taken to drive the trajectory in seconds.
+ */
+double DriveTrajectory::TotalTime() const {
+    if (m_size == 0) {
+        return 0.0;
+    }
+    return GetStates().back().time;
+}
+
+/**
+ * Returns the precomputed states.
+ */
+wpi::ArrayRef<DriveTrajectory::State> DriveTrajectory::GetStates() const {
+    return wpi::ArrayRef<State>{m_states.get(), m_size};
+}
+
+/**
+ * Touches every page of the states so sampling a loaded trajectory later
+ * doesn't wait on the file being read in.
+ *
+ * Call this before the trajectory is needed, e.g., while disabled.
+ */
+void DriveTrajectory::Prefetch() const {
+    constexpr size_t kPageSize = 4096;
+
+    const volatile uint8_t* bytes =
+        reinterpret_cast<const volatile uint8_t*>(m_states.get());
+    size_t size = m_size * sizeof(State);
+    for (size_t i = 0; i < size; i += kPageSize) {
+        static_cast<void>(bytes[i]);
+    }
+    if (size > 0) {
+        static_cast<void>(bytes[size - 1]);
+    }
+}
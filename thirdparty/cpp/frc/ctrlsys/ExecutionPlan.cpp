@@ -0,0 +1,113 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/ExecutionPlan.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace frc;
+
+/**
+ * Sorts the nodes reachable from the roots into execution order.
+ *
+ * Any previous plan is discarded. This allocates, so call it when enabling a
+ * controller rather than from the control loop.
+ *
+ * @param roots nodes whose outputs are needed each tick
+ */
+void ExecutionPlan::Compile(wpi::ArrayRef<INode*> roots) {
+    Clear();
+
+    std::unordered_map<INode*, size_t> indices;
+    for (auto root : roots) {
+        m_roots.emplace_back(AddNode(root, indices));
+    }
+
+    m_values.resize(m_steps.size());
+
+    size_t maxInputs = 0;
+    for (const auto& step : m_steps) {
+        maxInputs = std::max(maxInputs, step.inputEnd - step.inputBegin);
+    }
+    m_inputs.resize(maxInputs);
+}
+
+/**
+ * Discards the compiled plan.
+ */
+void ExecutionPlan::Clear() {
+    m_steps.clear();
+    m_inputIndices.clear();
+    m_values.clear();
+    m_inputs.clear();
+    m_roots.clear();
+}
+
+/**
+ * Computes every node in the plan once.
+ *
+ * Call this within an INode::Tick so the results are visible to Evaluate().
+ */
+void ExecutionPlan::Run() {
+    for (size_t i = 0; i < m_steps.size(); ++i) {
+        const auto& step = m_steps[i];
+
+        size_t count = step.inputEnd - step.inputBegin;
+        for (size_t j = 0; j < count; ++j) {
+            m_inputs[j] = m_values[m_inputIndices[step.inputBegin + j]];
+        }
+
+        m_values[i] = step.node->Compute(m_inputs.data());
+        step.node->SetTickOutput(m_values[i]);
+    }
+}
+
+/**
+ * Returns the output of a root node from the last call to Run().
+ *
+ * @param root index of the root in the list passed to Compile()
+ */
+double ExecutionPlan::GetOutput(size_t root) const {
+    return m_values[m_roots[root]];
+}
+
+/**
+ * Returns the number of nodes in the plan.
+ */
+size_t ExecutionPlan::Size() const { return m_steps.size(); }
+
+size_t ExecutionPlan::AddNode(INode* node,
+                              std::unordered_map<INode*, size_t>& indices) {
+    auto it = indices.find(node);
+    if (it != indices.end()) {
+        // A node still being visited has an index of SIZE_MAX. Reaching it
+        // again means the graph has a cycle, which GetOutput() couldn't
+        // evaluate either.
+        assert(it->second != SIZE_MAX);
+        return it->second;
+    }
+    indices[node] = SIZE_MAX;
+
+    std::vector<INode*> inputs;
+    node->GetInputNodes(inputs);
+
+    std::vector<size_t> inputIndices;
+    for (auto input : inputs) {
+        inputIndices.emplace_back(AddNode(input, indices));
+    }
+
+    Step step;
+    step.node = node;
+    step.inputBegin = m_inputIndices.size();
+    m_inputIndices.insert(m_inputIndices.end(), inputIndices.begin(),
+                          inputIndices.end());
+    step.inputEnd = m_inputIndices.size();
+
+    size_t index = m_steps.size();
+    m_steps.emplace_back(step);
+    indices[node] = index;
+
+    return index;
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/FeedforwardNode.h"
+
+using namespace frc;
+
+/**
+ * Constructs FeedforwardNode.
+ *
+ * @param Ks           the output needed to start moving
+ * @param Kv           the output per unit of velocity
+ * @param Ka           the output per unit of acceleration
+ * @param velocity     the velocity reference
+ * @param acceleration the acceleration reference
+ */
+FeedforwardNode::FeedforwardNode(double Ks, double Kv, double Ka,
+                                 INode& velocity, INode& acceleration)
+    : m_velocity(velocity),
+      m_acceleration(acceleration),
+      m_gains(Gains{Ks, Kv, Ka}) {}
+
+void FeedforwardNode::GetInputNodes(std::vector<INode*>& nodes) {
+    nodes.emplace_back(&m_velocity);
+    nodes.emplace_back(&m_acceleration);
+}
+
+double FeedforwardNode::GetOutput() {
+    double inputs[2] = {m_velocity.Evaluate(), m_acceleration.Evaluate()};
+    return Compute(inputs);
+}
+
+double FeedforwardNode::Compute(const double* inputs) {
+    auto gains = m_gains.Load();
+    double velocity = inputs[0];
+    double acceleration = inputs[1];
+
+    double output = gains.Kv * velocity + gains.Ka * acceleration;
+    if (velocity > 0.0) {
+        output += gains.Ks;
+    } else if (velocity < 0.0) {
+        output -= gains.Ks;
+    }
+    return output;
+}
+
+/**
+ * Sets the feedforward gains.
+ *
+ * @param Ks the output needed to start moving
+ * @param Kv the output per unit of velocity
+ * @param Ka the output per unit of acceleration
+ */
+void FeedforwardNode::SetGains(double Ks, double Kv, double Ka) {
+    m_gains.Store(Gains{Ks, Kv, Ka});
+}
+
+double FeedforwardNode::GetKs() const { return m_gains.Load().Ks; }
+
+double FeedforwardNode::GetKv() const { return m_gains.Load().Kv; }
+
+double FeedforwardNode::GetKa() const { return m_gains.Load().Ka; }
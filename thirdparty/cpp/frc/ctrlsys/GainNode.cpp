@@ -10,11 +10,15 @@ using namespace frc;
  * @param K the gain on the input
  * @param input the input node
  */
-GainNode::GainNode(double K, INode& input) : NodeBase(input) { m_gain = K; }
+GainNode::GainNode(double K, INode& input) : NodeBase(input), m_gain(K) {}
 
 double GainNode::GetOutput() {
-    std::scoped_lock lock(m_mutex);
-    return m_gain * NodeBase::GetOutput();
+    double input = NodeBase::GetOutput();
+    return Compute(&input);
+}
+
+double GainNode::Compute(const double* inputs) {
+    return m_gain.load(std::memory_order_relaxed) * inputs[0];
 }
 
 /**
@@ -23,14 +27,12 @@ double GainNode::GetOutput() {
  * @param K a gain to apply
  */
 void GainNode::SetGain(double K) {
-    std::scoped_lock lock(m_mutex);
-    m_gain = K;
+    m_gain.store(K, std::memory_order_relaxed);
 }
 
 /**
  * Return gain applied to node output.
  */
 double GainNode::GetGain() const {
-    std::scoped_lock lock(m_mutex);
-    return m_gain;
+    return m_gain.load(std::memory_order_relaxed);
 }
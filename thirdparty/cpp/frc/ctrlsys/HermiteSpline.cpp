@@ -0,0 +1,81 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/HermiteSpline.h"
+
+#include <cmath>
+
+using namespace frc;
+
+namespace {
+
+/**
+ * Evaluates the polynomial and its first two derivatives at t.
+ */
+void Evaluate(const std::array<double, 6>& c, double t, double& p, double& dp,
+              double& ddp) {
+    p = c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+    dp = c[1] + t * (2.0 * c[2] +
+                     t * (3.0 * c[3] + t * (4.0 * c[4] + t * 5.0 * c[5])));
+    ddp = 2.0 * c[2] + t * (6.0 * c[3] + t * (12.0 * c[4] + t * 20.0 * c[5]));
+}
+
+}  // namespace
+
+/**
+ * Constructs a HermiteSpline.
+ *
+ * The tangent magnitude at each end is 1.2 times the distance between the
+ * poses, which keeps the curvature low without looping.
+ *
+ * @param start the pose at t = 0
+ * @param end   the pose at t = 1
+ */
+HermiteSpline::HermiteSpline(const Pose& start, const Pose& end) {
+    double scale = 1.2 * std::hypot(end.x - start.x, end.y - start.y);
+
+    m_x = Coefficients(start.x, scale * std::cos(start.heading), end.x,
+                       scale * std::cos(end.heading));
+    m_y = Coefficients(start.y, scale * std::sin(start.heading), end.y,
+                       scale * std::sin(end.heading));
+}
+
+/**
+ * Returns the position and heading of the spline at t in [0, 1].
+ */
+Pose HermiteSpline::GetPose(double t) const {
+    double x, dx, ddx;
+    double y, dy, ddy;
+    Evaluate(m_x, t, x, dx, ddx);
+    Evaluate(m_y, t, y, dy, ddy);
+
+    return Pose{x, y, std::atan2(dy, dx)};
+}
+
+/**
+ * Returns the curvature of the spline at t in [0, 1].
+ *
+ * Curvature is positive when the spline turns counterclockwise.
+ */
+double HermiteSpline::GetCurvature(double t) const {
+    double x, dx, ddx;
+    double y, dy, ddy;
+    Evaluate(m_x, t, x, dx, ddx);
+    Evaluate(m_y, t, y, dy, ddy);
+
+    double speed = std::hypot(dx, dy);
+    return (dx * ddy - dy * ddx) / (speed * speed * speed);
+}
+
+/**
+ * Returns the coefficients of the quintic with the given value and first
+ * derivative at each end and zero second derivative at both ends.
+ */
+std::array<double, 6> HermiteSpline::Coefficients(double p0, double v0,
+                                                  double p1, double v1) {
+    return {p0,
+            v0,
+            0.0,
+            -10.0 * p0 - 6.0 * v0 - 4.0 * v1 + 10.0 * p1,
+            15.0 * p0 + 8.0 * v0 + 7.0 * v1 - 15.0 * p1,
+            -6.0 * p0 - 3.0 * v0 - 3.0 * v1 + 6.0 * p1};
+}
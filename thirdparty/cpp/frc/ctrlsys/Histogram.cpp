@@ -0,0 +1,131 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace frc;
+
+namespace {
+
+/**
+ * Returns the index of the highest set bit of a nonzero value.
+ */
+int MostSignificantBit(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+}  // namespace
+
+/**
+ * Adds a value to the histogram.
+ *
+ * @param value the value to record
+ */
+void Histogram::Record(uint64_t value) {
+    value = std::min(value, kMaxValue);
+
+    // There's only one writer, so a load and store is enough and avoids a
+    // locked read-modify-write
+    auto& bucket = m_counts[BucketIndex(value)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    m_count.store(m_count.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+    if (value > m_max.load(std::memory_order_relaxed)) {
+        m_max.store(value, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Returns the number of values recorded.
+ */
+uint64_t Histogram::GetCount() const {
+    return m_count.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the largest value recorded, or 0 if there are none.
+ */
+uint64_t Histogram::GetMax() const {
+    return m_max.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the value below which the given fraction of recorded values fall.
+ *
+ * The result is the upper bound of the bucket containing the percentile, but
+ * never more than GetMax().
+ *
+ * @param percentile the fraction in [0, 1] (e.g., 0.99 for p99)
+ */
+uint64_t Histogram::GetPercentile(double percentile) const {
+    uint64_t count = GetCount();
+    if (count == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t>(std::ceil(percentile * count));
+    rank = std::clamp<uint64_t>(rank, 1, count);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += m_counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(BucketUpperBound(i), GetMax());
+        }
+    }
+
+    // Reached if values were recorded while the buckets were being read
+    return GetMax();
+}
+
+/**
+ * Clears all recorded values.
+ *
+ * This must not be called while another thread calls Record().
+ */
+void Histogram::Reset() {
+    for (auto& bucket : m_counts) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+size_t Histogram::BucketIndex(uint64_t value) {
+    if (value < kSubBuckets) {
+        return value;
+    }
+
+    // Keep the top kSubBucketBits bits of the value. The highest of those is
+    // always set, so only the lower half of the sub-buckets is used.
+    int msb = MostSignificantBit(value);
+    int shift = msb - (kSubBucketBits - 1);
+    size_t top = value >> shift;
+
+    return kSubBuckets + (shift - 1) * kHalfSubBuckets +
+           (top - kHalfSubBuckets);
+}
+
+uint64_t Histogram::BucketUpperBound(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+
+    size_t shift = (index - kSubBuckets) / kHalfSubBuckets + 1;
+    uint64_t top = (index - kSubBuckets) % kHalfSubBuckets + kHalfSubBuckets;
+
+    return ((top + 1) << shift) - 1;
+}
@@ -2,10 +2,21 @@
 
 #include "frc/ctrlsys/INode.h"
 
-#include "frc/ctrlsys/Output.h"
+#include <atomic>
+
+#include <frc2/Timer.h>
+
 
 using namespace frc;
 
+namespace {
+// Tick IDs are unique across threads so a node never mistakes another
+// thread's cycle for its own. Zero means no cycle is active.
+std::atomic<uint64_t> nextTick{1};
+thread_local uint64_t currentTick = 0;
+thread_local units::second_t currentTickTimestamp{0.0};
+}  // namespace
+
 /**
  * Get input node.
  *
@@ -14,13 +25,106 @@ using namespace frc;
 INode* INode::GetInputNode() { return nullptr; }
 
 /**
- * Set callback function.
+ * Appends the nodes whose outputs this node consumes.
  *
- * Nodes with no input should override this to store the function
- * Output::OutputFunc(), then call it after the node's value changes.
+ * The order must match the order in which Compute() expects their values. The
+ * default implementation appends GetInputNode() if there is one.
+ *
+ * @param nodes list to which to append input nodes
  */
-void INode::SetCallback(Output& output) {
+void INode::GetInputNodes(std::vector<INode*>& nodes) {
     if (GetInputNode() != nullptr) {
-        GetInputNode()->SetCallback(output);
+        nodes.emplace_back(GetInputNode());
+    }
+}
+
+/**
+ * Performs the node's operation on already evaluated input values.
+ *
+ * ExecutionPlan calls this with the outputs of GetInputNodes() in order. The
+ * default implementation calls GetOutput(), which is correct as long as every
+ * node GetOutput() reads is listed by GetInputNodes() or is evaluated on
+ * demand.
+ *
+ * @param inputs outputs of the nodes from GetInputNodes()
+ */
+double INode::Compute(const double* inputs) { return GetOutput(); }
+
+/**
+ * Returns the node's output for the current control cycle.
+ *
+ * Within an INode::Tick, the first call runs GetOutput() and caches the
+ * result; later calls in the same cycle return the cached value. This keeps
+ * nodes with several consumers (e.g., a PIDNode feeding both sides of a
+ * drivetrain) from reading sensors or advancing integrator and derivative
+ * state more than once per period. Outside a cycle, this calls GetOutput()
+ * directly.
+ *
+ * Consumers of other nodes should call this instead of GetOutput(). A graph
+ * should only be driven by one Output or OutputGroup thread at a time since
+ * the cached value isn't synchronized.
+ */
+double INode::Evaluate() {
+    if (currentTick == 0) {
+        return GetOutput();
+    }
+
+    if (m_tick != currentTick) {
+        m_tickOutput = GetOutput();
+        m_tick = currentTick;
+    }
+
+    return m_tickOutput;
+}
+
+/**
+ * Returns the time at which the current control cycle on the calling thread
+ * started, or 0 s if no cycle is active.
+ */
+units::second_t INode::GetTickTimestamp() { return currentTickTimestamp; }
+
+/**
+ * Stores the node's output for the current control cycle so later calls to
+ * Evaluate() return it.
+ */
+void INode::SetTickOutput(double output) {
+    m_tickOutput = output;
+    m_tick = currentTick;
+}
+
+/**
+ * Starts a control cycle at the current time, or joins the active one.
+ */
+INode::Tick::Tick() : m_owner(currentTick == 0) {
+    if (m_owner) {
+        currentTick = nextTick++;
+        currentTickTimestamp = frc2::Timer::GetFPGATimestamp();
+    }
+}
+
+/**
+ * Starts a control cycle at the given time, or joins the active one.
+ *
+ * This is useful for simulations that advance time faster than real time.
+ *
+ * @param timestamp the time at which the cycle started
+ */
+INode::Tick::Tick(units::second_t timestamp) : m_owner(currentTick == 0) {
+    if (m_owner) {
+        currentTick = nextTick++;
+        currentTickTimestamp = timestamp;
     }
 }
+
+INode::Tick::~Tick() {
+    if (m_owner) {
+        currentTick = 0;
+        currentTickTimestamp = units::second_t{0.0};
+    }
+}
+
+/**
+ * Returns true if this Tick started the current cycle rather than joining an
+ * enclosing one.
+ */
+bool INode::Tick::IsOutermost() const { return m_owner; }
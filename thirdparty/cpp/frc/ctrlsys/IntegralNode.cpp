@@ -15,25 +15,29 @@ using namespace frc;
  * @param period the loop time for doing calculations.
  */
 IntegralNode::IntegralNode(double K, INode& input, units::second_t period)
-    : NodeBase(input) {
-    m_gain = K;
-    m_period = period;
-}
+    : NodeBase(input), m_gain(K), m_period(period) {}
 
 double IntegralNode::GetOutput() {
     double input = NodeBase::GetOutput();
+    return Compute(&input);
+}
 
-    std::scoped_lock lock(m_mutex);
+double IntegralNode::Compute(const double* inputs) {
+    double gain = m_gain.load(std::memory_order_relaxed);
+    double period = m_period.Update();
 
-    if (std::abs(input) > m_maxInputMagnitude) {
+    if (m_resetRequested.exchange(false, std::memory_order_relaxed) ||
+        std::abs(inputs[0]) >
+            m_maxInputMagnitude.load(std::memory_order_relaxed)) {
         m_total = 0.0;
     } else {
-        m_total =
-            std::clamp(m_total + input * m_period.to<double>(), -1.0 / m_gain,
-                       1.0 / m_gain);
+        // The total is limited so the output stays within [-1, 1], which needs
+        // the gain's magnitude since the gain may be negative
+        double limit = 1.0 / std::abs(gain);
+        m_total = std::clamp(m_total + inputs[0] * period, -limit, limit);
     }
 
-    return m_gain * m_total;
+    return gain * m_total;
 }
 
 /**
@@ -42,16 +46,14 @@ double IntegralNode::GetOutput() {
  * @param K a gain to apply
  */
 void IntegralNode::SetGain(double K) {
-    std::scoped_lock lock(m_mutex);
-    m_gain = K;
+    m_gain.store(K, std::memory_order_relaxed);
 }
 
 /**
  * Return gain applied to node output.
  */
 double IntegralNode::GetGain() const {
-    std::scoped_lock lock(m_mutex);
-    return m_gain;
+    return m_gain.load(std::memory_order_relaxed);
 }
 
 /**
@@ -62,14 +64,24 @@ double IntegralNode::GetGain() const {
  *                          occur
  */
 void IntegralNode::SetIZone(double maxInputMagnitude) {
-    std::scoped_lock lock(m_mutex);
-    m_maxInputMagnitude = maxInputMagnitude;
+    m_maxInputMagnitude.store(maxInputMagnitude, std::memory_order_relaxed);
+}
+
+/**
+ * Selects whether to use the measured time between control cycles instead of
+ * the nominal period passed to the constructor.
+ *
+ * @param measured true to use the measured period
+ */
+void IntegralNode::UseMeasuredPeriod(bool measured) {
+    m_period.SetMeasured(measured);
 }
 
 /**
  * Clears integral state.
+ *
+ * The total is cleared on the next call to GetOutput().
  */
 void IntegralNode::Reset() {
-    std::scoped_lock lock(m_mutex);
-    m_total = 0.0;
+    m_resetRequested.store(true, std::memory_order_relaxed);
 }
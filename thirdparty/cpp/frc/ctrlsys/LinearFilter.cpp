@@ -2,6 +2,7 @@
 
 #include "frc/ctrlsys/LinearFilter.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -21,11 +22,12 @@ using namespace frc;
  */
 LinearFilter::LinearFilter(SinglePoleIIR, INode& input, double timeConstant,
                            double period)
-    : NodeBase(input), m_inputs(1), m_outputs(1) {
+    : NodeBase(input) {
     double gain = std::exp(-period / timeConstant);
 
-    m_inputGains.emplace_back(1.0 - gain);
-    m_outputGains.emplace_back(-gain);
+    m_inputGains = {1.0 - gain, 0.0};
+    m_outputGains = {-gain};
+    m_state.resize(1);
 }
 
 /**
@@ -42,19 +44,20 @@ LinearFilter::LinearFilter(SinglePoleIIR, INode& input, double timeConstant,
  */
 LinearFilter::LinearFilter(HighPass, INode& input, double timeConstant,
                            double period)
-    : NodeBase(input), m_inputs(2), m_outputs(1) {
+    : NodeBase(input) {
     double gain = std::exp(-period / timeConstant);
 
-    m_inputGains.emplace_back(gain);
-    m_inputGains.emplace_back(-gain);
-    m_outputGains.emplace_back(-gain);
+    m_inputGains = {gain, -gain};
+    m_outputGains = {-gain};
+    m_state.resize(1);
 }
 
 /**
  * Creates a K-tap FIR moving average filter of the form:<br>
  *   y[n] = 1/k * (x[k] + x[k-1] + … + x[0])
  *
- * This filter is always stable.
+ * This filter is always stable. It keeps a running sum of the window, so
+ * each sample takes constant time regardless of the number of taps.
  *
  * @param MovingAverage The tag for the type of filter to construct
  * @param source        The INode object that is used to get values
@@ -62,10 +65,7 @@ LinearFilter::LinearFilter(HighPass, INode& input, double timeConstant,
  *                      but slower
  */
 LinearFilter::LinearFilter(MovingAverage, INode& input, int taps)
-    : NodeBase(input),
-      m_inputs(1),
-      m_outputs(0),
-      m_inputGains(taps, 1.0 / taps) {
+    : NodeBase(input), m_form(Form::kMovingAverage), m_window(taps, 0.0) {
     assert(taps > 0);
 }
 
@@ -78,11 +78,27 @@ LinearFilter::LinearFilter(MovingAverage, INode& input, int taps)
  */
 LinearFilter::LinearFilter(INode& input, wpi::ArrayRef<double> ffGains,
                            wpi::ArrayRef<double> fbGains)
+    : NodeBase(input), m_inputGains(ffGains), m_outputGains(fbGains) {
+    size_t order = std::max(m_inputGains.size(), m_outputGains.size() + 1);
+    m_inputGains.resize(order, 0.0);
+    m_outputGains.resize(order - 1, 0.0);
+    m_state.resize(order - 1, 0.0);
+}
+
+/**
+ * Create an IIR filter from a cascade of second-order sections.
+ *
+ * The input passes through each section in order.
+ *
+ * @param input    The INode object that is used to get values
+ * @param sections The second-order sections
+ */
+LinearFilter::LinearFilter(INode& input,
+                           wpi::ArrayRef<SecondOrderSection> sections)
     : NodeBase(input),
-      m_inputs(ffGains.size()),
-      m_outputs(fbGains.size()),
-      m_inputGains(ffGains),
-      m_outputGains(fbGains) {}
+      m_form(Form::kSections),
+      m_sections(sections),
+      m_sectionStates(sections.size(), {0.0, 0.0}) {}
 
 /**
  * Calculates the next value of the filter.
@@ -90,23 +106,78 @@ LinearFilter::LinearFilter(INode& input, wpi::ArrayRef<double> ffGains,
  * @return The filtered value at this step
  */
 double LinearFilter::GetOutput() {
-    double retVal = 0.0;
-
-    // Rotate the inputs
-    m_inputs.push_front(NodeBase::GetOutput());
+    double input = NodeBase::GetOutput();
+    return Compute(&input);
+}
 
-    // Calculate the new value
-    for (size_t i = 0; i < m_inputGains.size(); i++) {
-        retVal += m_inputs[i] * m_inputGains[i];
-    }
-    for (size_t i = 0; i < m_outputGains.size(); i++) {
-        retVal -= m_outputs[i] * m_outputGains[i];
+double LinearFilter::Compute(const double* inputs) {
+    switch (m_form) {
+        case Form::kMovingAverage:
+            return ComputeMovingAverage(inputs[0]);
+        case Form::kSections: {
+            double output = inputs[0];
+            Filter(wpi::ArrayRef<double>{&output, 1},
+                   wpi::MutableArrayRef<double>{&output, 1});
+            return output;
+        }
+        default:
+            return ComputeTransposed(inputs[0]);
     }
+}
 
-    // Rotate the outputs
-    m_outputs.push_front(retVal);
+/**
+ * Filters a block of samples in order, continuing from the filter's current
+ * state.
+ *
+ * This is equivalent to calling Compute() on each sample, but cascaded
+ * second-order sections run one section over the whole block at a time, which
+ * keeps each section's gains and state in registers.
+ *
+ * @param inputs  The samples to filter
+ * @param outputs The filtered samples. May be the same memory as inputs, and
+ *                must be at least as long.
+ */
+void LinearFilter::Filter(wpi::ArrayRef<double> inputs,
+                          wpi::MutableArrayRef<double> outputs) {
+    assert(outputs.size() >= inputs.size());
 
-    return retVal;
+    size_t size = inputs.size();
+    const double* x = inputs.data();
+    double* y = outputs.data();
+
+    switch (m_form) {
+        case Form::kMovingAverage:
+            for (size_t n = 0; n < size; ++n) {
+                y[n] = ComputeMovingAverage(x[n]);
+            }
+            break;
+        case Form::kSections:
+            for (size_t i = 0; i < m_sections.size(); ++i) {
+                const auto section = m_sections[i];
+                double z0 = m_sectionStates[i][0];
+                double z1 = m_sectionStates[i][1];
+                for (size_t n = 0; n < size; ++n) {
+                    double input = x[n];
+                    double output = section.b0 * input + z0;
+                    z0 = section.b1 * input - section.a1 * output + z1;
+                    z1 = section.b2 * input - section.a2 * output;
+                    y[n] = output;
+                }
+                m_sectionStates[i] = {z0, z1};
+
+                // Later sections filter this one's output
+                x = y;
+            }
+            if (m_sections.empty()) {
+                std::copy(x, x + size, y);
+            }
+            break;
+        default:
+            for (size_t n = 0; n < size; ++n) {
+                y[n] = ComputeTransposed(x[n]);
+            }
+            break;
+    }
 }
 
 /**
@@ -116,6 +187,48 @@ double LinearFilter::GetOutput() {
  * instance using a graph containing this node is disabled.
  */
 void LinearFilter::Reset() {
-    m_inputs.reset();
-    m_outputs.reset();
+    std::fill(m_state.begin(), m_state.end(), 0.0);
+
+    std::fill(m_window.begin(), m_window.end(), 0.0);
+    m_windowIndex = 0;
+    m_sum = 0.0;
+    m_sumError = 0.0;
+
+    std::fill(m_sectionStates.begin(), m_sectionStates.end(),
+              std::array<double, 2>{0.0, 0.0});
+}
+
+double LinearFilter::ComputeTransposed(double input) {
+    // Each state holds the part of a future output that depends on past
+    // samples, so the new output only needs the first one. Shifting the rest
+    // reads ahead of the writes, which vectorizes.
+    double output = m_inputGains[0] * input;
+    size_t order = m_state.size();
+    if (order > 0) {
+        output += m_state[0];
+        for (size_t i = 0; i + 1 < order; ++i) {
+            m_state[i] = m_state[i + 1] + m_inputGains[i + 1] * input -
+                         m_outputGains[i] * output;
+        }
+        m_state[order - 1] =
+            m_inputGains[order] * input - m_outputGains[order - 1] * output;
+    }
+
+    return output;
+}
+
+double LinearFilter::ComputeMovingAverage(double input) {
+    // Kahan summation of the change in the sum keeps the rounding error from
+    // accumulating over a long run
+    double delta = (input - m_window[m_windowIndex]) - m_sumError;
+    double sum = m_sum + delta;
+    m_sumError = (sum - m_sum) - delta;
+    m_sum = sum;
+
+    m_window[m_windowIndex] = input;
+    if (++m_windowIndex == m_window.size()) {
+        m_windowIndex = 0;
+    }
+
+    return m_sum / m_window.size();
 }
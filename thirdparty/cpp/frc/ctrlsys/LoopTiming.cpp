@@ -0,0 +1,179 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/LoopTiming.h"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <networktables/NetworkTable.h>
+#include <networktables/NetworkTableInstance.h>
+#include <wpi/mutex.h>
+
+#include "frc/Notifier.h"
+
+using namespace frc;
+
+namespace {
+
+/**
+ * Publishes every LoopTiming instance from one low priority thread.
+ */
+class Publisher {
+public:
+    static Publisher& GetInstance() {
+        static Publisher instance;
+        return instance;
+    }
+
+    void Add(LoopTiming* timing) {
+        std::scoped_lock lock{m_mutex};
+        m_timings.emplace_back(timing);
+    }
+
+    void Remove(LoopTiming* timing) {
+        std::scoped_lock lock{m_mutex};
+        m_timings.erase(
+            std::remove(m_timings.begin(), m_timings.end(), timing),
+            m_timings.end());
+    }
+
+private:
+    wpi::mutex m_mutex;
+    std::vector<LoopTiming*> m_timings;
+    Notifier m_notifier{[this] {
+        std::scoped_lock lock{m_mutex};
+        for (auto timing : m_timings) {
+            timing->Publish();
+        }
+    }};
+
+    Publisher() { m_notifier.StartPeriodic(LoopTiming::kPublishPeriod); }
+};
+
+int64_t ToMicroseconds(std::chrono::steady_clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration)
+        .count();
+}
+
+}  // namespace
+
+/**
+ * Starts timing an iteration.
+ *
+ * @param timing the loop's timing
+ */
+LoopTiming::Scope::Scope(LoopTiming& timing)
+    : m_timing(timing), m_start(std::chrono::steady_clock::now()) {}
+
+/**
+ * Records the iteration.
+ */
+LoopTiming::Scope::~Scope() {
+    m_timing.Record(m_start, std::chrono::steady_clock::now());
+}
+
+/**
+ * Constructs a LoopTiming and starts publishing it.
+ *
+ * @param name   the loop's name in NetworkTables
+ * @param period the loop's nominal period
+ */
+LoopTiming::LoopTiming(wpi::StringRef name, units::second_t period)
+    : m_period(static_cast<int64_t>(period.to<double>() * 1e6)) {
+    auto table = nt::NetworkTableInstance::GetDefault()
+                     .GetTable("ControlLoops")
+                     ->GetSubTable(name);
+
+    const char* histograms[] = {"Period", "Execution time", "Overrun"};
+    const char* stats[] = {"p50 (us)", "p99 (us)", "max (us)"};
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            m_entries[i * 3 + j] = table->GetEntry(std::string{histograms[i]} +
+                                                   " " + stats[j]);
+        }
+    }
+    m_entries[9] = table->GetEntry("Missed deadlines");
+
+    Publisher::GetInstance().Add(this);
+}
+
+LoopTiming::~LoopTiming() { Publisher::GetInstance().Remove(this); }
+
+/**
+ * Sets the loop's nominal period, which determines its deadlines.
+ *
+ * @param period the loop's nominal period
+ */
+void LoopTiming::SetPeriod(units::second_t period) {
+    m_period.store(static_cast<int64_t>(period.to<double>() * 1e6),
+                   std::memory_order_relaxed);
+}
+
+/**
+ * Forgets the last iteration so the time the loop spent disabled isn't
+ * recorded as a period.
+ *
+ * This must not be called while an iteration is running.
+ */
+void LoopTiming::Restart() { m_started = false; }
+
+/**
+ * Returns the histogram of times between the starts of consecutive iterations.
+ */
+const Histogram& LoopTiming::GetPeriodHistogram() const { return m_periods; }
+
+/**
+ * Returns the histogram of iteration execution times.
+ */
+const Histogram& LoopTiming::GetExecutionTimeHistogram() const {
+    return m_executionTimes;
+}
+
+/**
+ * Returns the histogram of how late iterations that missed their deadline
+ * finished.
+ */
+const Histogram& LoopTiming::GetOverrunHistogram() const { return m_overruns; }
+
+/**
+ * Returns the number of iterations that missed their deadline.
+ */
+uint64_t LoopTiming::GetMissedDeadlines() const {
+    return m_overruns.GetCount();
+}
+
+/**
+ * Writes the current statistics to NetworkTables.
+ */
+void LoopTiming::Publish() {
+    const Histogram* histograms[] = {&m_periods, &m_executionTimes,
+                                     &m_overruns};
+    for (int i = 0; i < 3; ++i) {
+        m_entries[i * 3].SetDouble(histograms[i]->GetPercentile(0.5));
+        m_entries[i * 3 + 1].SetDouble(histograms[i]->GetPercentile(0.99));
+        m_entries[i * 3 + 2].SetDouble(histograms[i]->GetMax());
+    }
+    m_entries[9].SetDouble(GetMissedDeadlines());
+}
+
+void LoopTiming::Record(std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point end) {
+    m_executionTimes.Record(ToMicroseconds(end - start));
+
+    if (m_started) {
+        m_periods.Record(ToMicroseconds(start - m_lastStart));
+
+        // The iteration was released one period after the last one started
+        // and had one period to finish
+        int64_t period = m_period.load(std::memory_order_relaxed);
+        int64_t overrun = ToMicroseconds(end - m_lastStart) - 2 * period;
+        if (overrun > 0) {
+            m_overruns.Record(overrun);
+        }
+    }
+
+    m_started = true;
+    m_lastStart = start;
+}
@@ -4,9 +4,9 @@
 
 #include <cmath>
 
-using namespace frc;
+#include <frc2/Timer.h>
 
-MotionProfile::MotionProfile() { m_timer.Start(); }
+using namespace frc;
 
 /**
  * Returns node for profile's current position.
@@ -24,25 +24,229 @@ INode& MotionProfile::GetVelocityNode() { return m_velocityNode; }
 INode& MotionProfile::GetAccelerationNode() { return m_accelerationNode; }
 
 /**
- * Returns profile's goal state.
+ * Sets goal state of profile.
+ *
+ * The profile is planned and started on the next evaluation of its nodes.
+ *
+ * @param goal a distance to which to travel
+ * @param currentSource the current position
+ */
+void MotionProfile::SetGoal(double goal, double currentSource) {
+    SetGoal(goal, 0.0, std::make_tuple(currentSource, 0.0, 0.0));
+}
+
+/**
+ * Sets goal state of profile, starting from the given state.
+ *
+ * The profile is planned and started on the next evaluation of its nodes. It
+ * holds the goal once it arrives, so set the next goal before then to keep
+ * moving at the goal velocity.
+ *
+ * @param goal         a distance to which to travel
+ * @param goalVelocity the velocity at the goal
+ * @param current      the current position, velocity, and acceleration
  */
-double MotionProfile::GetGoal() const {
-    std::scoped_lock lock(m_mutex);
-    return m_goal;
+void MotionProfile::SetGoal(double goal, double goalVelocity,
+                            const State& current) {
+    Publish(Request{goal, goalVelocity, std::get<0>(current),
+                    std::get<1>(current), std::get<2>(current), false, 0.0,
+                    0});
 }
 
+/**
+ * Sets goal state of profile, starting from the current reference.
+ *
+ * The new profile starts from the current profile's state at the time of this
+ * call, so the reference doesn't jump. If no profile has been planned yet, it
+ * starts from rest at zero.
+ *
+ * @param goal         a distance to which to travel
+ * @param goalVelocity the velocity at the goal
+ */
+void MotionProfile::Replan(double goal, double goalVelocity) {
+    Publish(Request{goal, goalVelocity, 0.0, 0.0, 0.0, true, 0.0, 0});
+}
+
+/**
+ * Returns profile's goal state.
+ */
+double MotionProfile::GetGoal() const { return m_request.Load().goal; }
+
 /**
  * Returns true if motion profile has reached goal state.
+ *
+ * Returns false if the latest goal hasn't been planned yet.
  */
 bool MotionProfile::AtGoal() const {
-    std::scoped_lock lock(m_mutex);
-    return m_timer.Get() >= m_timeTotal ||
-           std::abs(m_goal - std::get<0>(m_ref)) < 0.001;
+    auto request = m_request.Load();
+    auto status = m_status.Load();
+
+    if (status.generation != request.generation) {
+        return false;
+    }
+
+    double time = frc2::Timer::GetFPGATimestamp().to<double>();
+    return time - request.startTime >= status.timeTotal ||
+           std::abs(request.goal - status.position) < 0.001;
 }
 
-void MotionProfile::Reset() {
-    m_lastTime = 0.0;
-    m_timer.Reset();
+/**
+ * Restarts the profile from the state passed to the last SetGoal() call.
+ *
+ * If the last goal came from Replan(), the profile is replanned from the
+ * current reference instead.
+ */
+void MotionProfile::Reset() { Publish(m_request.Load()); }
+
+/**
+ * Returns total time of the last planned profile.
+ */
+double MotionProfile::ProfileTimeTotal() const {
+    return m_status.Load().timeTotal;
+}
+
+void MotionProfile::Publish(Request request) {
+    request.startTime = frc2::Timer::GetFPGATimestamp().to<double>();
+    request.generation = ++m_requestCount;
+    m_request.Store(request);
 }
 
-double MotionProfile::ProfileTimeTotal() const { return m_timeTotal; }
+/**
+ * Returns the reference of the last planned profile at the given time.
+ *
+ * This must be called on the thread evaluating the profile's nodes. Sampling
+ * takes constant time when the time increases between calls.
+ *
+ * @param time time in seconds since the start of the profile
+ */
+MotionProfile::State MotionProfile::Sample(double time) {
+    if (time < 0.0) {
+        time = 0.0;
+    }
+
+    // Resume the search from the last sample's segment since time usually
+    // only advances between samples
+    if (time < m_segments[m_segment].startTime) {
+        m_segment = 0;
+    }
+    while (m_segment < m_numSegments &&
+           time >= m_segments[m_segment + 1].startTime) {
+        ++m_segment;
+    }
+
+    const auto& segment = m_segments[m_segment];
+    if (m_segment == m_numSegments) {
+        // m_start + m_sign * segment.position can round away from the goal
+        return std::make_tuple(m_goal, 0.0, 0.0);
+    }
+
+    double t = time - segment.startTime;
+    double j = segment.jerk;
+    double a = segment.acceleration + j * t;
+    double v = segment.velocity + (segment.acceleration + j * t / 2.0) * t;
+    double p =
+        segment.position +
+        (segment.velocity + (segment.acceleration / 2.0 + j * t / 6.0) * t) *
+            t;
+
+    return std::make_tuple(m_start + m_sign * p, m_sign * v, m_sign * a);
+}
+
+/**
+ * Appends a segment with constant jerk to the plan.
+ *
+ * The segment starts where the previous one ends.
+ *
+ * @param duration     length of the segment in seconds
+ * @param acceleration acceleration at the start of the segment
+ * @param jerk         jerk during the segment
+ */
+void MotionProfile::AddSegment(double duration, double acceleration,
+                               double jerk) {
+    if (duration <= 0.0 || m_numSegments == kMaxSegments) {
+        return;
+    }
+
+    auto& segment = m_segments[m_numSegments];
+    segment.acceleration = acceleration;
+    segment.jerk = jerk;
+    ++m_numSegments;
+
+    // Integrate the segment to find the start of the next one
+    double t = duration;
+    auto& end = m_segments[m_numSegments];
+    end.startTime = segment.startTime + t;
+    end.acceleration = acceleration + jerk * t;
+    end.velocity = segment.velocity + (acceleration + jerk * t / 2.0) * t;
+    end.position =
+        segment.position +
+        (segment.velocity + (acceleration / 2.0 + jerk * t / 6.0) * t) * t;
+    end.jerk = 0.0;
+}
+
+/**
+ * Replaces the current plan with one from the start state to the goal.
+ */
+void MotionProfile::StartPlan(double goal, double goalVelocity,
+                              const State& start) {
+    double distance = goal - std::get<0>(start);
+    double velocity = std::get<1>(start);
+    double acceleration = std::get<2>(start);
+
+    // Plan in the direction of travel. If the profile doesn't need to move,
+    // the velocities determine the direction instead.
+    if (distance != 0.0) {
+        m_sign = std::copysign(1.0, distance);
+    } else if (goalVelocity != 0.0) {
+        m_sign = std::copysign(1.0, goalVelocity);
+    } else {
+        m_sign = std::copysign(1.0, velocity);
+    }
+    m_start = std::get<0>(start);
+    m_goal = goal;
+
+    m_segments[0] = Segment{0.0, 0.0, m_sign * velocity,
+                            m_sign * acceleration, 0.0};
+    m_numSegments = 0;
+    m_segment = 0;
+    if (distance != 0.0 || velocity != 0.0 || acceleration != 0.0 ||
+        goalVelocity != 0.0) {
+        Plan(m_sign * distance, m_sign * velocity, m_sign * acceleration,
+             m_sign * goalVelocity);
+    }
+
+    // Absorb the rounding error of the integrated segments so the profile
+    // ends exactly at the goal
+    m_segments[m_numSegments].position = m_sign * distance;
+}
+
+/**
+ * Plans the latest goal if it changed, then samples the profile at the current
+ * time.
+ */
+void MotionProfile::Update() {
+    auto request = m_request.Load();
+    if (request.generation == 0) {
+        // No goal has been set yet
+        return;
+    }
+
+    if (request.generation != m_generation) {
+        m_generation = request.generation;
+
+        State start = std::make_tuple(request.start, request.startVelocity,
+                                      request.startAcceleration);
+        if (request.replan) {
+            // Start where the current plan is when the new one starts
+            start = Sample(request.startTime - m_startTime);
+        }
+        m_startTime = request.startTime;
+
+        StartPlan(request.goal, request.goalVelocity, start);
+    }
+
+    m_ref = Sample(frc2::Timer::GetFPGATimestamp().to<double>() - m_startTime);
+
+    m_status.Store(Status{std::get<0>(m_ref),
+                          m_segments[m_numSegments].startTime, m_generation});
+}
@@ -8,4 +8,4 @@ NodeBase::NodeBase(INode& input) : m_input(input) {}
 
 INode* NodeBase::GetInputNode() { return &m_input; }
 
-double NodeBase::GetOutput() { return m_input.GetOutput(); }
+double NodeBase::GetOutput() { return m_input.Evaluate(); }
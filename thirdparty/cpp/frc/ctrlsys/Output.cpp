@@ -2,35 +2,73 @@
 
 #include "frc/ctrlsys/Output.h"
 
+#include <string>
+
 #include "frc/DriverStation.h"
+#include "frc/ctrlsys/ControlScheduler.h"
 
 using namespace frc;
 
+namespace {
+
+std::string NextName() {
+    static int instances = 0;
+    instances++;
+    return "Output " + std::to_string(instances);
+}
+
+}  // namespace
+
 /**
  * Calls PIDWrite() on the output at a regular interval.
  *
+ * Its loop timing is published under a generated name ("Output <N>").
+ *
  * @param input the node that is used to get values
  * @param output the PIDOutput object that is set to the output value
  * @param period the loop time for doing calculations.
  */
 Output::Output(INode& input, PIDOutput& output, units::second_t period)
+    : Output(NextName(), input, output, period) {}
+
+/**
+ * Calls PIDWrite() on the output at a regular interval.
+ *
+ * @param name the name its loop timing is published under
+ * @param input the node that is used to get values
+ * @param output the PIDOutput object that is set to the output value
+ * @param period the loop time for doing calculations.
+ */
+Output::Output(wpi::StringRef name, INode& input, PIDOutput& output,
+               units::second_t period)
     : m_input(input),
       m_output(output),
       m_period(period),
-      m_thread(&Output::OutputFunc, this) {
-    m_input.SetCallback(*this);
-}
+      m_timing(name, period) {}
+
+Output::~Output() { ControlScheduler::GetInstance().Unschedule(this); }
 
 /**
  * Starts closed loop control.
+ *
+ * The input graph is compiled into an ExecutionPlan the first time this is
+ * called, so nodes can't be added to it afterward.
  */
-void Output::Enable() { m_thread.StartPeriodic(m_period); }
+void Output::Enable() {
+    if (m_plan.Size() == 0) {
+        m_plan.Compile({&m_input});
+    }
+
+    ControlScheduler::GetInstance().Schedule(
+        this, [this] { OutputFunc(); }, m_period);
+}
 
 /**
  * Stops closed loop control.
  */
 void Output::Disable() {
-    m_thread.Stop();
+    ControlScheduler::GetInstance().Unschedule(this);
+    m_timing.Restart();
 
     m_output.PIDWrite(0.0);
 }
@@ -42,21 +80,31 @@ void Output::Disable() {
  * @param maxU maximum control action
  */
 void Output::SetRange(double minU, double maxU) {
-    std::scoped_lock lock(m_mutex);
-
-    m_minU = minU;
-    m_maxU = maxU;
+    m_range.Store(Range{minU, maxU});
 }
 
+/**
+ * Returns the period, execution time, and deadline statistics of the control
+ * loop.
+ */
+const LoopTiming& Output::GetTiming() const { return m_timing; }
+
 void Output::OutputFunc() {
-    double controlAction = m_input.GetOutput();
+    LoopTiming::Scope timingScope{m_timing};
+    INode::Tick tick;
+
+    // An enclosing OutputGroup has already run its own plan for this cycle
+    if (tick.IsOutermost()) {
+        m_plan.Run();
+    }
 
-    std::scoped_lock lock(m_mutex);
+    double controlAction = m_input.Evaluate();
+    auto range = m_range.Load();
 
-    if (controlAction > m_maxU) {
-        m_output.PIDWrite(m_maxU);
-    } else if (controlAction < m_minU) {
-        m_output.PIDWrite(m_minU);
+    if (controlAction > range.maxU) {
+        m_output.PIDWrite(range.maxU);
+    } else if (controlAction < range.minU) {
+        m_output.PIDWrite(range.minU);
     } else {
         m_output.PIDWrite(controlAction);
     }
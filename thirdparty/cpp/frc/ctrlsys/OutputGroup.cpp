@@ -2,38 +2,80 @@
 
 #include "frc/ctrlsys/OutputGroup.h"
 
+#include <utility>
+
+#include "frc/ctrlsys/ControlScheduler.h"
+
 using namespace frc;
 
-/**
- * Appends output to array.
- *
- * @param output the PIDOutput object that is set to the output value
- * @param period the loop time for doing calculations.
- */
-OutputGroup::OutputGroup(Output& output)
-    : m_thread(&OutputGroup::OutputFunc, this) {
-    m_outputs.emplace_back(output);
+OutputGroup::OutputGroup(wpi::StringRef name,
+                         std::vector<std::reference_wrapper<Output>> outputs)
+    : m_outputs(std::move(outputs)), m_timing(name, INode::kDefaultPeriod) {}
+
+OutputGroup::~OutputGroup() {
+    ControlScheduler::GetInstance().Unschedule(this);
 }
 
 /**
  * Starts closed loop control.
  *
+ * The outputs' input graphs are compiled into one ExecutionPlan the first time
+ * this is called, so nodes can't be added to them afterward.
+ *
  * @param period the loop time for doing calculations.
  */
-void OutputGroup::Enable(units::second_t period) { m_thread.StartPeriodic(period); }
+void OutputGroup::Enable(units::second_t period) {
+    if (m_plan.Size() == 0) {
+        std::vector<INode*> roots;
+        for (auto& output : m_outputs) {
+            roots.emplace_back(&output.get().m_input);
+        }
+        m_plan.Compile(roots);
+    }
+
+    // The outputs run at the group's period instead of their own
+    m_timing.SetPeriod(period);
+    for (auto& output : m_outputs) {
+        output.get().m_timing.SetPeriod(period);
+    }
+
+    ControlScheduler::GetInstance().Schedule(
+        this, [this] { OutputFunc(); }, period);
+}
 
 /**
  * Stops closed loop control.
  */
 void OutputGroup::Disable() {
-    m_thread.Stop();
+    ControlScheduler::GetInstance().Unschedule(this);
+    m_timing.Restart();
 
     for (auto& output : m_outputs) {
         output.get().Disable();
     }
 }
 
+/**
+ * Returns the period, execution time, and deadline statistics of the control
+ * loop.
+ */
+const LoopTiming& OutputGroup::GetTiming() const { return m_timing; }
+
+std::string OutputGroup::NextName() {
+    static int instances = 0;
+    instances++;
+    return "OutputGroup " + std::to_string(instances);
+}
+
 void OutputGroup::OutputFunc() {
+    LoopTiming::Scope timingScope{m_timing};
+
+    // Share one cycle between the outputs so nodes they have in common are
+    // only evaluated once
+    INode::Tick tick;
+
+    m_plan.Run();
+
     for (auto& output : m_outputs) {
         output.get().OutputFunc();
     }
@@ -0,0 +1,162 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/PIDBank.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+using namespace frc;
+
+/**
+ * Allocate a bank of PID controllers with all gains set to zero.
+ *
+ * @param size   the number of controllers
+ * @param period the loop time for doing calculations. This particularly
+ *               effects calculations of the integral and differental terms.
+ */
+PIDBank::PIDBank(size_t size, units::second_t period)
+    : m_period(period.to<double>()),
+      m_Kp(size, 0.0),
+      m_Ki(size, 0.0),
+      m_Kd(size, 0.0),
+      m_maxTotal(size, std::numeric_limits<double>::infinity()),
+      m_maxInputMagnitude(size, std::numeric_limits<double>::infinity()),
+      m_minU(size, -1.0),
+      m_maxU(size, 1.0),
+      m_total(size, 0.0),
+      m_prevInput(size, 0.0),
+      m_reset(size, 0) {}
+
+/**
+ * Returns the number of controllers in the bank.
+ */
+size_t PIDBank::Size() const { return m_Kp.size(); }
+
+/**
+ * Set a controller's gain parameters. Set the proportional, integral, and
+ * differential coefficients.
+ *
+ * @param index the controller
+ * @param p     Proportional coefficient
+ * @param i     Integral coefficient
+ * @param d     Differential coefficient
+ */
+void PIDBank::SetPID(size_t index, double p, double i, double d) {
+    m_Kp[index] = p;
+    m_Ki[index] = i;
+    m_Kd[index] = d;
+    m_maxTotal[index] = 1.0 / std::abs(i);
+}
+
+/**
+ * Get a controller's Proportional coefficient.
+ */
+double PIDBank::GetP(size_t index) const { return m_Kp[index]; }
+
+/**
+ * Get a controller's Integral coefficient.
+ */
+double PIDBank::GetI(size_t index) const { return m_Ki[index]; }
+
+/**
+ * Get a controller's Differential coefficient.
+ */
+double PIDBank::GetD(size_t index) const { return m_Kd[index]; }
+
+/**
+ * Sets the minimum and maximum values a controller writes.
+ *
+ * The bounds may be given in either order.
+ *
+ * @param index the controller
+ * @param minU  the minimum value to write to the output
+ * @param maxU  the maximum value to write to the output
+ */
+void PIDBank::SetOutputRange(size_t index, double minU, double maxU) {
+    m_minU[index] = std::min(minU, maxU);
+    m_maxU[index] = std::max(minU, maxU);
+}
+
+/**
+ * Set maximum magnitude of a controller's input for which integration should
+ * occur. Values above this will reset the current total.
+ *
+ * @param index             the controller
+ * @param maxInputMagnitude max value of input for which integration should
+ *                          occur
+ */
+void PIDBank::SetIZone(size_t index, double maxInputMagnitude) {
+    m_maxInputMagnitude[index] = maxInputMagnitude;
+}
+
+/**
+ * Clear a controller's integral and derivative states.
+ *
+ * Like PIDNode::Reset(), the states are cleared on the next Update(), which
+ * doesn't integrate that iteration's input.
+ */
+void PIDBank::Reset(size_t index) { m_reset[index] = 1; }
+
+/**
+ * Clear the integral and derivative states of every controller.
+ */
+void PIDBank::Reset() {
+    for (size_t i = 0; i < Size(); ++i) {
+        Reset(i);
+    }
+}
+
+/**
+ * Runs one iteration of every controller.
+ *
+ * The loop body uses selects instead of branches so it vectorizes; it must
+ * stay free of calls and aliasing between the arrays.
+ *
+ * @param inputs  each controller's input (usually its error)
+ * @param outputs receives each controller's output
+ */
+void PIDBank::Update(wpi::ArrayRef<double> inputs,
+                     wpi::MutableArrayRef<double> outputs) {
+    assert(inputs.size() == Size() && outputs.size() == Size());
+
+    const size_t size = Size();
+    const double period = m_period;
+
+    const double* __restrict Kp = m_Kp.data();
+    const double* __restrict Ki = m_Ki.data();
+    const double* __restrict Kd = m_Kd.data();
+    const double* __restrict maxTotal = m_maxTotal.data();
+    const double* __restrict maxInputMagnitude = m_maxInputMagnitude.data();
+    const double* __restrict minU = m_minU.data();
+    const double* __restrict maxU = m_maxU.data();
+    double* __restrict total = m_total.data();
+    double* __restrict prevInput = m_prevInput.data();
+    uint8_t* __restrict reset = m_reset.data();
+    const double* __restrict in = inputs.data();
+    double* __restrict out = outputs.data();
+
+    for (size_t i = 0; i < size; ++i) {
+        double input = in[i];
+        bool clear = reset[i] != 0;
+        reset[i] = 0;
+
+        // Integrate, clamp to +-1/Ki, and clear outside the I-zone
+        double sum = total[i] + input * period;
+        sum = sum > maxTotal[i] ? maxTotal[i] : sum;
+        sum = sum < -maxTotal[i] ? -maxTotal[i] : sum;
+        double magnitude = input < 0.0 ? -input : input;
+        sum = (clear || magnitude > maxInputMagnitude[i]) ? 0.0 : sum;
+        total[i] = sum;
+
+        double prev = clear ? 0.0 : prevInput[i];
+        double derivative = Kd[i] * (input - prev) / period;
+        prevInput[i] = input;
+
+        double u = Kp[i] * input + Ki[i] * sum + derivative;
+        u = u > maxU[i] ? maxU[i] : u;
+        u = u < minU[i] ? minU[i] : u;
+        out[i] = u;
+    }
+}
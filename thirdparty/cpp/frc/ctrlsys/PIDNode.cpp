@@ -2,6 +2,8 @@
 
 #include "frc/ctrlsys/PIDNode.h"
 
+#include <algorithm>
+
 using namespace frc;
 
 /**
@@ -41,15 +43,28 @@ PIDNode::PIDNode(double Kp, double Ki, double Kd, INode& feedforward,
       m_D(Kd, input, period),
       m_sum(m_P, true, m_I, true, m_D, true, feedforward, true) {}
 
+/**
+ * Lists the internal sum of the P, I, and D terms as the only input so an
+ * ExecutionPlan schedules the terms individually.
+ */
+void PIDNode::GetInputNodes(std::vector<INode*>& nodes) {
+    nodes.emplace_back(&m_sum);
+}
+
 double PIDNode::GetOutput() {
-    double sum = m_sum.GetOutput();
+    double sum = m_sum.Evaluate();
+    return Compute(&sum);
+}
 
-    if (sum > m_maxU) {
-        return m_maxU;
-    } else if (sum < m_minU) {
-        return m_minU;
+double PIDNode::Compute(const double* inputs) {
+    auto range = m_range.Load();
+
+    if (inputs[0] > range.maxU) {
+        return range.maxU;
+    } else if (inputs[0] < range.minU) {
+        return range.minU;
     } else {
-        return sum;
+        return inputs[0];
     }
 }
 
@@ -112,12 +127,13 @@ double PIDNode::GetD() const { return m_D.GetGain(); }
 /**
  * Sets the minimum and maximum values to write.
  *
+ * The bounds may be given in either order.
+ *
  * @param minU the minimum value to write to the output
  * @param maxU the maximum value to write to the output
  */
 void PIDNode::SetOutputRange(double minU, double maxU) {
-    m_minU = minU;
-    m_maxU = maxU;
+    m_range.Store(Range{std::min(minU, maxU), std::max(minU, maxU)});
 }
 
 /**
@@ -131,6 +147,37 @@ void PIDNode::SetIZone(double maxInputMagnitude) {
     m_I.SetIZone(maxInputMagnitude);
 }
 
+/**
+ * Selects whether the integral and derivative terms use the measured time
+ * between control cycles instead of the nominal period.
+ *
+ * Gains tuned in measured mode stay valid if the loop rate changes.
+ *
+ * @param measured true to use the measured period
+ */
+void PIDNode::UseMeasuredPeriod(bool measured) {
+    m_I.UseMeasuredPeriod(measured);
+    m_D.UseMeasuredPeriod(measured);
+}
+
+/**
+ * Returns the node computing the proportional term.
+ *
+ * Within a control cycle, its Evaluate() returns the term that went into this
+ * cycle's output, which is useful for logging.
+ */
+GainNode& PIDNode::GetProportionalNode() { return m_P; }
+
+/**
+ * Returns the node computing the integral term.
+ */
+IntegralNode& PIDNode::GetIntegralNode() { return m_I; }
+
+/**
+ * Returns the node computing the derivative term.
+ */
+DerivativeNode& PIDNode::GetDerivativeNode() { return m_D; }
+
 /**
  * Clear the integral and derivative states.
  */
@@ -0,0 +1,119 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/PoseHistory.h"
+
+#include <cmath>
+
+#include <wpi/math>
+
+using namespace frc;
+
+/**
+ * Constructs a PoseHistory.
+ *
+ * @param capacity the number of poses to keep
+ */
+PoseHistory::PoseHistory(size_t capacity)
+    : m_capacity(capacity),
+      m_slots(2 * capacity),
+      m_entries(std::make_unique<SeqLock<Entry>[]>(m_slots)) {}
+
+/**
+ * Records the pose at a time.
+ *
+ * Timestamps must increase; a pose that isn't newer than the last one is
+ * ignored.
+ *
+ * @param timestamp the time in seconds
+ * @param pose      the robot's pose at that time
+ */
+void PoseHistory::Add(double timestamp, const Pose& pose) {
+    uint64_t end = m_end.load(std::memory_order_relaxed);
+    if (m_capacity == 0 || (end != m_begin.load(std::memory_order_relaxed) &&
+                         timestamp <= m_lastTimestamp)) {
+        return;
+    }
+
+    m_entries[end % m_slots].Store(Entry{timestamp, pose});
+    m_end.store(end + 1, std::memory_order_release);
+    m_lastTimestamp = timestamp;
+}
+
+/**
+ * Removes every pose, such as when the pose is reset and the old ones no
+ * longer share its frame.
+ */
+void PoseHistory::Clear() {
+    m_begin.store(m_end.load(std::memory_order_relaxed),
+                  std::memory_order_release);
+}
+
+/**
+ * Returns the pose at a time, interpolated between the recorded poses around
+ * it.
+ *
+ * Times after the newest pose return the newest pose. Returns nothing if the
+ * history is empty or the time is before the oldest pose.
+ *
+ * @param timestamp the time in seconds
+ */
+std::optional<Pose> PoseHistory::Sample(double timestamp) const {
+    for (;;) {
+        uint64_t validBegin = m_begin.load(std::memory_order_acquire);
+        uint64_t end = m_end.load(std::memory_order_acquire);
+        uint64_t begin = validBegin;
+        if (end - begin > m_capacity) {
+            begin = end - m_capacity;
+        }
+        if (begin == end) {
+            return std::nullopt;
+        }
+
+        std::optional<Pose> pose;
+        uint64_t oldestRead = end - 1;
+
+        auto newest = m_entries[(end - 1) % m_slots].Load();
+        if (timestamp >= newest.timestamp) {
+            pose = newest.pose;
+        } else {
+            oldestRead = begin;
+            auto lower = m_entries[begin % m_slots].Load();
+            if (timestamp >= lower.timestamp) {
+                // Narrow [lo, hi] until it brackets the timestamp
+                auto upper = newest;
+                uint64_t lo = begin;
+                uint64_t hi = end - 1;
+                while (hi - lo > 1) {
+                    uint64_t mid = lo + (hi - lo) / 2;
+                    auto entry = m_entries[mid % m_slots].Load();
+                    if (entry.timestamp <= timestamp) {
+                        lo = mid;
+                        lower = entry;
+                    } else {
+                        hi = mid;
+                        upper = entry;
+                    }
+                }
+
+                double s = (timestamp - lower.timestamp) /
+                           (upper.timestamp - lower.timestamp);
+                double turn = std::remainder(
+                    upper.pose.heading - lower.pose.heading,
+                    2.0 * wpi::math::pi);
+                pose = Pose{
+                    lower.pose.x + s * (upper.pose.x - lower.pose.x),
+                    lower.pose.y + s * (upper.pose.y - lower.pose.y),
+                    lower.pose.heading + s * turn};
+            }
+        }
+
+        // The oldest entry read is overwritten once Add() starts on the entry
+        // m_slots after it, so the search was consistent if that hasn't
+        // started and the history wasn't cleared
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_begin.load(std::memory_order_relaxed) == validBegin &&
+            m_end.load(std::memory_order_relaxed) < oldestRead + m_slots) {
+            return pose;
+        }
+    }
+}
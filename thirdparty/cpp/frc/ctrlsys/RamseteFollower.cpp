@@ -0,0 +1,72 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/RamseteFollower.h"
+
+#include <cmath>
+
+#include <wpi/math>
+
+using namespace frc;
+
+namespace {
+
+/**
+ * Returns sin(x) / x, which is 1 at x = 0.
+ */
+double Sinc(double x) {
+    if (std::abs(x) < 1e-9) {
+        return 1.0 - x * x / 6.0;
+    }
+    return std::sin(x) / x;
+}
+
+}  // namespace
+
+/**
+ * Constructs RamseteFollower.
+ *
+ * @param b    convergence gain in rad^2 per unit of distance squared. Larger
+ *             values converge more aggressively.
+ * @param zeta damping ratio between 0 and 1
+ */
+RamseteFollower::RamseteFollower(double b, double zeta) { SetGains(b, zeta); }
+
+/**
+ * Sets the controller gains.
+ *
+ * @param b    convergence gain in rad^2 per unit of distance squared
+ * @param zeta damping ratio between 0 and 1
+ */
+void RamseteFollower::SetGains(double b, double zeta) {
+    m_b = b;
+    m_zeta = zeta;
+}
+
+/**
+ * Returns the velocity and counterclockwise angular velocity in rad/s that
+ * steer the robot toward the desired state.
+ *
+ * @param pose    the robot's current pose
+ * @param desired the trajectory's current state
+ */
+std::tuple<double, double> RamseteFollower::Calculate(
+    const Pose& pose, const DriveTrajectory::State& desired) const {
+    // Error in the robot's frame
+    double dx = desired.pose.x - pose.x;
+    double dy = desired.pose.y - pose.y;
+    double cosHeading = std::cos(pose.heading);
+    double sinHeading = std::sin(pose.heading);
+    double ex = cosHeading * dx + sinHeading * dy;
+    double ey = -sinHeading * dx + cosHeading * dy;
+    double eHeading = std::remainder(desired.pose.heading - pose.heading,
+                                     2.0 * wpi::math::pi);
+
+    double vd = desired.velocity;
+    double omegad = desired.velocity * desired.curvature;
+
+    double k = 2.0 * m_zeta * std::sqrt(omegad * omegad + m_b * vd * vd);
+
+    return std::make_tuple(
+        vd * std::cos(eHeading) + k * ex,
+        omegad + k * eHeading + m_b * vd * Sinc(eHeading) * ey);
+}
@@ -2,40 +2,30 @@
 
 #include "frc/ctrlsys/RefInput.h"
 
-#include "frc/ctrlsys/Output.h"
-
 using namespace frc;
 
 RefInput::RefInput(double reference) { Set(reference); }
 
-void RefInput::SetCallback(Output& output) {
-    m_callback = std::bind(&Output::OutputFunc, std::ref(output));
-}
-
 /**
  * Returns value of reference input.
  */
 double RefInput::GetOutput() {
-    std::scoped_lock lock(m_mutex);
-    return m_reference;
+    return m_reference.load(std::memory_order_relaxed);
 }
 
 /**
  * Returns value of reference input.
  */
 double RefInput::GetOutput() const {
-    std::scoped_lock lock(m_mutex);
-    return m_reference;
+    return m_reference.load(std::memory_order_relaxed);
 }
 
 /**
  * Sets reference input.
+ *
+ * This may be called from any thread. Control loops reading it see the new
+ * value on their next iteration.
  */
 void RefInput::Set(double reference) {
-    {
-        std::scoped_lock lock(m_mutex);
-        m_reference = reference;
-    }
-
-    m_callback();
+    m_reference.store(reference, std::memory_order_relaxed);
 }
@@ -2,10 +2,35 @@
 
 #include "frc/ctrlsys/SCurveProfile.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace frc;
 
+namespace {
+
+// Bisection iterations when solving for the peak velocity
+constexpr int kIterations = 64;
+
+/**
+ * Returns the x in [low, high] at which the increasing function f equals y.
+ */
+template <typename F>
+double Solve(F&& f, double y, double low, double high) {
+    for (int i = 0; i < kIterations; ++i) {
+        double mid = 0.5 * (low + high);
+        if (f(mid) < y) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    return 0.5 * (low + high);
+}
+
+}  // namespace
+
 /**
  * Constructs SCurveProfile.
  *
@@ -19,58 +44,74 @@ SCurveProfile::SCurveProfile(double maxV, double maxA, double timeToMaxA) {
     SetTimeToMaxA(timeToMaxA);
 }
 
-/**
- * Sets goal state of profile.
- *
- * @param goal a distance to which to travel
- * @param currentSource the current position
- */
-void SCurveProfile::SetGoal(double goal, double currentSource) {
-    std::scoped_lock lock(m_mutex);
+void SCurveProfile::Plan(double distance, double startVelocity,
+                         double startAcceleration, double goalVelocity) {
+    double maxVelocity = m_maxVelocity.load(std::memory_order_relaxed);
+    m_acceleration = m_maxAcceleration.load(std::memory_order_relaxed);
+    m_jerk = m_acceleration / m_maxTimeToMaxA.load(std::memory_order_relaxed);
 
-    // Subtract current source for profile calculations
-    m_goal = goal - currentSource;
+    double v0 = startVelocity;
+    double vf = std::clamp(goalVelocity, -maxVelocity, maxVelocity);
 
-    // Set setpoint to current distance since setpoint hasn't moved yet
-    m_ref = std::make_tuple(currentSource, 0.0, 0.0);
+    // Bring the acceleration to zero first. The rest of the profile starts
+    // from the resulting state.
+    if (startAcceleration != 0.0) {
+        double t = std::abs(startAcceleration) / m_jerk;
+        double jerk = -std::copysign(m_jerk, startAcceleration);
+        AddSegment(t, startAcceleration, jerk);
 
-    if (m_goal < 0.0) {
-        m_sign = -1.0;
-    } else {
-        m_sign = 1.0;
+        distance -= (v0 + (startAcceleration / 2.0 + jerk * t / 6.0) * t) * t;
+        v0 += startAcceleration * t / 2.0;
     }
 
-    // If profile can't accelerate up to max velocity before decelerating
-    bool shortProfile =
-        m_maxVelocity * (m_timeToMaxA + m_maxVelocity / m_acceleration) >
-        m_sign * m_goal;
-
-    if (shortProfile) {
-        m_profileMaxVelocity =
-            m_acceleration * (std::sqrt(m_sign * m_goal / m_acceleration -
-                                        0.75 * std::pow(m_timeToMaxA, 2)) -
-                              0.5 * m_timeToMaxA);
+    // Changing velocity from v to w is symmetric about its midpoint, so it
+    // covers the average velocity times the time taken
+    auto distanceTo = [&](double v, double w) {
+        return 0.5 * (v + w) * TimeToChange(w - v);
+    };
+    auto distanceVia = [&](double v) {
+        return distanceTo(v0, v) + distanceTo(v, vf);
+    };
+
+    /* The profile changes velocity from v0 to a peak velocity vp, maintains
+     * it, then changes from vp to vf. If changing directly from v0 to vf
+     * covers at most the distance, vp is at least both of them. Otherwise, the
+     * profile would overshoot, so vp is a minimum below both of them instead.
+     * The profile backs up if vp is negative.
+     *
+     * If the profile can't reach max velocity, search for the vp at which it
+     * covers the distance without the middle phase. The distance increases
+     * monotonically with vp in either case.
+     *
+     * If v0 is beyond max velocity, vp is between vf and max velocity instead,
+     * so the profile slows down to it first. Via vf, the profile covers the
+     * same distance as changing directly to vf, so that end of the search
+     * range still brackets the solution.
+     */
+    double peakVelocity;
+    if (distance >= distanceTo(v0, vf)) {
+        peakVelocity = maxVelocity;
+        if (distanceVia(maxVelocity) > distance) {
+            double low = v0 > maxVelocity ? vf : std::max(v0, vf);
+            peakVelocity = Solve(distanceVia, distance, low, maxVelocity);
+        }
     } else {
-        m_profileMaxVelocity = m_maxVelocity;
+        peakVelocity = -maxVelocity;
+        if (distanceVia(-maxVelocity) < distance) {
+            double high = v0 < -maxVelocity ? vf : std::min(v0, vf);
+            peakVelocity = Solve(distanceVia, distance, -maxVelocity, high);
+        }
     }
 
-    // Find times at critical points
-    m_t2 = m_profileMaxVelocity / m_acceleration;
-    m_t3 = m_t2 + m_timeToMaxA;
-    if (shortProfile) {
-        m_t4 = m_t3;
-    } else {
-        m_t4 = m_sign * m_goal / m_profileMaxVelocity;
+    double timeAtMaxV = 0.0;
+    if (peakVelocity != 0.0) {
+        timeAtMaxV = (distance - distanceVia(peakVelocity)) / peakVelocity;
+        timeAtMaxV = std::max(timeAtMaxV, 0.0);
     }
-    m_t5 = m_t4 + m_timeToMaxA;
-    m_t6 = m_t4 + m_t2;
-    m_t7 = m_t6 + m_timeToMaxA;
-    m_timeTotal = m_t7;
-
-    // Restore desired goal
-    m_goal = goal;
 
-    Reset();
+    AddVelocityChange(peakVelocity - v0);
+    AddSegment(timeAtMaxV, 0.0, 0.0);
+    AddVelocityChange(vf - peakVelocity);
 }
 
 /**
@@ -79,16 +120,14 @@ void SCurveProfile::SetGoal(double goal, double currentSource) {
  * @param velocity maximum velocity
  */
 void SCurveProfile::SetMaxVelocity(double velocity) {
-    std::scoped_lock lock(m_mutex);
-    m_maxVelocity = velocity;
+    m_maxVelocity.store(velocity, std::memory_order_relaxed);
 }
 
 /**
  * Returns maximum velocity of profile.
  */
 double SCurveProfile::GetMaxVelocity() const {
-    std::scoped_lock lock(m_mutex);
-    return m_maxVelocity;
+    return m_maxVelocity.load(std::memory_order_relaxed);
 }
 
 /**
@@ -97,9 +136,7 @@ double SCurveProfile::GetMaxVelocity() const {
  * @param acceleration maximum acceleration
  */
 void SCurveProfile::SetMaxAcceleration(double acceleration) {
-    std::scoped_lock lock(m_mutex);
-    m_acceleration = acceleration;
-    m_jerk = m_acceleration / m_timeToMaxA;
+    m_maxAcceleration.store(acceleration, std::memory_order_relaxed);
 }
 
 /**
@@ -108,53 +145,42 @@ void SCurveProfile::SetMaxAcceleration(double acceleration) {
  * @param timeToMaxA time to maximum acceleration
  */
 void SCurveProfile::SetTimeToMaxA(double timeToMaxA) {
-    std::scoped_lock lock(m_mutex);
-    m_timeToMaxA = timeToMaxA;
-    m_jerk = m_acceleration / m_timeToMaxA;
+    m_maxTimeToMaxA.store(timeToMaxA, std::memory_order_relaxed);
 }
 
-MotionProfile::State SCurveProfile::UpdateSetpoint(double currentTime) {
-    if (currentTime < m_timeToMaxA) {
-        // Ramp up acceleration
-        std::get<2>(m_ref) = m_jerk * currentTime;
-        std::get<1>(m_ref) = 0.5 * m_jerk * std::pow(currentTime, 2);
-    } else if (currentTime < m_t2) {
-        // Increase speed at max acceleration
-        std::get<2>(m_ref) = m_acceleration;
-        std::get<1>(m_ref) =
-            m_acceleration * (currentTime - 0.5 * m_timeToMaxA);
-    } else if (currentTime < m_t3) {
-        // Ramp down acceleration
-        std::get<2>(m_ref) = m_acceleration - m_jerk * (m_t2 - currentTime);
-        std::get<1>(m_ref) = m_acceleration * m_t2 -
-                             0.5 * m_jerk * std::pow(m_t2 - currentTime, 2);
-    } else if (currentTime < m_t4) {
-        // Maintain max velocity
-        std::get<2>(m_ref) = 0.0;
-        std::get<1>(m_ref) = m_profileMaxVelocity;
-    } else if (currentTime < m_t5) {
-        // Ramp down acceleration
-        std::get<2>(m_ref) = -m_jerk * (currentTime - m_t4);
-        std::get<1>(m_ref) = m_profileMaxVelocity -
-                             0.5 * m_jerk * std::pow(currentTime - m_t4, 2);
-    } else if (currentTime < m_t6) {
-        // Decrease speed at max acceleration
-        std::get<2>(m_ref) = m_acceleration;
-        std::get<1>(m_ref) = m_acceleration * (m_t2 + m_t5 - currentTime);
-    } else if (currentTime < m_t7) {
-        // Ramp up acceleration
-        std::get<2>(m_ref) = m_jerk * (m_t6 - currentTime);
-        std::get<1>(m_ref) = 0.5 * m_jerk * std::pow(m_t6 - currentTime, 2);
+/**
+ * Returns the time taken to change velocity by the given amount.
+ */
+double SCurveProfile::TimeToChange(double deltaVelocity) const {
+    double dv = std::abs(deltaVelocity);
+    if (dv >= m_acceleration * m_acceleration / m_jerk) {
+        // Ramp acceleration up and down, reaching max acceleration between
+        return dv / m_acceleration + m_acceleration / m_jerk;
     } else {
-        std::get<2>(m_ref) = 0.0;
-        std::get<1>(m_ref) = 0.0;
+        // Ramp acceleration up and immediately back down
+        return 2.0 * std::sqrt(dv / m_jerk);
     }
+}
 
-    if (currentTime < m_t7) {
-        std::get<0>(m_ref) +=
-            m_sign * std::get<1>(m_ref) * (currentTime - m_lastTime);
-        m_lastTime = currentTime;
+/**
+ * Appends the segments that change velocity by the given amount.
+ */
+void SCurveProfile::AddVelocityChange(double deltaVelocity) {
+    double dv = std::abs(deltaVelocity);
+    double acceleration = std::copysign(m_acceleration, deltaVelocity);
+    double jerk = std::copysign(m_jerk, deltaVelocity);
+
+    double timeToMaxA = m_acceleration / m_jerk;
+    double timeAtMaxA = dv / m_acceleration - timeToMaxA;
+    if (timeAtMaxA < 0.0) {
+        // Max acceleration isn't reached
+        timeToMaxA = std::sqrt(dv / m_jerk);
+        acceleration = jerk * timeToMaxA;
+        timeAtMaxA = 0.0;
     }
 
-    return m_ref;
+    AddSegment(timeToMaxA, 0.0, jerk);
+    AddSegment(timeAtMaxA, acceleration, 0.0);
+    AddSegment(timeToMaxA, acceleration, -jerk);
 }
+
@@ -16,34 +16,38 @@ SumNode::SumNode(INode& input, bool positive) {
     m_inputs.emplace_back(input, positive);
 }
 
+void SumNode::GetInputNodes(std::vector<INode*>& nodes) {
+    for (auto& input : m_inputs) {
+        nodes.emplace_back(&input.first);
+    }
+}
+
 double SumNode::GetOutput() {
     double sum = 0.0;
 
     for (auto& input : m_inputs) {
         if (input.second) {
-            sum += input.first.GetOutput();
+            sum += input.first.Evaluate();
         } else {
-            sum -= input.first.GetOutput();
+            sum -= input.first.Evaluate();
         }
     }
 
-    std::scoped_lock lock(m_mutex);
+    return Update(sum);
+}
 
-    m_lastResult = m_currentResult;
-    m_currentResult = sum;
+double SumNode::Compute(const double* inputs) {
+    double sum = 0.0;
 
-    if (m_continuous && m_inputRange != 0) {
-        sum = std::fmod(sum, m_inputRange);
-        if (std::abs(sum) > m_inputRange / 2.0) {
-            if (sum > 0.0) {
-                return sum - m_inputRange;
-            } else {
-                return sum + m_inputRange;
-            }
+    for (size_t i = 0; i < m_inputs.size(); ++i) {
+        if (m_inputs[i].second) {
+            sum += inputs[i];
+        } else {
+            sum -= inputs[i];
         }
     }
 
-    return sum;
+    return Update(sum);
 }
 
 /**
@@ -56,8 +60,7 @@ double SumNode::GetOutput() {
  * @param continuous true turns on continuous; false turns off continuous
  */
 void SumNode::SetContinuous(bool continuous) {
-    std::scoped_lock sync(m_mutex);
-    m_continuous = continuous;
+    m_continuous.store(continuous, std::memory_order_relaxed);
 }
 
 /**
@@ -67,8 +70,7 @@ void SumNode::SetContinuous(bool continuous) {
  * @param maximumInput the maximum value expected from the input
  */
 void SumNode::SetInputRange(double minimumInput, double maximumInput) {
-    std::scoped_lock sync(m_mutex);
-    m_inputRange = maximumInput - minimumInput;
+    m_inputRange.store(maximumInput - minimumInput, std::memory_order_relaxed);
 }
 
 /**
@@ -79,10 +81,7 @@ void SumNode::SetInputRange(double minimumInput, double maximumInput) {
  * @param deltaTolerance change in absolute error which is tolerable
  */
 void SumNode::SetTolerance(double tolerance, double deltaTolerance) {
-    std::scoped_lock lock(m_mutex);
-
-    m_tolerance = tolerance;
-    m_deltaTolerance = deltaTolerance;
+    m_tolerance.Store(Tolerance{tolerance, deltaTolerance});
 }
 
 /**
@@ -90,7 +89,31 @@ void SumNode::SetTolerance(double tolerance, double deltaTolerance) {
  * by SetTolerance().
  */
 bool SumNode::InTolerance() const {
-    std::scoped_lock lock(m_mutex);
-    return std::abs(m_currentResult) < m_tolerance &&
-           std::abs(m_currentResult - m_lastResult) < m_deltaTolerance;
+    auto result = m_result.Load();
+    auto tolerance = m_tolerance.Load();
+
+    return std::abs(result.current) < tolerance.tolerance &&
+           std::abs(result.current - result.last) < tolerance.deltaTolerance;
+}
+
+/**
+ * Records the sum for InTolerance() and wraps it if the input is continuous.
+ */
+double SumNode::Update(double sum) {
+    m_result.Store(Result{sum, m_currentResult});
+    m_currentResult = sum;
+
+    double inputRange = m_inputRange.load(std::memory_order_relaxed);
+    if (m_continuous.load(std::memory_order_relaxed) && inputRange != 0) {
+        sum = std::fmod(sum, inputRange);
+        if (std::abs(sum) > inputRange / 2.0) {
+            if (sum > 0.0) {
+                return sum - inputRange;
+            } else {
+                return sum + inputRange;
+            }
+        }
+    }
+
+    return sum;
 }
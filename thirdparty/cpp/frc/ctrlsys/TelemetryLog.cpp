@@ -0,0 +1,232 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/TelemetryLog.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "frc/DriverStation.h"
+
+using namespace frc;
+
+/**
+ * Opens a telemetry log and starts its drain thread.
+ *
+ * The file is created or truncated by the drain thread, so the constructor
+ * doesn't wait on the filesystem. If it can't be opened, a warning is sent to
+ * the Driver Station and Log() returns false from then on.
+ *
+ * @param path         the file to write
+ * @param fields       the name of each value in a record
+ * @param capacity     the number of records the ring holds
+ * @param maxBandwidth the largest average write rate in bytes per second
+ */
+TelemetryLog::TelemetryLog(std::string path, std::vector<std::string> fields,
+                           size_t capacity, double maxBandwidth)
+    : m_path(std::move(path)),
+      m_fields(std::move(fields)),
+      m_recordSize(sizeof(double) + m_fields.size() * sizeof(float)),
+      m_capacity(capacity),
+      m_maxBandwidth(maxBandwidth),
+      m_ring(m_capacity * m_recordSize) {
+    m_writeBuffer.reserve(m_ring.size());
+    m_thread = std::thread{[this] { Run(); }};
+}
+
+/**
+ * Stops the drain thread after writing every record left in the ring,
+ * regardless of the bandwidth limit.
+ */
+TelemetryLog::~TelemetryLog() {
+    {
+        std::scoped_lock lock{m_mutex};
+        m_stop = true;
+    }
+    m_stopCond.notify_one();
+    m_thread.join();
+}
+
+/**
+ * Queues a record for writing.
+ *
+ * This never blocks or allocates. The values are stored as floats.
+ *
+ * Returns false if the record was dropped because the ring is full, the number
+ * of values doesn't match the number of fields, or the file couldn't be
+ * written.
+ *
+ * @param timestamp the time of the record in seconds
+ * @param values    one value per field, in the order the fields were given
+ */
+bool TelemetryLog::Log(double timestamp, wpi::ArrayRef<double> values) {
+    if (values.size() != m_fields.size() ||
+        m_failed.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == m_capacity) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint8_t* record = &m_ring[(head % m_capacity) * m_recordSize];
+    std::memcpy(record, &timestamp, sizeof(timestamp));
+    record += sizeof(timestamp);
+    for (double value : values) {
+        float sample = static_cast<float>(value);
+        std::memcpy(record, &sample, sizeof(sample));
+        record += sizeof(sample);
+    }
+
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * Returns the number of values in each record.
+ */
+size_t TelemetryLog::GetFieldCount() const { return m_fields.size(); }
+
+/**
+ * Returns the size of each record in the file in bytes.
+ */
+size_t TelemetryLog::GetRecordSize() const { return m_recordSize; }
+
+/**
+ * Returns the number of records dropped because the ring was full.
+ */
+uint64_t TelemetryLog::GetDroppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the number of records written to the file.
+ */
+uint64_t TelemetryLog::GetWrittenCount() const {
+    return m_written.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns "<prefix>-<N>.tlog" for the next log in a rotation of maxFiles
+ * files, so each boot of the robot gets its own log without filling the disk.
+ *
+ * The rotation always leaves one file missing. The first missing file is the
+ * next log, and the file after it (wrapping around) is deleted to make the gap
+ * for the following boot, so the newest maxFiles - 1 logs are kept. File
+ * modification times aren't used since the clock may not be set at boot.
+ *
+ * @param prefix   the path and file name before the number
+ * @param maxFiles the number of file names to rotate through; at least 2
+ */
+std::string TelemetryLog::NextPath(const std::string& prefix, int maxFiles) {
+    assert(maxFiles >= 2);
+
+    auto makePath = [&](int i) {
+        return prefix + "-" + std::to_string(i) + ".tlog";
+    };
+
+    // If every file exists, such as after maxFiles was lowered, start over
+    int next = 0;
+    for (int i = 0; i < maxFiles; ++i) {
+        if (!std::ifstream{makePath(i)}) {
+            next = i;
+            break;
+        }
+    }
+
+    std::remove(makePath((next + 1) % maxFiles).c_str());
+    return makePath(next);
+}
+
+void TelemetryLog::Run() {
+    m_file.open(m_path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        m_failed = true;
+        DriverStation::ReportWarning("Couldn't open telemetry log " + m_path);
+        return;
+    }
+
+    auto writeUint32 = [&](uint32_t value) {
+        m_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    m_file.write("TLOG", 4);
+    writeUint32(kVersion);
+    writeUint32(static_cast<uint32_t>(m_fields.size()));
+    writeUint32(static_cast<uint32_t>(m_recordSize));
+    for (const auto& field : m_fields) {
+        m_file.write(field.c_str(), field.size() + 1);
+    }
+    m_file.flush();
+
+    // Token bucket for the bandwidth limit. It holds at most one drain
+    // period's worth of bytes so writes don't burst after an idle period.
+    double maxBudget = std::max(m_maxBandwidth * kDrainPeriod,
+                                static_cast<double>(m_recordSize));
+    auto lastDrain = std::chrono::steady_clock::now();
+
+    std::unique_lock lock{m_mutex};
+    while (!m_stop) {
+        m_stopCond.wait_for(lock,
+                            std::chrono::duration<double>(kDrainPeriod));
+        if (m_stop) {
+            break;
+        }
+        lock.unlock();
+
+        auto now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - lastDrain).count();
+        lastDrain = now;
+        m_budget = std::min(m_budget + m_maxBandwidth * elapsed, maxBudget);
+
+        auto maxRecords = static_cast<size_t>(m_budget / m_recordSize);
+        m_budget -= Drain(maxRecords) * m_recordSize;
+
+        lock.lock();
+    }
+    lock.unlock();
+
+    Drain(std::numeric_limits<size_t>::max());
+    m_file.close();
+}
+
+/**
+ * Writes up to maxRecords records from the ring to the file and returns the
+ * number written.
+ *
+ * The records are copied out and released to the producer before the file is
+ * written, so a slow write never fills the ring by itself.
+ */
+size_t TelemetryLog::Drain(size_t maxRecords) {
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    uint64_t available = m_head.load(std::memory_order_acquire) - tail;
+    size_t count = std::min<uint64_t>(available, maxRecords);
+    if (count == 0 || m_failed) {
+        return 0;
+    }
+
+    // The records may wrap around the end of the ring
+    size_t start = tail % m_capacity;
+    size_t first = std::min(count, m_capacity - start);
+    m_writeBuffer.assign(m_ring.begin() + start * m_recordSize,
+                         m_ring.begin() + (start + first) * m_recordSize);
+    m_writeBuffer.insert(m_writeBuffer.end(), m_ring.begin(),
+                         m_ring.begin() + (count - first) * m_recordSize);
+    m_tail.store(tail + count, std::memory_order_release);
+
+    m_file.write(reinterpret_cast<const char*>(m_writeBuffer.data()),
+                 m_writeBuffer.size());
+    m_file.flush();
+    if (!m_file) {
+        m_failed = true;
+        DriverStation::ReportWarning("Couldn't write telemetry log " + m_path);
+        return 0;
+    }
+    m_written.fetch_add(count, std::memory_order_relaxed);
+    return count;
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/TickPeriod.h"
+
+#include "frc/ctrlsys/INode.h"
+
+using namespace frc;
+
+/**
+ * Construct a TickPeriod.
+ *
+ * @param nominal the loop time for doing calculations.
+ */
+TickPeriod::TickPeriod(units::second_t nominal)
+    : m_nominal(nominal.to<double>()) {}
+
+/**
+ * Selects whether to use the measured time between control cycles instead of
+ * the nominal period.
+ *
+ * @param measured true to use the measured period
+ */
+void TickPeriod::SetMeasured(bool measured) {
+    m_measured.store(measured, std::memory_order_relaxed);
+}
+
+/**
+ * Returns true if the measured time between control cycles is used.
+ */
+bool TickPeriod::IsMeasured() const {
+    return m_measured.load(std::memory_order_relaxed);
+}
+
+/**
+ * Returns the time step in seconds for the current control cycle.
+ */
+double TickPeriod::Update() {
+    if (!IsMeasured()) {
+        return m_nominal;
+    }
+
+    double timestamp = INode::GetTickTimestamp().to<double>();
+    double lastTimestamp = m_lastTimestamp;
+    m_lastTimestamp = timestamp;
+
+    if (timestamp == 0.0 || lastTimestamp == 0.0) {
+        return m_nominal;
+    }
+
+    double period = timestamp - lastTimestamp;
+    if (period <= 0.0 || period > kMaxGapPeriods * m_nominal) {
+        return m_nominal;
+    }
+
+    return period;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#include "frc/ctrlsys/TrajectoryCache.h"
+
+#include <chrono>
+#include <mutex>
+#include <utility>
+
+#include "frc/DriverStation.h"
+
+using namespace frc;
+
+/**
+ * Starts generating a trajectory on a background thread.
+ *
+ * Replaces any trajectory with the same name.
+ *
+ * @param name        name with which to retrieve the trajectory
+ * @param waypoints   poses to pass through in order
+ * @param constraints limits on the robot's motion
+ */
+void TrajectoryCache::Generate(
+    wpi::StringRef name, std::vector<Pose> waypoints,
+    const DriveTrajectory::Constraints& constraints) {
+    auto trajectory =
+        std::async(std::launch::async,
+                   [waypoints = std::move(waypoints), constraints] {
+                       return DriveTrajectory::Generate(waypoints, constraints);
+                   })
+            .share();
+
+    std::scoped_lock lock{m_mutex};
+    m_trajectories[name] = std::move(trajectory);
+}
+
+/**
+ * Starts loading a trajectory saved with DriveTrajectory::Save() on a
+ * background thread.
+ *
+ * If the file is missing or was generated from different waypoints or
+ * constraints, a warning is reported and the trajectory is generated instead.
+ * Replaces any trajectory with the same name.
+ *
+ * @param name        name with which to retrieve the trajectory
+ * @param path        path to the saved trajectory
+ * @param waypoints   poses the saved trajectory passes through in order
+ * @param constraints limits on the robot's motion
+ */
+void TrajectoryCache::Load(wpi::StringRef name, std::string path,
+                           std::vector<Pose> waypoints,
+                           const DriveTrajectory::Constraints& constraints) {
+    auto trajectory =
+        std::async(
+            std::launch::async,
+            [path = std::move(path), waypoints = std::move(waypoints),
+             constraints] {
+                auto hash = DriveTrajectory::Hash(waypoints, constraints);
+                if (auto trajectory = DriveTrajectory::Load(path, hash)) {
+                    return *trajectory;
+                }
+
+                DriverStation::ReportWarning(
+                    "Trajectory " + path +
+                    " is missing or out of date, generating it instead");
+                return DriveTrajectory::Generate(waypoints, constraints);
+            })
+            .share();
+
+    std::scoped_lock lock{m_mutex};
+    m_trajectories[name] = std::move(trajectory);
+}
+
+/**
+ * Returns the named trajectory, waiting for it to finish generating if
+ * necessary.
+ *
+ * Returns nullptr if no trajectory with the name was requested. The
+ * trajectory remains valid until it's replaced or the cache is destroyed.
+ *
+ * @param name name passed to Generate() or Load()
+ */
+const DriveTrajectory* TrajectoryCache::Get(wpi::StringRef name) {
+    auto trajectory = Find(name);
+    if (!trajectory.valid()) {
+        return nullptr;
+    }
+
+    return &trajectory.get();
+}
+
+/**
+ * Returns true if the named trajectory has finished generating.
+ *
+ * @param name name passed to Generate() or Load()
+ */
+bool TrajectoryCache::IsReady(wpi::StringRef name) {
+    auto trajectory = Find(name);
+    return trajectory.valid() && trajectory.wait_for(std::chrono::seconds{0}) ==
+                                     std::future_status::ready;
+}
+
+/**
+ * Reads the named trajectory's states into memory if it's ready.
+ *
+ * Loaded trajectories are read from their files on first use, which can stall
+ * the control thread. This doesn't wait for the trajectory, so it's safe to
+ * call periodically while disabled.
+ *
+ * @param name name passed to Generate() or Load()
+ */
+void TrajectoryCache::Prefetch(wpi::StringRef name) {
+    auto trajectory = Find(name);
+    if (trajectory.valid() && trajectory.wait_for(std::chrono::seconds{0}) ==
+                                  std::future_status::ready) {
+        trajectory.get().Prefetch();
+    }
+}
+
+std::shared_future<DriveTrajectory> TrajectoryCache::Find(wpi::StringRef name) {
+    std::scoped_lock lock{m_mutex};
+
+    auto it = m_trajectories.find(name);
+    if (it == m_trajectories.end()) {
+        return {};
+    }
+    return it->second;
+}
@@ -2,6 +2,7 @@
 
 #include "frc/ctrlsys/TrapezoidProfile.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace frc;
@@ -11,127 +12,79 @@ TrapezoidProfile::TrapezoidProfile(double maxV, double timeToMaxV) {
     SetTimeToMaxV(timeToMaxV);
 }
 
-/**
- * Sets goal state of profile.
- *
- * @param goal a distance to which to travel
- * @param currentSource the current position
- */
-void TrapezoidProfile::SetGoal(double goal, double currentSource) {
-    std::scoped_lock lock(m_mutex);
-
-    // Subtract current source for profile calculations
-    m_goal = goal - currentSource;
+void TrapezoidProfile::Plan(double distance, double startVelocity,
+                            double startAcceleration, double goalVelocity) {
+    double maxVelocity = m_maxVelocity.load(std::memory_order_relaxed);
+    double acceleration = m_maxAcceleration.load(std::memory_order_relaxed);
 
-    // Set setpoint to current distance since setpoint hasn't moved yet
-    m_ref = std::make_tuple(currentSource, 0.0, 0.0);
+    double v0 = startVelocity;
+    double vf = std::clamp(goalVelocity, -maxVelocity, maxVelocity);
 
-    if (m_goal < 0.0) {
-        m_sign = -1.0;
-    } else {
-        m_sign = 1.0;
-    }
-    m_timeToMaxVelocity = m_velocity / m_acceleration;
+    // Changing velocity from v to w at max acceleration covers the average
+    // velocity times the time taken
+    auto distanceTo = [&](double v, double w) {
+        return 0.5 * (v + w) * std::abs(w - v) / acceleration;
+    };
 
-    /* d is distance traveled when accelerating to/from max velocity
-     *       = 1/2 * (v0 + v) * t
-     * t is m_timeToMaxVelocity
-     * delta is distance traveled at max velocity
-     * delta = totalDist - 2 * d
-     *       = setpoint - 2 * ((v0 + v)/2 * t)
-     * v0 = 0 therefore:
-     * delta = setpoint - 2 * (v/2 * t)
-     *       = setpoint - v * t
-     *       = m_setpoint - m_velocity * m_timeToMaxVelocity
+    /* The profile changes velocity from v0 to a peak velocity vp, maintains
+     * it, then changes from vp to vf. If changing directly from v0 to vf
+     * covers at most the distance, vp is at least both of them, and without
+     * the middle phase
      *
-     * t is time at maximum velocity
-     * t = delta (from previous comment) / m_velocity (where m_velocity is
-     * maximum velocity) = (m_setpoint - m_velocity * m_timeToMaxVelocity) /
-     * m_velocity = m_setpoint/m_velocity - m_timeToMaxVelocity
-     */
-    double timeAtMaxV = m_sign * m_goal / m_velocity - m_timeToMaxVelocity;
-
-    /* if ( 1/2 * a * t^2 > m_setpoint / 2 ) // if distance travelled before
-     *     reaching maximum speed is more than half of the total distance to
-     *     travel
-     * if ( a * t^2 > m_setpoint )
-     * if ( a * (v/a)^2 > m_setpoint )
-     * if ( a * v^2/a^2 > m_setpoint )
-     * if ( v^2/a > m_setpoint )
-     * if ( v * v/a > m_setpoint )
-     * if ( v * m_timeToMaxVelocity > m_setpoint )
+     *   d = (vp^2 - v0^2) / (2a) + (vp^2 - vf^2) / (2a)
+     *   vp = sqrt(a * d + (v0^2 + vf^2) / 2)
+     *
+     * Otherwise, the profile would overshoot, so vp is a minimum below both
+     * of them instead. The profile backs up if vp is negative.
+     *
+     *   d = (v0^2 - vp^2) / (2a) + (vf^2 - vp^2) / (2a)
+     *   vp = -sqrt((v0^2 + vf^2) / 2 - a * d)
      */
-    if (m_velocity * m_timeToMaxVelocity > m_sign * m_goal) {
-        /* Solve for t:
-         * 1/2 * a * t^2 = m_setpoint/2
-         * a * t^2 = m_setpoint
-         * t^2 = m_setpoint / a
-         * t = std::sqrt( m_setpoint / a )
-         */
-        m_timeToMaxVelocity = std::sqrt(m_sign * m_goal / m_acceleration);
-        m_timeFromMaxVelocity = m_timeToMaxVelocity;
-        m_timeTotal = 2 * m_timeToMaxVelocity;
-        m_profileMaxVelocity = m_acceleration * m_timeToMaxVelocity;
+    double peakVelocity;
+    if (distance >= distanceTo(v0, vf)) {
+        peakVelocity =
+            std::sqrt(acceleration * distance + 0.5 * (v0 * v0 + vf * vf));
     } else {
-        m_timeFromMaxVelocity = m_timeToMaxVelocity + timeAtMaxV;
-        m_timeTotal = m_timeFromMaxVelocity + m_timeToMaxVelocity;
-        m_profileMaxVelocity = m_velocity;
+        peakVelocity = -std::sqrt(
+            std::max(0.5 * (v0 * v0 + vf * vf) - acceleration * distance, 0.0));
     }
+    peakVelocity = std::clamp(peakVelocity, -maxVelocity, maxVelocity);
 
-    // Restore desired goal
-    m_goal = goal;
+    double timeAtMaxV = 0.0;
+    if (peakVelocity != 0.0) {
+        timeAtMaxV = (distance - distanceTo(v0, peakVelocity) -
+                      distanceTo(peakVelocity, vf)) /
+                     peakVelocity;
+    }
 
-    Reset();
+    // Accelerate to the peak velocity, maintain it, then accelerate to the
+    // goal velocity
+    AddSegment(std::abs(peakVelocity - v0) / acceleration,
+               std::copysign(acceleration, peakVelocity - v0), 0.0);
+    AddSegment(timeAtMaxV, 0.0, 0.0);
+    AddSegment(std::abs(vf - peakVelocity) / acceleration,
+               std::copysign(acceleration, vf - peakVelocity), 0.0);
 }
+
 /**
  * Sets maximum velocity of profile.
  */
 void TrapezoidProfile::SetMaxVelocity(double velocity) {
-    std::scoped_lock lock(m_mutex);
-    m_velocity = velocity;
+    m_maxVelocity.store(velocity, std::memory_order_relaxed);
 }
 
 /**
  * Returns maximum velocity of profile.
  */
 double TrapezoidProfile::GetMaxVelocity() const {
-    std::scoped_lock lock(m_mutex);
-    return m_velocity;
+    return m_maxVelocity.load(std::memory_order_relaxed);
 }
 
 /**
  * Sets time to max velocity of profile from rest.
  */
 void TrapezoidProfile::SetTimeToMaxV(double timeToMaxV) {
-    std::scoped_lock lock(m_mutex);
-    m_acceleration = m_velocity / timeToMaxV;
-}
-
-MotionProfile::State TrapezoidProfile::UpdateSetpoint(double currentTime) {
-    if (currentTime < m_timeToMaxVelocity) {
-        // Accelerate up
-        std::get<2>(m_ref) = m_acceleration;
-        std::get<1>(m_ref) = std::get<2>(m_ref) * currentTime;
-    } else if (currentTime < m_timeFromMaxVelocity) {
-        // Maintain max velocity
-        std::get<2>(m_ref) = 0.0;
-        std::get<1>(m_ref) = m_profileMaxVelocity;
-    } else if (currentTime < m_timeTotal) {
-        // Accelerate down
-        double decelTime = currentTime - m_timeFromMaxVelocity;
-        std::get<2>(m_ref) = -m_acceleration;
-        std::get<1>(m_ref) =
-            m_profileMaxVelocity + std::get<2>(m_ref) * decelTime;
-    } else {
-        std::get<2>(m_ref) = 0.0;
-        std::get<1>(m_ref) = 0.0;
-    }
-
-    if (currentTime < m_timeTotal) {
-        std::get<0>(m_ref) +=
-            m_sign * std::get<1>(m_ref) * (currentTime - m_lastTime);
-        m_lastTime = currentTime;
-    }
-
-    return m_ref;
+    m_maxAcceleration.store(
+        m_maxVelocity.load(std::memory_order_relaxed) / timeToMaxV,
+        std::memory_order_relaxed);
 }
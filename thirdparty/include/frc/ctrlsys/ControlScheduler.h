@@ -0,0 +1,96 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <units/time.h>
+#include <wpi/condition_variable.h>
+#include <wpi/mutex.h>
+
+#include "frc/Notifier.h"
+
+namespace frc {
+
+/**
+ * Runs every periodic control task in one real-time thread.
+ *
+ * Tasks can have different periods (e.g., 5 ms, 10 ms, and 50 ms). Each task
+ * is released once per period and has until its next release to finish. When
+ * several tasks are due at once, they run in order of their deadlines, so
+ * tasks with shorter periods run first (rate-monotonic priority). Between
+ * releases, the thread sleeps on a single HAL notifier alarm set for the
+ * earliest upcoming release.
+ *
+ * A task that finishes after its deadline has overrun. Its missed releases are
+ * skipped instead of run back-to-back, the overrun is counted, and a warning
+ * is sent to the Driver Station.
+ *
+ * Tasks run without the scheduler's lock held, so a task may schedule or
+ * unschedule tasks, including itself.
+ *
+ * Output and OutputGroup register with the scheduler in Enable() instead of
+ * owning a Notifier.
+ */
+class ControlScheduler {
+public:
+    /**
+     * The scheduler thread's real-time priority. Higher numbers are higher
+     * priority.
+     */
+    static constexpr int kPriority = 40;
+
+    static ControlScheduler& GetInstance();
+
+    ControlScheduler(const ControlScheduler&) = delete;
+    ControlScheduler& operator=(const ControlScheduler&) = delete;
+
+    void Schedule(const void* owner, std::function<void()> task,
+                  units::second_t period);
+    void Unschedule(const void* owner);
+
+    uint64_t GetOverrunCount(const void* owner) const;
+
+private:
+    struct Task {
+        const void* owner;
+        std::function<void()> func;
+        double period;
+        double release;
+        uint64_t overruns;
+
+        // Set when the task is unscheduled by itself or another task while
+        // it's running. It's erased once it returns.
+        bool removed = false;
+    };
+
+    mutable wpi::mutex m_mutex;
+
+    // Tasks are heap-allocated so the running one stays put while the lock is
+    // released
+    std::vector<std::unique_ptr<Task>> m_tasks;
+
+    // The task being run, if any, and the thread running it
+    const Task* m_running = nullptr;
+    std::thread::id m_threadId;
+    wpi::condition_variable m_taskDone;
+
+    // Time of the last overrun warning, used to rate limit them
+    double m_lastWarningTime = 0.0;
+
+    Notifier m_notifier;
+
+    ControlScheduler();
+
+    void Run();
+    uint64_t Remove(const void* owner, std::unique_lock<wpi::mutex>& lock);
+    void RescheduleAlarm(double now);
+};
+
+}  // namespace frc
@@ -2,16 +2,37 @@
 
 #pragma once
 
+#include "ControlScheduler.h"
 #include "DerivativeNode.h"
+#include "DriveOdometry.h"
+#include "DriveStateEstimator.h"
+#include "DriveTrajectory.h"
+#include "ExecutionPlan.h"
+#include "FeedforwardNode.h"
+#include "FilterDesign.h"
 #include "FuncNode.h"
 #include "GainNode.h"
+#include "HermiteSpline.h"
+#include "Histogram.h"
 #include "INode.h"
 #include "IntegralNode.h"
+#include "LQR.h"
 #include "LinearFilter.h"
+#include "LoopTiming.h"
+#include "Matrix.h"
 #include "NodeBase.h"
 #include "Output.h"
+#include "PIDBank.h"
 #include "PIDController.h"
 #include "PIDNode.h"
+#include "Pose.h"
+#include "PoseHistory.h"
+#include "RamseteFollower.h"
 #include "RefInput.h"
+#include "SecondOrderSection.h"
 #include "Sensor.h"
+#include "StaticGraph.h"
 #include "SumNode.h"
+#include "TelemetryLog.h"
+#include "TickPeriod.h"
+#include "TrajectoryCache.h"
@@ -2,17 +2,22 @@
 
 #pragma once
 
-#include <wpi/mutex.h>
+#include <atomic>
 
 #include <units/time.h>
 
 #include "frc/ctrlsys/INode.h"
 #include "frc/ctrlsys/NodeBase.h"
+#include "frc/ctrlsys/TickPeriod.h"
 
 namespace frc {
 
 /**
- * Returns the integral of the input node's output.
+ * Returns the derivative of the input node's output.
+ *
+ * The previous input is owned by the thread calling GetOutput(). The gain and
+ * Reset() are published to it through atomics, so they can be called from any
+ * thread without blocking the control loop.
  */
 class DerivativeNode : public NodeBase {
 public:
@@ -20,19 +25,21 @@ public:
     virtual ~DerivativeNode() = default;
 
     double GetOutput() override;
+    double Compute(const double* inputs) override;
 
     void SetGain(double K);
     double GetGain() const;
 
+    void UseMeasuredPeriod(bool measured = true);
+
     void Reset(void);
 
 private:
-    double m_gain;
-    units::second_t m_period;
+    std::atomic<double> m_gain;
+    TickPeriod m_period;
 
     double m_prevInput = 0.0;
-
-    mutable wpi::mutex m_mutex;
+    std::atomic<bool> m_resetRequested{false};
 };
 
 }  // namespace frc
@@ -0,0 +1,54 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <optional>
+
+#include "frc/ctrlsys/Pose.h"
+#include "frc/ctrlsys/PoseHistory.h"
+#include "frc/ctrlsys/SeqLock.h"
+
+namespace frc {
+
+/**
+ * Tracks a differential drive's pose from its encoders and a heading sensor.
+ *
+ * Updates given a timestamp are recorded in a PoseHistory, so the pose at a
+ * past time can be looked up to compensate a delayed measurement for the
+ * robot's motion since.
+ *
+ * Reset(), ResetSensors(), and Update() must be called from one thread,
+ * typically the control loop. GetPose() can be called from any thread without
+ * blocking it.
+ */
+class DriveOdometry {
+public:
+    explicit DriveOdometry(size_t historySize = 0);
+
+    void Reset(const Pose& pose, double leftDistance, double rightDistance,
+               double heading);
+    void ResetSensors(double leftDistance, double rightDistance,
+                      double heading);
+    Pose Update(double leftDistance, double rightDistance, double heading);
+    Pose Update(double leftDistance, double rightDistance, double heading,
+                double timestamp);
+
+    Pose GetPose() const;
+    std::optional<Pose> GetPose(double timestamp) const;
+
+private:
+    SeqLock<Pose> m_published;
+    PoseHistory m_history;
+
+    // Owned by the thread calling Update()
+    Pose m_pose{};
+    double m_lastLeft = 0.0;
+    double m_lastRight = 0.0;
+
+    // Difference between the pose's heading and the sensor's
+    double m_headingOffset = 0.0;
+};
+
+}  // namespace frc
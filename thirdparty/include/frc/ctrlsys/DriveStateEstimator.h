@@ -0,0 +1,165 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+
+#include <units/time.h>
+
+#include "frc/ctrlsys/FuncNode.h"
+#include "frc/ctrlsys/INode.h"
+#include "frc/ctrlsys/Pose.h"
+#include "frc/ctrlsys/SeqLock.h"
+#include "frc/ctrlsys/TickPeriod.h"
+
+namespace frc {
+
+/**
+ * An extended Kalman filter estimating a differential drive's state from its
+ * encoders and a gyro's rate.
+ *
+ * The state is the pose, the distance driven, and the forward and angular
+ * velocities. Between cycles, the robot is assumed to hold its velocities
+ * while random accelerations make them uncertain. Each cycle then corrects
+ * the prediction with the velocity of each side from its encoder's change in
+ * distance and from its rate, and with the gyro's rate. Changes in distance
+ * implausibly far from the prediction, such as the jump when an encoder is
+ * reset, are rejected.
+ *
+ * The measurements are applied one at a time, so no matrices are inverted and
+ * each update does the same small, fixed amount of work without allocating.
+ *
+ * The state is owned by the thread evaluating the estimator's nodes, which
+ * updates it once per control cycle. Reset() and GetEstimate() can be called
+ * from any thread without blocking it.
+ */
+class DriveStateEstimator {
+public:
+    static constexpr int kStates = 6;
+
+    using Matrix = std::array<std::array<double, kStates>, kStates>;
+
+    /**
+     * Standard deviations of the process and measurement noise.
+     */
+    struct StandardDeviations {
+        // Random forward acceleration in distance units per second^2
+        double acceleration;
+
+        // Random angular acceleration in radians per second^2
+        double angularAcceleration;
+
+        // Wheel velocity from an encoder's change in distance over a cycle
+        double encoderVelocity;
+
+        // Wheel velocity from an encoder's rate
+        double encoderRate;
+
+        // Gyro rate in radians per second
+        double gyroRate;
+    };
+
+    struct Estimate {
+        Pose pose;
+        double distance;
+        double velocity;
+        double angularVelocity;
+
+        // Covariance of (x, y, heading, distance, velocity, angular velocity)
+        Matrix covariance;
+    };
+
+    DriveStateEstimator(INode& leftDistance, INode& rightDistance,
+                        INode& leftRate, INode& rightRate, INode& gyroRate,
+                        double trackWidth, const StandardDeviations& stdDevs,
+                        units::second_t period = INode::kDefaultPeriod);
+
+    INode& GetDistanceNode();
+    INode& GetHeadingNode();
+    INode& GetVelocityNode();
+    INode& GetAngularVelocityNode();
+
+    void UseMeasuredPeriod(bool measured = true);
+
+    void Reset(const Pose& pose = Pose{});
+
+    Estimate GetEstimate() const;
+
+private:
+    enum Index {
+        kX,
+        kY,
+        kHeading,
+        kDistance,
+        kVelocity,
+        kAngularVelocity
+    };
+
+    using Vector = std::array<double, kStates>;
+
+    struct ResetRequest {
+        Pose pose;
+        uint64_t generation;
+    };
+
+    INode& m_leftDistance;
+    INode& m_rightDistance;
+    INode& m_leftRate;
+    INode& m_rightRate;
+    INode& m_gyroRate;
+
+    // Measurement rows for each side's velocity and the angular velocity
+    Vector m_leftRow{};
+    Vector m_rightRow{};
+    Vector m_angularRow{};
+
+    StandardDeviations m_stdDevs;
+    TickPeriod m_period;
+
+    SeqLock<ResetRequest> m_reset{ResetRequest{Pose{}, 0}};
+    std::atomic<uint64_t> m_resetCount{0};
+
+    SeqLock<Estimate> m_published{Estimate{}};
+
+    // The remaining members are owned by the thread evaluating the nodes
+
+    uint64_t m_generation = 0;
+
+    // False until the first encoder distances are recorded
+    bool m_hasDistances = false;
+    double m_lastLeft = 0.0;
+    double m_lastRight = 0.0;
+
+    Vector m_x{};
+    Matrix m_P{};
+
+    frc::FuncNode m_distanceNode{[this] {
+        Update();
+        return m_x[kDistance];
+    }};
+
+    frc::FuncNode m_headingNode{[this] {
+        m_distanceNode.Evaluate();
+        return m_x[kHeading];
+    }};
+
+    frc::FuncNode m_velocityNode{[this] {
+        m_distanceNode.Evaluate();
+        return m_x[kVelocity];
+    }};
+
+    frc::FuncNode m_angularVelocityNode{[this] {
+        m_distanceNode.Evaluate();
+        return m_x[kAngularVelocity];
+    }};
+
+    void Update();
+    void Predict(double dt);
+    void Correct(const Vector& row, double measurement, double stdDev,
+                 bool gate = false);
+};
+
+}  // namespace frc
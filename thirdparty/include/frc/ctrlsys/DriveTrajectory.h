@@ -0,0 +1,90 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <wpi/ArrayRef.h>
+
+#include "frc/ctrlsys/Pose.h"
+
+namespace frc {
+
+/**
+ * A time-parameterized path for a differential drive.
+ *
+ * Generate() joins the waypoints with quintic Hermite splines, then assigns
+ * each point along them the fastest velocity allowed by the constraints. The
+ * robot starts and ends at rest and only drives forward.
+ *
+ * Generating a trajectory takes milliseconds, so do it ahead of time and off
+ * the control thread (see TrajectoryCache). Sampling is cheap and doesn't
+ * allocate.
+ *
+ * Trajectories can also be generated offline and saved with Save(). Load()
+ * memory-maps the file and samples the states in place, so loading doesn't
+ * parse or copy anything. Copies of a trajectory share its states.
+ */
+class DriveTrajectory {
+public:
+    struct Constraints {
+        double maxVelocity;
+        double maxAcceleration;
+
+        // Limits the velocity in turns to sqrt(maxCentripetalAcceleration / r)
+        double maxCentripetalAcceleration;
+
+        // Keeps the outer wheel below maxVelocity in turns
+        double trackWidth;
+    };
+
+    struct State {
+        double time;
+
+        // Distance along the path
+        double distance;
+
+        Pose pose;
+        double curvature;
+        double velocity;
+
+        // Acceleration until the next state
+        double acceleration;
+    };
+
+    DriveTrajectory() = default;
+    explicit DriveTrajectory(std::vector<State> states);
+
+    static DriveTrajectory Generate(const std::vector<Pose>& waypoints,
+                                    const Constraints& constraints);
+
+    static std::optional<DriveTrajectory> Load(const std::string& path,
+                                               uint64_t sourceHash = 0);
+    bool Save(const std::string& path, uint64_t sourceHash = 0) const;
+
+    static uint64_t Hash(const std::vector<Pose>& waypoints,
+                         const Constraints& constraints);
+
+    State Sample(double time) const;
+    double TotalTime() const;
+
+    wpi::ArrayRef<State> GetStates() const;
+
+    void Prefetch() const;
+
+private:
+    // Points into a vector or a mapped file, either of which the pointer keeps
+    // alive
+    std::shared_ptr<const State> m_states;
+    size_t m_size = 0;
+
+    DriveTrajectory(std::shared_ptr<const State> states, size_t size);
+};
+
+}  // namespace frc
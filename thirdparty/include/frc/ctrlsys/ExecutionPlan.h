@@ -0,0 +1,60 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include <wpi/ArrayRef.h>
+
+#include "frc/ctrlsys/INode.h"
+
+namespace frc {
+
+/**
+ * A control system diagram flattened into a topologically sorted list of
+ * steps.
+ *
+ * Compile() walks the graph reachable from a set of root nodes once via
+ * INode::GetInputNodes(). Run() then computes every node in dependency order
+ * with INode::Compute(), reading inputs from a contiguous value buffer instead
+ * of recursing through GetOutput(). Each result is also stored as the node's
+ * output for the current INode::Tick, so Evaluate() on any node in the plan
+ * returns without recomputing it.
+ *
+ * Output and OutputGroup compile a plan in Enable().
+ */
+class ExecutionPlan {
+public:
+    ExecutionPlan() = default;
+
+    void Compile(wpi::ArrayRef<INode*> roots);
+    void Clear();
+
+    void Run();
+
+    double GetOutput(size_t root) const;
+
+    size_t Size() const;
+
+private:
+    struct Step {
+        INode* node;
+
+        // Range of m_inputIndices holding this step's inputs
+        size_t inputBegin;
+        size_t inputEnd;
+    };
+
+    std::vector<Step> m_steps;
+    std::vector<size_t> m_inputIndices;
+    std::vector<double> m_values;
+    std::vector<double> m_inputs;
+    std::vector<size_t> m_roots;
+
+    size_t AddNode(INode* node, std::unordered_map<INode*, size_t>& indices);
+};
+
+}  // namespace frc
@@ -0,0 +1,54 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+
+#include "frc/ctrlsys/INode.h"
+#include "frc/ctrlsys/SeqLock.h"
+
+namespace frc {
+
+/**
+ * Outputs the feedforward for a velocity and acceleration reference, such as
+ * from a motion profile's velocity and acceleration nodes.
+ *
+ *   u = Ks sgn(v) + Kv v + Ka a
+ *
+ * Ks overcomes static friction, Kv back-EMF and viscous friction, and Ka
+ * inertia. Ks is only applied while the reference is moving, so the output is
+ * zero at rest.
+ *
+ * The gains are published to the thread calling GetOutput() through a
+ * SeqLock, so they're always applied together.
+ */
+class FeedforwardNode : public INode {
+public:
+    FeedforwardNode(double Ks, double Kv, double Ka, INode& velocity,
+                    INode& acceleration);
+    virtual ~FeedforwardNode() = default;
+
+    void GetInputNodes(std::vector<INode*>& nodes) override;
+
+    double GetOutput() override;
+    double Compute(const double* inputs) override;
+
+    void SetGains(double Ks, double Kv, double Ka);
+    double GetKs() const;
+    double GetKv() const;
+    double GetKa() const;
+
+private:
+    INode& m_velocity;
+    INode& m_acceleration;
+
+    struct Gains {
+        double Ks;
+        double Kv;
+        double Ka;
+    };
+
+    SeqLock<Gains> m_gains;
+};
+
+}  // namespace frc
@@ -0,0 +1,54 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <array>
+
+#include "frc/ctrlsys/SecondOrderSection.h"
+
+namespace frc {
+
+/*
+ * Filter designs as cascades of second-order sections for LinearFilter.
+ *
+ * The designs are constexpr, so filters with constant parameters have their
+ * coefficients computed at compile time:
+ *
+ *   static constexpr auto kGyroFilter = ButterworthLowPass<4>(20.0, 200.0);
+ *   LinearFilter filter{gyro, kGyroFilter};
+ *
+ * Frequencies are in Hz and must be between zero and half the sample rate.
+ */
+
+/**
+ * Number of second-order sections in a filter of the given order.
+ */
+template <int Order>
+constexpr size_t kNumSections = (Order + 1) / 2;
+
+template <int Order>
+constexpr std::array<SecondOrderSection, kNumSections<Order>>
+ButterworthLowPass(double cutoff, double sampleRate);
+
+template <int Order>
+constexpr std::array<SecondOrderSection, kNumSections<Order>>
+ButterworthHighPass(double cutoff, double sampleRate);
+
+constexpr SecondOrderSection Notch(double frequency, double q,
+                                   double sampleRate);
+
+constexpr SecondOrderSection BandPass(double frequency, double q,
+                                      double sampleRate);
+
+namespace detail {
+
+constexpr double Sin(double x);
+constexpr double Cos(double x);
+
+}  // namespace detail
+
+}  // namespace frc
+
+#include "frc/ctrlsys/FilterDesign.inc"
@@ -2,7 +2,7 @@
 
 #pragma once
 
-#include <wpi/mutex.h>
+#include <atomic>
 
 #include "frc/ctrlsys/INode.h"
 #include "frc/ctrlsys/NodeBase.h"
@@ -15,14 +15,13 @@ public:
     virtual ~GainNode() = default;
 
     double GetOutput() override;
+    double Compute(const double* inputs) override;
 
     void SetGain(double K);
     double GetGain() const;
 
 private:
-    double m_gain;
-
-    mutable wpi::mutex m_mutex;
+    std::atomic<double> m_gain;
 };
 
 }  // namespace frc
@@ -0,0 +1,34 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+
+#include "frc/ctrlsys/Pose.h"
+
+namespace frc {
+
+/**
+ * A quintic Hermite spline between two poses.
+ *
+ * The spline leaves the start pose and arrives at the end pose along their
+ * headings with zero second derivative at both ends, so splines joined at a
+ * pose have continuous heading and curvature.
+ */
+class HermiteSpline {
+public:
+    HermiteSpline(const Pose& start, const Pose& end);
+
+    Pose GetPose(double t) const;
+    double GetCurvature(double t) const;
+
+private:
+    // Polynomial coefficients in order of increasing degree
+    std::array<double, 6> m_x;
+    std::array<double, 6> m_y;
+
+    static std::array<double, 6> Coefficients(double p0, double v0,
+                                              double p1, double v1);
+};
+
+}  // namespace frc
@@ -0,0 +1,58 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+
+namespace frc {
+
+/**
+ * A fixed-size histogram of nonnegative integers with bounded relative error,
+ * in the style of HdrHistogram.
+ *
+ * Values below 2^kSubBucketBits get their own bucket. Each power-of-two range
+ * above that is split into 2^(kSubBucketBits - 1) equal buckets, so a
+ * percentile is reported within about 3% of the recorded value. Values above
+ * kMaxValue are recorded as kMaxValue.
+ *
+ * Record() is wait-free but must only be called from one thread at a time.
+ * Any thread may read percentiles concurrently; a read may miss values
+ * recorded while it runs.
+ */
+class Histogram {
+public:
+    static constexpr int kSubBucketBits = 6;
+    static constexpr uint64_t kMaxValue = UINT32_MAX;
+
+    Histogram() = default;
+
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    void Record(uint64_t value);
+
+    uint64_t GetCount() const;
+    uint64_t GetMax() const;
+    uint64_t GetPercentile(double percentile) const;
+
+    void Reset();
+
+private:
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    static constexpr size_t kHalfSubBuckets = kSubBuckets / 2;
+    static constexpr size_t kBuckets =
+        kSubBuckets + (32 - kSubBucketBits) * kHalfSubBuckets;
+
+    std::array<std::atomic<uint32_t>, kBuckets> m_counts{};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_max{0};
+
+    static size_t BucketIndex(uint64_t value);
+    static uint64_t BucketUpperBound(size_t index);
+};
+
+}  // namespace frc
@@ -2,11 +2,15 @@
 
 #pragma once
 
+#include <stdint.h>
+
+#include <vector>
+
 #include <units/time.h>
 
 namespace frc {
 
-class Output;
+class ExecutionPlan;
 
 /**
  * Interface for control system diagram node.
@@ -24,17 +28,57 @@ public:
 
     virtual INode* GetInputNode();
 
-    virtual void SetCallback(Output& output);
+    virtual void GetInputNodes(std::vector<INode*>& nodes);
 
     /**
      * Performs an operation on the input node's output and returns the result.
      */
     virtual double GetOutput() = 0;
 
+    virtual double Compute(const double* inputs);
+
+    double Evaluate();
+
     /**
      * The default period used in control loops in seconds.
      */
     static constexpr units::second_t kDefaultPeriod = 0.05_s;
+
+    static units::second_t GetTickTimestamp();
+
+    /**
+     * Marks one control cycle on the calling thread.
+     *
+     * While a Tick is alive, Evaluate() computes each node at most once and
+     * returns the cached result to every other consumer. Output and
+     * OutputGroup create one around each iteration. A Tick constructed while
+     * another is alive on the same thread joins the existing cycle.
+     *
+     * The outermost Tick also records when the cycle started, which nodes
+     * measuring their period read with GetTickTimestamp().
+     */
+    class Tick {
+    public:
+        Tick();
+        explicit Tick(units::second_t timestamp);
+        ~Tick();
+
+        Tick(const Tick&) = delete;
+        Tick& operator=(const Tick&) = delete;
+
+        bool IsOutermost() const;
+
+    private:
+        bool m_owner;
+    };
+
+private:
+    friend class ExecutionPlan;
+
+    void SetTickOutput(double output);
+
+    uint64_t m_tick = 0;
+    double m_tickOutput = 0.0;
 };
 
 }  // namespace frc
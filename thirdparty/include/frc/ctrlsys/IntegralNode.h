@@ -2,18 +2,23 @@
 
 #pragma once
 
+#include <atomic>
 #include <limits>
 
 #include <units/time.h>
-#include <wpi/mutex.h>
 
 #include "frc/ctrlsys/INode.h"
 #include "frc/ctrlsys/NodeBase.h"
+#include "frc/ctrlsys/TickPeriod.h"
 
 namespace frc {
 
 /**
  * Represents an integrator in a control system diagram.
+ *
+ * The running total is owned by the thread calling GetOutput(). The gain,
+ * I-zone, and Reset() are published to it through atomics, so they can be
+ * called from any thread without blocking the control loop.
  */
 class IntegralNode : public NodeBase {
 public:
@@ -21,22 +26,25 @@ public:
     virtual ~IntegralNode() = default;
 
     double GetOutput() override;
+    double Compute(const double* inputs) override;
 
     void SetGain(double K);
     double GetGain() const;
 
     void SetIZone(double maxInputMagnitude);
 
+    void UseMeasuredPeriod(bool measured = true);
+
     void Reset(void);
 
 private:
-    double m_gain;
-    units::second_t m_period;
+    std::atomic<double> m_gain;
+    TickPeriod m_period;
 
     double m_total = 0.0;
-    double m_maxInputMagnitude = std::numeric_limits<double>::infinity();
-
-    mutable wpi::mutex m_mutex;
+    std::atomic<double> m_maxInputMagnitude{
+        std::numeric_limits<double>::infinity()};
+    std::atomic<bool> m_resetRequested{false};
 };
 
 }  // namespace frc
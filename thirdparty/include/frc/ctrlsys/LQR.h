@@ -0,0 +1,45 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+
+#include "frc/ctrlsys/Matrix.h"
+
+namespace frc {
+
+/*
+ * Design functions for linear-quadratic regulators and feedforward on
+ * fixed-size state-space models.
+ *
+ * A model with state x and input u is
+ *
+ *   dx/dt = A x + B u
+ *
+ * in continuous time, or x_k+1 = A x_k + B u_k once discretized. The design
+ * functions run once, such as at startup; the gains they return are then
+ * applied each control cycle with a few small matrix products.
+ */
+
+template <int States, int Inputs>
+void DiscretizeAB(const Matrix<States, States>& contA,
+                  const Matrix<States, Inputs>& contB, double dt,
+                  Matrix<States, States>* discA,
+                  Matrix<States, Inputs>* discB);
+
+template <int Rows>
+constexpr Matrix<Rows, Rows> MakeCostMatrix(
+    const std::array<double, Rows>& maxValues);
+
+template <int States, int Inputs>
+Matrix<Inputs, States> LQR(const Matrix<States, States>& discA,
+                           const Matrix<States, Inputs>& discB,
+                           const Matrix<States, States>& Q,
+                           const Matrix<Inputs, Inputs>& R);
+
+template <int States, int Inputs>
+Matrix<Inputs, States> PlantInversion(const Matrix<States, Inputs>& discB);
+
+}  // namespace frc
+
+#include "frc/ctrlsys/LQR.inc"
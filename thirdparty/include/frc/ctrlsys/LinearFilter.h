@@ -2,13 +2,16 @@
 
 #pragma once
 
-#include <wpi/ArrayRef.h>
-#include <wpi/circular_buffer.h>
+#include <stddef.h>
 
+#include <array>
 #include <vector>
 
+#include <wpi/ArrayRef.h>
+
 #include "frc/ctrlsys/INode.h"
 #include "frc/ctrlsys/NodeBase.h"
+#include "frc/ctrlsys/SecondOrderSection.h"
 
 namespace frc {
 
@@ -80,6 +83,16 @@ constexpr MovingAverage kMovingAverage{};
  * definitely need to adjust the gains if you then want to run it at 200Hz!
  * Combining this with Note 1 - the impetus is on YOU as a developer to make
  * sure GetOutput() gets called at the desired, constant frequency!
+ *
+ * Gains are evaluated in transposed direct form II, which keeps the filter's
+ * state in one contiguous array the compiler can vectorize over. Moving
+ * averages keep a running sum instead, so they cost the same for any number of
+ * taps. High-order IIR filters should be given as a cascade of second-order
+ * sections, which is far less sensitive to rounding than one transfer
+ * function.
+ *
+ * Filter() processes a block of samples at once, e.g., to filter several
+ * samples that arrived together or a recorded signal.
  */
 class LinearFilter : public NodeBase {
 public:
@@ -89,16 +102,40 @@ public:
     LinearFilter(MovingAverage, INode& input, int taps);
     LinearFilter(INode& input, wpi::ArrayRef<double> ffGains,
                  wpi::ArrayRef<double> fbGains);
+    LinearFilter(INode& input, wpi::ArrayRef<SecondOrderSection> sections);
 
     double GetOutput() override;
+    double Compute(const double* inputs) override;
+
+    void Filter(wpi::ArrayRef<double> inputs,
+                wpi::MutableArrayRef<double> outputs);
 
     void Reset(void);
 
 private:
-    wpi::circular_buffer<double> m_inputs;
-    wpi::circular_buffer<double> m_outputs;
+    enum class Form { kTransposed, kMovingAverage, kSections };
+
+    Form m_form = Form::kTransposed;
+
+    // Transposed direct form II. The gains are zero-padded so there's one more
+    // feedforward gain than there are states and feedback gains.
     std::vector<double> m_inputGains;
     std::vector<double> m_outputGains;
+    std::vector<double> m_state;
+
+    // Moving average. m_sum is compensated for the rounding error of adding
+    // and removing samples, which is kept in m_sumError.
+    std::vector<double> m_window;
+    size_t m_windowIndex = 0;
+    double m_sum = 0.0;
+    double m_sumError = 0.0;
+
+    // Cascaded second-order sections, each with two states
+    std::vector<SecondOrderSection> m_sections;
+    std::vector<std::array<double, 2>> m_sectionStates;
+
+    double ComputeTransposed(double input);
+    double ComputeMovingAverage(double input);
 };
 
 }  // namespace frc
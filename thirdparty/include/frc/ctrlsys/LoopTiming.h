@@ -0,0 +1,85 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#include <networktables/NetworkTableEntry.h>
+#include <units/time.h>
+#include <wpi/StringRef.h>
+
+#include "frc/ctrlsys/Histogram.h"
+
+namespace frc {
+
+/**
+ * Records how regularly and how quickly a control loop runs.
+ *
+ * Each iteration is wrapped in a Scope, which records the time since the last
+ * iteration started, the iteration's execution time, and whether it missed
+ * its deadline. An iteration's deadline is one nominal period after its
+ * expected release (the previous iteration's start plus the period). All
+ * times are recorded in microseconds into Histograms.
+ *
+ * The p50, p99, and max of each histogram are published to NetworkTables
+ * under "ControlLoops/<name>" every kPublishPeriod from a low priority thread
+ * shared by all instances.
+ *
+ * Scopes must only be opened by one thread at a time.
+ */
+class LoopTiming {
+public:
+    static constexpr units::second_t kPublishPeriod = units::second_t{1.0};
+
+    class Scope {
+    public:
+        explicit Scope(LoopTiming& timing);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        LoopTiming& m_timing;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    LoopTiming(wpi::StringRef name, units::second_t period);
+    ~LoopTiming();
+
+    LoopTiming(const LoopTiming&) = delete;
+    LoopTiming& operator=(const LoopTiming&) = delete;
+
+    void SetPeriod(units::second_t period);
+    void Restart();
+
+    const Histogram& GetPeriodHistogram() const;
+    const Histogram& GetExecutionTimeHistogram() const;
+    const Histogram& GetOverrunHistogram() const;
+    uint64_t GetMissedDeadlines() const;
+
+    void Publish();
+
+private:
+    // Nominal period in microseconds
+    std::atomic<int64_t> m_period;
+
+    bool m_started = false;
+    std::chrono::steady_clock::time_point m_lastStart;
+
+    Histogram m_periods;
+    Histogram m_executionTimes;
+    Histogram m_overruns;
+
+    // p50, p99, and max for each histogram, then the missed deadline count
+    std::array<nt::NetworkTableEntry, 10> m_entries;
+
+    void Record(std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end);
+};
+
+}  // namespace frc
@@ -0,0 +1,80 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <array>
+
+namespace frc {
+
+/**
+ * A fixed-size matrix of doubles for state-space control.
+ *
+ * The dimensions are template parameters, so mismatched operations fail to
+ * compile, and the elements are stored inline, so no operation allocates. This
+ * keeps the time a control cycle spends on matrix math fixed.
+ */
+template <int Rows, int Cols>
+class Matrix {
+    static_assert(Rows > 0 && Cols > 0, "Matrix dimensions must be positive");
+
+public:
+    /**
+     * Constructs a matrix of zeroes.
+     */
+    constexpr Matrix() = default;
+
+    constexpr explicit Matrix(
+        const std::array<std::array<double, Cols>, Rows>& elements);
+
+    static constexpr Matrix Identity();
+    static constexpr Matrix Diagonal(const std::array<double, Rows>& diagonal);
+
+    constexpr double& operator()(int row, int col);
+    constexpr double operator()(int row, int col) const;
+
+    constexpr Matrix& operator+=(const Matrix& rhs);
+    constexpr Matrix& operator-=(const Matrix& rhs);
+    constexpr Matrix& operator*=(double scalar);
+
+    constexpr Matrix<Cols, Rows> Transpose() const;
+
+    template <int BlockRows, int BlockCols>
+    constexpr Matrix<BlockRows, BlockCols> Block(int row, int col) const;
+
+    template <int BlockRows, int BlockCols>
+    constexpr void SetBlock(int row, int col,
+                            const Matrix<BlockRows, BlockCols>& block);
+
+    constexpr double MaxAbs() const;
+
+    constexpr Matrix Inverse() const;
+
+private:
+    std::array<std::array<double, Cols>, Rows> m_elements{};
+};
+
+template <int Rows, int Cols>
+constexpr Matrix<Rows, Cols> operator+(Matrix<Rows, Cols> lhs,
+                                       const Matrix<Rows, Cols>& rhs);
+
+template <int Rows, int Cols>
+constexpr Matrix<Rows, Cols> operator-(Matrix<Rows, Cols> lhs,
+                                       const Matrix<Rows, Cols>& rhs);
+
+template <int Rows, int Cols>
+constexpr Matrix<Rows, Cols> operator*(double scalar,
+                                       Matrix<Rows, Cols> matrix);
+
+template <int Rows, int Inner, int Cols>
+constexpr Matrix<Rows, Cols> operator*(const Matrix<Rows, Inner>& lhs,
+                                       const Matrix<Inner, Cols>& rhs);
+
+/**
+ * A column vector.
+ */
+template <int Rows>
+using Vector = Matrix<Rows, 1>;
+
+}  // namespace frc
+
+#include "frc/ctrlsys/Matrix.inc"
@@ -2,70 +2,167 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
 #include <limits>
-#include <wpi/mutex.h>
 #include <tuple>
 
-#include "frc/Timer.h"
 #include "frc/ctrlsys/FuncNode.h"
 #include "frc/ctrlsys/INode.h"
+#include "frc/ctrlsys/SeqLock.h"
 
 namespace frc {
 
 /**
  * Base class for all types of motion profile controllers.
+ *
+ * Profiles can start and end in motion, so consecutive goals can blend into
+ * each other without stopping. Replan() changes the goal mid-motion starting
+ * from the current reference, so the reference stays continuous.
+ *
+ * The profile's state is owned by the thread evaluating its nodes. SetGoal(),
+ * Replan(), and Reset() publish a request to that thread through a SeqLock,
+ * and the thread plans the new profile on its next evaluation. The getters
+ * read a snapshot the thread publishes after each update, so no call blocks
+ * the control loop.
+ *
+ * A plan is a short table of segments with constant jerk. The reference is
+ * evaluated in closed form within the segment containing the current time, so
+ * it's exact regardless of how much the control loop's period jitters.
  */
 class MotionProfile {
 public:
-    MotionProfile();
+    /**
+     * Position, velocity, and acceleration.
+     */
+    using State = std::tuple<double, double, double>;
+
+    MotionProfile() = default;
     virtual ~MotionProfile() = default;
 
     INode& GetPositionNode();
     INode& GetVelocityNode();
     INode& GetAccelerationNode();
 
-    virtual void SetGoal(double goal, double currentSource) = 0;
+    void SetGoal(double goal, double currentSource = 0.0);
+    void SetGoal(double goal, double goalVelocity, const State& current);
+    void Replan(double goal, double goalVelocity = 0.0);
     double GetGoal() const;
     bool AtGoal() const;
     double ProfileTimeTotal() const;
 
     void Reset(void);
 
-protected:
-    using State = std::tuple<double, double, double>;
+    State Sample(double time);
 
-    virtual State UpdateSetpoint(double currentTime) = 0;
-
-    // Use this to make UpdateSetpoint() and SetGoal() thread-safe
-    mutable wpi::mutex m_mutex;
+protected:
+    static constexpr size_t kMaxSegments = 8;
+
+    /**
+     * Plans a profile from the start state to the goal.
+     *
+     * The arguments are in the direction of travel, so the distance is never
+     * negative. The profile must end with zero acceleration.
+     *
+     * Implementations call AddSegment() for each phase in order. This is
+     * called on the thread evaluating the profile's nodes.
+     *
+     * @param distance          distance to travel
+     * @param startVelocity     velocity at the start
+     * @param startAcceleration acceleration at the start
+     * @param goalVelocity      velocity at the goal
+     */
+    virtual void Plan(double distance, double startVelocity,
+                      double startAcceleration, double goalVelocity) = 0;
+
+    void AddSegment(double duration, double acceleration, double jerk);
+
+private:
+    struct Segment {
+        double startTime;
+
+        // State at the start of the segment
+        double position;
+        double velocity;
+        double acceleration;
+
+        double jerk;
+    };
+
+    struct Request {
+        double goal;
+        double goalVelocity;
+
+        // Start state, unused when replanning from the current reference
+        double start;
+        double startVelocity;
+        double startAcceleration;
+        bool replan;
+
+        // FPGA timestamp at which the profile starts
+        double startTime;
+
+        uint64_t generation;
+    };
+
+    struct Status {
+        double position;
+        double timeTotal;
+        uint64_t generation;
+    };
+
+    SeqLock<Request> m_request{
+        Request{0.0, 0.0, 0.0, 0.0, 0.0, false, 0.0, 0}};
+    std::atomic<uint64_t> m_requestCount{0};
+
+    SeqLock<Status> m_status{
+        Status{0.0, std::numeric_limits<double>::infinity(), 0}};
+
+    // The remaining members are owned by the thread evaluating the profile's
+    // nodes
+
+    // Generation of the request last planned
+    uint64_t m_generation = 0;
+
+    double m_sign = 1.0;
+    double m_start = 0.0;
+    double m_goal = 0.0;
 
-    Timer m_timer;
+    // FPGA timestamp at which the current plan starts
+    double m_startTime = 0.0;
 
-    double m_goal = 0.0;
+    // Plan for the current goal in the direction of travel. The entry after
+    // the last segment holds the final state.
+    std::array<Segment, kMaxSegments + 1> m_segments{};
+    size_t m_numSegments = 0;
 
-    double m_sign;
+    // Segment containing the last sample
+    size_t m_segment = 0;
 
-    // Current reference (displacement, velocity, acceleration)
+    // Current reference (position, velocity, acceleration)
     State m_ref = std::make_tuple(0.0, 0.0, 0.0);
 
     frc::FuncNode m_positionNode{[this] {
-        std::scoped_lock lock(m_mutex);
-        m_ref = UpdateSetpoint(m_timer.Get());
+        Update();
         return std::get<0>(m_ref);
     }};
 
     frc::FuncNode m_velocityNode{[this] {
-        std::scoped_lock lock(m_mutex);
-        return std::get<1>(m_ref) * m_sign;
+        m_positionNode.Evaluate();
+        return std::get<1>(m_ref);
     }};
 
     frc::FuncNode m_accelerationNode{[this] {
-        std::scoped_lock lock(m_mutex);
-        return std::get<2>(m_ref) * m_sign;
+        m_positionNode.Evaluate();
+        return std::get<2>(m_ref);
     }};
 
-    double m_lastTime = 0.0;
-    double m_timeTotal = std::numeric_limits<double>::infinity();
+    void Publish(Request request);
+    void StartPlan(double goal, double goalVelocity, const State& start);
+    void Update();
 };
 
 }  // namespace frc
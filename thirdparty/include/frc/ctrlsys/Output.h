@@ -2,13 +2,14 @@
 
 #pragma once
 
-#include <wpi/mutex.h>
-
 #include <units/time.h>
+#include <wpi/StringRef.h>
 
-#include "frc/Notifier.h"
 #include "frc/PIDOutput.h"
+#include "frc/ctrlsys/ExecutionPlan.h"
 #include "frc/ctrlsys/INode.h"
+#include "frc/ctrlsys/LoopTiming.h"
+#include "frc/ctrlsys/SeqLock.h"
 
 namespace frc {
 
@@ -16,20 +17,24 @@ namespace frc {
  * INode adapter for PIDOutput subclasses.
  *
  * Wraps a PIDOutput object in the INode interface by calling PIDWrite() on it
- * at a regular interval specified in the constructor. This is called in a
- * separate thread.
+ * at a regular interval specified in the constructor. This is called from the
+ * ControlScheduler thread.
  */
 class Output {
 public:
     Output(INode& input, PIDOutput& output,
            units::second_t period = INode::kDefaultPeriod);
-    virtual ~Output() = default;
+    Output(wpi::StringRef name, INode& input, PIDOutput& output,
+           units::second_t period = INode::kDefaultPeriod);
+    virtual ~Output();
 
     void Enable();
     void Disable();
 
     void SetRange(double minU, double maxU);
 
+    const LoopTiming& GetTiming() const;
+
 protected:
     virtual void OutputFunc(void);
 
@@ -41,11 +46,15 @@ private:
     PIDOutput& m_output;
     units::second_t m_period;
 
-    Notifier m_thread;
-    wpi::mutex m_mutex;
+    ExecutionPlan m_plan;
+    LoopTiming m_timing;
+
+    struct Range {
+        double minU;
+        double maxU;
+    };
 
-    double m_minU = -1.0;
-    double m_maxU = 1.0;
+    SeqLock<Range> m_range{Range{-1.0, 1.0}};
 };
 
 }  // namespace frc
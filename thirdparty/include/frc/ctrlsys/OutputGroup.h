@@ -3,49 +3,68 @@
 #pragma once
 
 #include <functional>
+#include <string>
 #include <vector>
 
 #include <units/time.h>
+#include <wpi/StringRef.h>
 
-#include "frc/Notifier.h"
+#include "frc/ctrlsys/ExecutionPlan.h"
+#include "frc/ctrlsys/LoopTiming.h"
 #include "frc/ctrlsys/Output.h"
 
 namespace frc {
 
 /**
- * Allows grouping Output instances together to run in one thread.
+ * Allows grouping Output instances together to run as one task.
  *
- * Each output's OutputFunc() is called at a regular interval. This can be used
- * to avoid unnecessary context switches for Output instances that are running
- * at the same sample rate and priority.
+ * Each output's OutputFunc() is called at a regular interval from the
+ * ControlScheduler thread. Grouped outputs share one control cycle, so nodes
+ * they have in common are only evaluated once.
  */
 class OutputGroup {
 public:
     /**
-     * Appends output to array.
+     * Groups outputs whose loop timing is published under a generated name
+     * ("OutputGroup <N>").
      *
      * @param output the Output object to add to the array for round robin
      * @param outputs the other Output objects
      */
     template <class... Outputs>
-    explicit OutputGroup(Output& output, Outputs&&... outputs)
-      : OutputGroup(outputs...) {
-      m_outputs.emplace_back(output);
-    }
+    explicit OutputGroup(Output& output, Outputs&... outputs)
+        : OutputGroup(NextName(), {output, outputs...}) {}
 
-    explicit OutputGroup(Output& output);
+    /**
+     * Groups outputs.
+     *
+     * @param name the name the group's loop timing is published under
+     * @param output the Output object to add to the array for round robin
+     * @param outputs the other Output objects
+     */
+    template <class... Outputs>
+    OutputGroup(wpi::StringRef name, Output& output, Outputs&... outputs)
+        : OutputGroup(name, {output, outputs...}) {}
 
-    virtual ~OutputGroup() = default;
+    virtual ~OutputGroup();
 
     void Enable(units::second_t period = INode::kDefaultPeriod);
     void Disable();
 
+    const LoopTiming& GetTiming() const;
+
 protected:
     virtual void OutputFunc();
 
 private:
+    OutputGroup(wpi::StringRef name,
+                std::vector<std::reference_wrapper<Output>> outputs);
+
+    static std::string NextName();
+
     std::vector<std::reference_wrapper<Output>> m_outputs;
-    Notifier m_thread;
+    ExecutionPlan m_plan;
+    LoopTiming m_timing;
 };
 
 }  // namespace frc
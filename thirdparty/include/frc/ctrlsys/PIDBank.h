@@ -0,0 +1,71 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include <units/time.h>
+#include <wpi/ArrayRef.h>
+
+#include "frc/ctrlsys/INode.h"
+
+namespace frc {
+
+/**
+ * Runs many independent PID controllers with the same period in one pass.
+ *
+ * Gains, integrator totals, previous inputs, and output ranges for every
+ * controller are stored in separate contiguous arrays (structure-of-arrays),
+ * and Update() processes all of them in a branch-free loop the compiler can
+ * vectorize. Each controller behaves like a PIDNode: the integrator is clamped
+ * to +-1/Ki and cleared when the input leaves the I-zone, and the output is
+ * clamped to the output range.
+ *
+ * This class isn't thread-safe. Call the setters from the thread calling
+ * Update() or while it isn't running.
+ */
+class PIDBank {
+public:
+    explicit PIDBank(size_t size,
+                     units::second_t period = INode::kDefaultPeriod);
+
+    size_t Size() const;
+
+    void SetPID(size_t index, double p, double i, double d);
+    double GetP(size_t index) const;
+    double GetI(size_t index) const;
+    double GetD(size_t index) const;
+
+    void SetOutputRange(size_t index, double minU, double maxU);
+    void SetIZone(size_t index, double maxInputMagnitude);
+
+    void Reset(size_t index);
+    void Reset();
+
+    void Update(wpi::ArrayRef<double> inputs,
+                wpi::MutableArrayRef<double> outputs);
+
+private:
+    double m_period;
+
+    std::vector<double> m_Kp;
+    std::vector<double> m_Ki;
+    std::vector<double> m_Kd;
+
+    // Integrator total is clamped to +-1/Ki
+    std::vector<double> m_maxTotal;
+    std::vector<double> m_maxInputMagnitude;
+    std::vector<double> m_minU;
+    std::vector<double> m_maxU;
+
+    std::vector<double> m_total;
+    std::vector<double> m_prevInput;
+
+    // Nonzero if the controller's state is cleared on the next Update()
+    std::vector<uint8_t> m_reset;
+};
+
+}  // namespace frc
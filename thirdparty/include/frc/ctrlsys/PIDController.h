@@ -19,7 +19,7 @@ namespace frc3512 {
 /**
  * Class implements a PID Control Loop.
  *
- * Creates a separate thread which reads the given PIDSource and takes
+ * Registers with the ControlScheduler to read the given PIDSource and take
  * care of the integral calculations, as well as writing the given PIDOutput.
  *
  * This feedback controller runs in discrete time, so time deltas are not used
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <units/time.h>
 
 #include "DerivativeNode.h"
@@ -9,6 +11,7 @@
 #include "INode.h"
 #include "IntegralNode.h"
 #include "NodeBase.h"
+#include "SeqLock.h"
 #include "SumNode.h"
 
 namespace frc {
@@ -28,7 +31,10 @@ public:
             units::second_t period = kDefaultPeriod);
     virtual ~PIDNode() = default;
 
+    void GetInputNodes(std::vector<INode*>& nodes) override;
+
     double GetOutput() override;
+    double Compute(const double* inputs) override;
 
     void SetPID(double p, double i, double d);
 
@@ -44,6 +50,12 @@ public:
     void SetOutputRange(double minU, double maxU);
     void SetIZone(double maxInputMagnitude);
 
+    void UseMeasuredPeriod(bool measured = true);
+
+    GainNode& GetProportionalNode();
+    IntegralNode& GetIntegralNode();
+    DerivativeNode& GetDerivativeNode();
+
     void Reset(void);
 
 private:
@@ -52,8 +64,12 @@ private:
     DerivativeNode m_D;
     SumNode m_sum;
 
-    double m_minU = -1.0;
-    double m_maxU = 1.0;
+    struct Range {
+        double minU;
+        double maxU;
+    };
+
+    SeqLock<Range> m_range{Range{-1.0, 1.0}};
 };
 
 }  // namespace frc
@@ -0,0 +1,18 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+namespace frc {
+
+/**
+ * A position and heading on the field.
+ */
+struct Pose {
+    double x;
+    double y;
+
+    // Counterclockwise from the x axis in radians
+    double heading;
+};
+
+}  // namespace frc
@@ -0,0 +1,61 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+#include "frc/ctrlsys/Pose.h"
+#include "frc/ctrlsys/SeqLock.h"
+
+namespace frc {
+
+/**
+ * A fixed-capacity history of timestamped poses, for finding where the robot
+ * was when a delayed measurement, such as a camera frame, was taken.
+ *
+ * Once full, each new pose replaces the oldest. Sample() finds the poses
+ * around a timestamp with a binary search and interpolates between them.
+ *
+ * Add() and Clear() must be called from one thread, typically the control
+ * loop. Sample() can be called from any thread without blocking it; it retries
+ * in the rare case that the poses it read were replaced while it searched.
+ */
+class PoseHistory {
+public:
+    explicit PoseHistory(size_t capacity);
+
+    PoseHistory(const PoseHistory&) = delete;
+    PoseHistory& operator=(const PoseHistory&) = delete;
+
+    void Add(double timestamp, const Pose& pose);
+    void Clear();
+
+    std::optional<Pose> Sample(double timestamp) const;
+
+private:
+    struct Entry {
+        double timestamp;
+        Pose pose;
+    };
+
+    // Twice as many slots as the capacity. Readers only search the newest
+    // capacity entries, so Add() can be called that many times during a search
+    // before it replaces an entry the search read.
+    size_t m_capacity;
+    size_t m_slots;
+    std::unique_ptr<SeqLock<Entry>[]> m_entries;
+
+    // Entries [m_begin, m_end) are valid, stored at index % m_slots
+    std::atomic<uint64_t> m_begin{0};
+    std::atomic<uint64_t> m_end{0};
+
+    // Owned by the thread calling Add()
+    double m_lastTimestamp = 0.0;
+};
+
+}  // namespace frc
@@ -0,0 +1,37 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <tuple>
+
+#include "frc/ctrlsys/DriveTrajectory.h"
+#include "frc/ctrlsys/Pose.h"
+
+namespace frc {
+
+/**
+ * A nonlinear feedback controller that makes a differential drive follow a
+ * trajectory.
+ *
+ * It returns the velocity and angular velocity that drive the robot's pose
+ * toward the trajectory's. The correction converges for any initial error as
+ * long as the robot is moving.
+ *
+ * See "Control of Wheeled Mobile Robots: An Experimental Overview" by Samson
+ * et al.
+ */
+class RamseteFollower {
+public:
+    RamseteFollower(double b, double zeta);
+
+    void SetGains(double b, double zeta);
+
+    std::tuple<double, double> Calculate(
+        const Pose& pose, const DriveTrajectory::State& desired) const;
+
+private:
+    double m_b;
+    double m_zeta;
+};
+
+}  // namespace frc
@@ -2,16 +2,13 @@
 
 #pragma once
 
-#include <functional>
+#include <atomic>
 #include <memory>
-#include <wpi/mutex.h>
 
 #include "INode.h"
 
 namespace frc {
 
-class Output;
-
 /**
  * A node for reference inputs (e.g., setpoints).
  */
@@ -20,18 +17,13 @@ public:
     explicit RefInput(double reference = 0.0);
     virtual ~RefInput() = default;
 
-    void SetCallback(Output& output) override;
-
     double GetOutput() override;
     double GetOutput() const;
 
     void Set(double reference);
 
 private:
-    double m_reference;
-    std::function<void()> m_callback = [] {};
-
-    mutable wpi::mutex m_mutex;
+    std::atomic<double> m_reference;
 };
 
 }  // namespace frc
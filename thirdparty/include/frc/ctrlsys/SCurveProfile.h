@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "frc/ctrlsys/MotionProfile.h"
 
 namespace frc {
@@ -18,29 +20,27 @@ class SCurveProfile : public MotionProfile {
 public:
     SCurveProfile(double maxV, double maxA, double timeToMaxA);
 
-    void SetGoal(double goal, double currentSource = 0.0) override;
-
     void SetMaxVelocity(double v);
     double GetMaxVelocity() const;
     void SetMaxAcceleration(double a);
     void SetTimeToMaxA(double timeToMaxA);
 
 protected:
-    State UpdateSetpoint(double currentTime) override;
+    void Plan(double distance, double startVelocity, double startAcceleration,
+              double goalVelocity) override;
 
 private:
-    double m_acceleration;
-    double m_maxVelocity;
-    double m_profileMaxVelocity;
-    double m_timeToMaxA;
+    // Limits set by the user
+    std::atomic<double> m_maxVelocity{0.0};
+    std::atomic<double> m_maxAcceleration{0.0};
+    std::atomic<double> m_maxTimeToMaxA{0.0};
 
+    // Limits for the current plan
+    double m_acceleration;
     double m_jerk;
-    double m_t2;
-    double m_t3;
-    double m_t4;
-    double m_t5;
-    double m_t6;
-    double m_t7;
+
+    double TimeToChange(double deltaVelocity) const;
+    void AddVelocityChange(double deltaVelocity);
 };
 
 }  // namespace frc
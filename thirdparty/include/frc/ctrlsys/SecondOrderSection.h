@@ -0,0 +1,25 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+namespace frc {
+
+/**
+ * A biquad: one second-order section of a cascaded IIR filter.
+ *
+ * The section computes:<br>
+ *  y[n] = b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] - a1 * y[n-1] - a2 * y[n-2]
+ *
+ * High-order IIR filters are much less sensitive to rounding when they're
+ * factored into a cascade of these than when their transfer function is
+ * evaluated directly.
+ */
+struct SecondOrderSection {
+    double b0;
+    double b1;
+    double b2;
+    double a1;
+    double a2;
+};
+
+}  // namespace frc
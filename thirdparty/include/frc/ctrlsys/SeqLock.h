@@ -0,0 +1,93 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace frc {
+
+/**
+ * A sequence lock for publishing small blocks of plain data between threads
+ * without a mutex.
+ *
+ * Load() always returns a value that was passed to a single Store() call, never
+ * a mix of two. Readers retry instead of blocking if a store is in progress,
+ * and writers only wait on other writers. This lets a control loop read tuning
+ * parameters, and other threads read the control loop's results, without
+ * either side taking a lock.
+ *
+ * T must be trivially copyable.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock() : SeqLock(T{}) {}
+
+    explicit SeqLock(const T& value) { Store(value); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * Publishes a new value.
+     *
+     * @param value the value to publish
+     */
+    void Store(const T& value) {
+        // Acquire the sequence by making it odd
+        uint64_t seq = m_seq.load(std::memory_order_relaxed);
+        do {
+            while (seq & 1) {
+                seq = m_seq.load(std::memory_order_relaxed);
+            }
+        } while (!m_seq.compare_exchange_weak(seq, seq + 1,
+                                              std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+
+        std::array<uint64_t, kWords> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * Returns the most recently published value.
+     */
+    T Load() const {
+        std::array<uint64_t, kWords> words;
+        uint64_t before;
+        uint64_t after;
+        do {
+            before = m_seq.load(std::memory_order_acquire);
+            for (size_t i = 0; i < kWords; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_seq.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        T value;
+        std::memcpy(&value, words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + 7) / 8;
+
+    std::atomic<uint64_t> m_seq{0};
+    std::array<std::atomic<uint64_t>, kWords> m_words{};
+};
+
+}  // namespace frc
@@ -0,0 +1,427 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <units/time.h>
+
+#include "frc/ctrlsys/INode.h"
+#include "frc/ctrlsys/SeqLock.h"
+#include "frc/ctrlsys/TickPeriod.h"
+
+/**
+ * Control system diagram nodes whose graph is fixed at compile time.
+ *
+ * These mirror GainNode, IntegralNode, DerivativeNode, SumNode, PIDNode,
+ * FuncNode, and RefInput, but each node holds its inputs by concrete type
+ * instead of through INode&. Every GetOutput() call is statically dispatched,
+ * so the compiler can inline a whole controller into the function that
+ * evaluates its outputs. Use NodeAdapter to plug a static graph into an Output
+ * or another INode.
+ *
+ * Nodes don't memoize their outputs. A node with several consumers (e.g., a PID
+ * controller feeding both sides of a drivetrain) should be evaluated once by
+ * the caller and its value reused.
+ */
+namespace frc::ctrlsys {
+
+/**
+ * Converts a callable into a node whose output is the callable's return value.
+ */
+template <typename F>
+class Func {
+public:
+    explicit Func(F func) : m_func(std::move(func)) {}
+
+    double GetOutput() { return m_func(); }
+
+private:
+    F m_func;
+};
+
+template <typename F>
+Func(F) -> Func<F>;
+
+/**
+ * A node for reference inputs (e.g., setpoints).
+ */
+class Ref {
+public:
+    explicit Ref(double reference = 0.0) : m_reference(reference) {}
+
+    double GetOutput() const {
+        return m_reference.load(std::memory_order_relaxed);
+    }
+
+    void Set(double reference) {
+        m_reference.store(reference, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<double> m_reference;
+};
+
+/**
+ * Returns the input node's output multiplied by a constant gain.
+ */
+template <typename Input>
+class Gain {
+public:
+    Gain(double K, Input& input) : m_gain(K), m_input(input) {}
+
+    double GetOutput() { return Compute(m_input.GetOutput()); }
+
+    double Compute(double input) const {
+        return m_gain.load(std::memory_order_relaxed) * input;
+    }
+
+    void SetGain(double K) { m_gain.store(K, std::memory_order_relaxed); }
+    double GetGain() const { return m_gain.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_gain;
+    Input& m_input;
+};
+
+/**
+ * Integrator with the same semantics as IntegralNode.
+ */
+template <typename Input>
+class Integral {
+public:
+    Integral(double K, Input& input,
+             units::second_t period = INode::kDefaultPeriod)
+        : m_gain(K), m_period(period), m_input(input) {}
+
+    double GetOutput() { return Compute(m_input.GetOutput()); }
+
+    double Compute(double input) {
+        double gain = m_gain.load(std::memory_order_relaxed);
+        double period = m_period.Update();
+
+        if (m_resetRequested.exchange(false, std::memory_order_relaxed) ||
+            std::abs(input) >
+                m_maxInputMagnitude.load(std::memory_order_relaxed)) {
+            m_total = 0.0;
+        } else {
+            // The total is limited so the output stays within [-1, 1], which
+            // needs the gain's magnitude since the gain may be negative
+            double limit = 1.0 / std::abs(gain);
+            m_total = std::clamp(m_total + input * period, -limit, limit);
+        }
+
+        return gain * m_total;
+    }
+
+    void SetGain(double K) { m_gain.store(K, std::memory_order_relaxed); }
+    double GetGain() const { return m_gain.load(std::memory_order_relaxed); }
+
+    void SetIZone(double maxInputMagnitude) {
+        m_maxInputMagnitude.store(maxInputMagnitude,
+                                  std::memory_order_relaxed);
+    }
+
+    void UseMeasuredPeriod(bool measured = true) {
+        m_period.SetMeasured(measured);
+    }
+
+    void Reset() { m_resetRequested.store(true, std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_gain;
+    TickPeriod m_period;
+    Input& m_input;
+
+    double m_total = 0.0;
+    std::atomic<double> m_maxInputMagnitude{
+        std::numeric_limits<double>::infinity()};
+    std::atomic<bool> m_resetRequested{false};
+};
+
+/**
+ * Differentiator with the same semantics as DerivativeNode.
+ */
+template <typename Input>
+class Derivative {
+public:
+    Derivative(double K, Input& input,
+               units::second_t period = INode::kDefaultPeriod)
+        : m_gain(K), m_period(period), m_input(input) {}
+
+    double GetOutput() { return Compute(m_input.GetOutput()); }
+
+    double Compute(double input) {
+        double period = m_period.Update();
+
+        if (m_resetRequested.exchange(false, std::memory_order_relaxed)) {
+            m_prevInput = 0.0;
+        }
+
+        double output = m_gain.load(std::memory_order_relaxed) *
+                        (input - m_prevInput) / period;
+        m_prevInput = input;
+
+        return output;
+    }
+
+    void SetGain(double K) { m_gain.store(K, std::memory_order_relaxed); }
+    double GetGain() const { return m_gain.load(std::memory_order_relaxed); }
+
+    void UseMeasuredPeriod(bool measured = true) {
+        m_period.SetMeasured(measured);
+    }
+
+    void Reset() { m_resetRequested.store(true, std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> m_gain;
+    TickPeriod m_period;
+    Input& m_input;
+
+    double m_prevInput = 0.0;
+    std::atomic<bool> m_resetRequested{false};
+};
+
+/**
+ * Sum term that adds its node's output.
+ */
+template <typename Node>
+struct Add {
+    Node& node;
+
+    double Get() { return node.GetOutput(); }
+};
+
+template <typename Node>
+Add(Node&) -> Add<Node>;
+
+/**
+ * Sum term that subtracts its node's output.
+ */
+template <typename Node>
+struct Subtract {
+    Node& node;
+
+    double Get() { return -node.GetOutput(); }
+};
+
+template <typename Node>
+Subtract(Node&) -> Subtract<Node>;
+
+/**
+ * Outputs the sum of its terms with the same semantics as SumNode.
+ *
+ * Terms are Add or Subtract wrappers around the input nodes, e.g.,
+ * Sum error{Add{reference}, Subtract{sensor}}.
+ */
+template <typename... Terms>
+class Sum {
+public:
+    explicit Sum(Terms... terms) : m_terms(terms...) {}
+
+    double GetOutput() {
+        double sum = std::apply(
+            [](auto&... terms) { return (0.0 + ... + terms.Get()); }, m_terms);
+
+        m_result.Store(Result{sum, m_currentResult});
+        m_currentResult = sum;
+
+        double inputRange = m_inputRange.load(std::memory_order_relaxed);
+        if (m_continuous.load(std::memory_order_relaxed) && inputRange != 0) {
+            sum = std::fmod(sum, inputRange);
+            if (std::abs(sum) > inputRange / 2.0) {
+                if (sum > 0.0) {
+                    return sum - inputRange;
+                } else {
+                    return sum + inputRange;
+                }
+            }
+        }
+
+        return sum;
+    }
+
+    void SetContinuous(bool continuous = true) {
+        m_continuous.store(continuous, std::memory_order_relaxed);
+    }
+
+    void SetInputRange(double minimumInput, double maximumInput) {
+        m_inputRange.store(maximumInput - minimumInput,
+                           std::memory_order_relaxed);
+    }
+
+    void SetTolerance(double tolerance, double deltaTolerance) {
+        m_tolerance.Store(Tolerance{tolerance, deltaTolerance});
+    }
+
+    bool InTolerance() const {
+        auto result = m_result.Load();
+        auto tolerance = m_tolerance.Load();
+
+        return std::abs(result.current) < tolerance.tolerance &&
+               std::abs(result.current - result.last) <
+                   tolerance.deltaTolerance;
+    }
+
+private:
+    struct Result {
+        double current;
+        double last;
+    };
+
+    struct Tolerance {
+        double tolerance;
+        double deltaTolerance;
+    };
+
+    std::tuple<Terms...> m_terms;
+
+    double m_currentResult = 0.0;
+    SeqLock<Result> m_result{Result{0.0, 0.0}};
+
+    std::atomic<bool> m_continuous{false};
+    std::atomic<double> m_inputRange{0.0};
+
+    SeqLock<Tolerance> m_tolerance{
+        Tolerance{std::numeric_limits<double>::infinity(),
+                  std::numeric_limits<double>::infinity()}};
+};
+
+template <typename... Terms>
+Sum(Terms...) -> Sum<Terms...>;
+
+/**
+ * The feedforward of a PID constructed without one.
+ */
+struct NoFeedforward {
+    double GetOutput() const { return 0.0; }
+};
+
+/**
+ * A PID controller with the same semantics and interface as PIDNode.
+ *
+ * The input is evaluated once per GetOutput() call and shared by the P, I, and
+ * D terms. The optional feedforward node's output is added to their sum before
+ * the output range is applied.
+ */
+template <typename Input, typename Feedforward = NoFeedforward>
+class PID {
+public:
+    PID(double Kp, double Ki, double Kd, Input& input,
+        units::second_t period = INode::kDefaultPeriod)
+        : m_input(input),
+          m_P(Kp, input),
+          m_I(Ki, input, period),
+          m_D(Kd, input, period) {}
+
+    PID(double Kp, double Ki, double Kd, Feedforward& feedforward,
+        Input& input, units::second_t period = INode::kDefaultPeriod)
+        : m_input(input),
+          m_feedforward(&feedforward),
+          m_P(Kp, input),
+          m_I(Ki, input, period),
+          m_D(Kd, input, period) {}
+
+    double GetOutput() {
+        double input = m_input.GetOutput();
+        double sum = m_P.Compute(input) + m_I.Compute(input) +
+                     m_D.Compute(input);
+        if constexpr (!std::is_same_v<Feedforward, NoFeedforward>) {
+            sum += m_feedforward->GetOutput();
+        }
+
+        auto range = m_range.Load();
+        return std::clamp(sum, range.minU, range.maxU);
+    }
+
+    void SetPID(double p, double i, double d) {
+        m_P.SetGain(p);
+        m_I.SetGain(i);
+        m_D.SetGain(d);
+    }
+
+    void SetP(double p) { m_P.SetGain(p); }
+    double GetP() const { return m_P.GetGain(); }
+
+    void SetI(double i) { m_I.SetGain(i); }
+    double GetI() const { return m_I.GetGain(); }
+
+    void SetD(double d) { m_D.SetGain(d); }
+    double GetD() const { return m_D.GetGain(); }
+
+    /**
+     * Sets the minimum and maximum values to write. The bounds may be given in
+     * either order.
+     */
+    void SetOutputRange(double minU, double maxU) {
+        m_range.Store(Range{std::min(minU, maxU), std::max(minU, maxU)});
+    }
+
+    void SetIZone(double maxInputMagnitude) {
+        m_I.SetIZone(maxInputMagnitude);
+    }
+
+    void UseMeasuredPeriod(bool measured = true) {
+        m_I.UseMeasuredPeriod(measured);
+        m_D.UseMeasuredPeriod(measured);
+    }
+
+    void Reset() {
+        m_I.Reset();
+        m_D.Reset();
+    }
+
+private:
+    struct Range {
+        double minU;
+        double maxU;
+    };
+
+    Input& m_input;
+    Feedforward* m_feedforward = nullptr;
+    Gain<Input> m_P;
+    Integral<Input> m_I;
+    Derivative<Input> m_D;
+
+    SeqLock<Range> m_range{Range{-1.0, 1.0}};
+};
+
+template <typename Input>
+PID(double, double, double, Input&) -> PID<Input>;
+
+template <typename Input>
+PID(double, double, double, Input&, units::second_t) -> PID<Input>;
+
+template <typename Feedforward, typename Input>
+PID(double, double, double, Feedforward&, Input&) -> PID<Input, Feedforward>;
+
+template <typename Feedforward, typename Input>
+PID(double, double, double, Feedforward&, Input&, units::second_t)
+    -> PID<Input, Feedforward>;
+
+/**
+ * Wraps a static node in the INode interface so it can drive an Output or feed
+ * other INode graphs.
+ */
+template <typename Node>
+class NodeAdapter : public INode {
+public:
+    explicit NodeAdapter(Node& node) : m_node(node) {}
+
+    double GetOutput() override { return m_node.GetOutput(); }
+
+private:
+    Node& m_node;
+};
+
+template <typename Node>
+NodeAdapter(Node&) -> NodeAdapter<Node>;
+
+}  // namespace frc::ctrlsys
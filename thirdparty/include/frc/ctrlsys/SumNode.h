@@ -2,19 +2,24 @@
 
 #pragma once
 
+#include <atomic>
 #include <limits>
 #include <memory>
-#include <wpi/mutex.h>
 #include <utility>
 #include <vector>
 
 #include "frc/ctrlsys/INode.h"
+#include "frc/ctrlsys/SeqLock.h"
 
 namespace frc {
 
 /**
  * Takes an arbitrary list of input nodes and outputs the sum of their
  * outputs.
+ *
+ * The thread calling GetOutput() publishes each result for InTolerance()
+ * through a SeqLock, and the setters publish to it through atomics, so neither
+ * side blocks the other.
  */
 class SumNode : public INode {
 public:
@@ -23,7 +28,10 @@ public:
 
     SumNode(INode& input, bool positive);
 
+    void GetInputNodes(std::vector<INode*>& nodes) override;
+
     double GetOutput() override;
+    double Compute(const double* inputs) override;
 
     void SetContinuous(bool continuous = true);
     void SetInputRange(double minimumInput, double maximumInput);
@@ -38,16 +46,29 @@ private:
      */
     std::vector<std::pair<INode&, bool>> m_inputs;
 
+    struct Result {
+        double current;
+        double last;
+    };
+
+    struct Tolerance {
+        double tolerance;
+        double deltaTolerance;
+    };
+
+    // Owned by the thread calling GetOutput()
     double m_currentResult = 0.0;
-    double m_lastResult = 0.0;
 
-    bool m_continuous = false;
-    double m_inputRange = 0.0;
+    SeqLock<Result> m_result{Result{0.0, 0.0}};
+
+    std::atomic<bool> m_continuous{false};
+    std::atomic<double> m_inputRange{0.0};
 
-    double m_tolerance = std::numeric_limits<double>::infinity();
-    double m_deltaTolerance = std::numeric_limits<double>::infinity();
+    SeqLock<Tolerance> m_tolerance{
+        Tolerance{std::numeric_limits<double>::infinity(),
+                  std::numeric_limits<double>::infinity()}};
 
-    mutable wpi::mutex m_mutex;
+    double Update(double sum);
 };
 
 }  // namespace frc
@@ -0,0 +1,105 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <wpi/ArrayRef.h>
+
+namespace frc {
+
+/**
+ * Records fixed-size binary samples from a control loop to a file without
+ * blocking it.
+ *
+ * The control thread calls Log() once per cycle, which copies the record into
+ * a lock-free single-producer, single-consumer ring buffer and returns. A
+ * normal-priority thread, which the real-time ControlScheduler thread always
+ * preempts, drains the ring every kDrainPeriod and appends the records to the
+ * file. Its writes are limited to a maximum rate so flash writes stay small
+ * and regular. If the ring fills because the file can't keep up, new records
+ * are dropped and counted instead of waiting.
+ *
+ * The file is little-endian:
+ *
+ *   Header:  "TLOG", uint32 version, uint32 field count, uint32 record size
+ *   Fields:  each field name, NUL-terminated
+ *   Records: float64 timestamp in seconds, then one float32 per field
+ *
+ * Only one thread may call Log().
+ */
+class TelemetryLog {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    /// Records the ring holds by default
+    static constexpr size_t kDefaultCapacity = 4096;
+
+    /// Default write bandwidth limit in bytes per second
+    static constexpr double kDefaultMaxBandwidth = 64.0 * 1024.0;
+
+    /// Time between drains of the ring in seconds
+    static constexpr double kDrainPeriod = 0.1;
+
+    /// Log files NextPath() rotates through by default
+    static constexpr int kDefaultMaxFiles = 10;
+
+    TelemetryLog(std::string path, std::vector<std::string> fields,
+                 size_t capacity = kDefaultCapacity,
+                 double maxBandwidth = kDefaultMaxBandwidth);
+    ~TelemetryLog();
+
+    TelemetryLog(const TelemetryLog&) = delete;
+    TelemetryLog& operator=(const TelemetryLog&) = delete;
+
+    bool Log(double timestamp, wpi::ArrayRef<double> values);
+
+    size_t GetFieldCount() const;
+    size_t GetRecordSize() const;
+    uint64_t GetDroppedCount() const;
+    uint64_t GetWrittenCount() const;
+
+    static std::string NextPath(const std::string& prefix,
+                                int maxFiles = kDefaultMaxFiles);
+
+private:
+    std::string m_path;
+    std::vector<std::string> m_fields;
+    size_t m_recordSize;
+    size_t m_capacity;
+    double m_maxBandwidth;
+
+    // Ring of m_capacity records. m_head is only written by the producer and
+    // m_tail only by the drain thread; each counts records ever pushed or
+    // popped, so head - tail is the number of records in the ring.
+    std::vector<uint8_t> m_ring;
+    alignas(64) std::atomic<uint64_t> m_head{0};
+    alignas(64) std::atomic<uint64_t> m_tail{0};
+
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_written{0};
+    std::atomic<bool> m_failed{false};
+
+    // Owned by the drain thread
+    std::ofstream m_file;
+    std::vector<uint8_t> m_writeBuffer;
+    double m_budget = 0.0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_stopCond;
+    bool m_stop = false;
+    std::thread m_thread;
+
+    void Run();
+    size_t Drain(size_t maxRecords);
+};
+
+}  // namespace frc
@@ -0,0 +1,41 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+
+#include <units/time.h>
+
+namespace frc {
+
+/**
+ * Supplies the time step used by nodes that integrate or differentiate.
+ *
+ * By default, this is the nominal period passed to the node's constructor. In
+ * measured mode, it's the time between the starts of the last two control
+ * cycles from INode::GetTickTimestamp(), so a node's gains stay valid when
+ * the loop rate changes or cycles jitter. The nominal period is still used
+ * outside a cycle, on the first cycle, and after a gap longer than
+ * kMaxGapPeriods nominal periods (e.g., after the loop was disabled).
+ *
+ * Update() must only be called once per cycle by the thread running the
+ * control loop. SetMeasured() may be called from any thread.
+ */
+class TickPeriod {
+public:
+    static constexpr double kMaxGapPeriods = 10.0;
+
+    explicit TickPeriod(units::second_t nominal);
+
+    void SetMeasured(bool measured);
+    bool IsMeasured() const;
+
+    double Update();
+
+private:
+    double m_nominal;
+    std::atomic<bool> m_measured{false};
+    double m_lastTimestamp = 0.0;
+};
+
+}  // namespace frc
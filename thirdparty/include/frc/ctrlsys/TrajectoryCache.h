@@ -0,0 +1,50 @@
+// Copyright (c) 2021 FRC Team 3512. All Rights Reserved.
+
+#pragma once
+
+#include <future>
+#include <string>
+#include <vector>
+
+#include <wpi/StringMap.h>
+#include <wpi/StringRef.h>
+#include <wpi/mutex.h>
+
+#include "frc/ctrlsys/DriveTrajectory.h"
+#include "frc/ctrlsys/Pose.h"
+
+namespace frc {
+
+/**
+ * Generates or loads trajectories on background threads and keeps them by
+ * name.
+ *
+ * Request trajectories at startup with Generate() or Load(), then retrieve
+ * them when they're needed with Get(). Get() only waits if generation hasn't
+ * finished yet.
+ */
+class TrajectoryCache {
+public:
+    TrajectoryCache() = default;
+
+    TrajectoryCache(const TrajectoryCache&) = delete;
+    TrajectoryCache& operator=(const TrajectoryCache&) = delete;
+
+    void Generate(wpi::StringRef name, std::vector<Pose> waypoints,
+                  const DriveTrajectory::Constraints& constraints);
+    void Load(wpi::StringRef name, std::string path,
+              std::vector<Pose> waypoints,
+              const DriveTrajectory::Constraints& constraints);
+
+    const DriveTrajectory* Get(wpi::StringRef name);
+    bool IsReady(wpi::StringRef name);
+    void Prefetch(wpi::StringRef name);
+
+private:
+    wpi::mutex m_mutex;
+    wpi::StringMap<std::shared_future<DriveTrajectory>> m_trajectories;
+
+    std::shared_future<DriveTrajectory> Find(wpi::StringRef name);
+};
+
+}  // namespace frc
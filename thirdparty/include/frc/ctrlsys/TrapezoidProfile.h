@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "frc/ctrlsys/MotionProfile.h"
 
 namespace frc {
@@ -19,21 +21,18 @@ public:
     TrapezoidProfile(double maxV, double timeToMaxV);
     virtual ~TrapezoidProfile() = default;
 
-    void SetGoal(double goal, double currentSource = 0.0) override;
-
     void SetMaxVelocity(double velocity);
     double GetMaxVelocity() const;
     void SetTimeToMaxV(double timeToMaxV);
 
 protected:
-    State UpdateSetpoint(double currentTime) override;
+    void Plan(double distance, double startVelocity, double startAcceleration,
+              double goalVelocity) override;
 
 private:
-    double m_acceleration;
-    double m_velocity;
-    double m_profileMaxVelocity;
-    double m_timeFromMaxVelocity;
-    double m_timeToMaxVelocity;
+    // Limits set by the user
+    std::atomic<double> m_maxVelocity{0.0};
+    std::atomic<double> m_maxAcceleration{0.0};
 };
 
 }  // namespace frc